@@ -0,0 +1,309 @@
+#include "tpms_alert.h"
+#include "tpms_timer_wheel.h"
+
+#include <storage/storage.h>
+#include <flipper_format/flipper_format.h>
+
+#define TAG "TPMSAlert"
+
+#define TPMS_ALERT_FILE_TYPE "Flipper TPMS Alert Rules"
+#define TPMS_ALERT_FILE_VERSION 1
+#define TPMS_ALERT_SLOT_BITS 7
+#define TPMS_ALERT_SLOTS (1 << TPMS_ALERT_SLOT_BITS) // twice TPMS_ALERT_RULES_MAX
+#define TPMS_ALERT_NO_PRESSURE INT16_MIN
+
+/** Thresholds in fixed point, 0 when off */
+typedef struct {
+    uint32_t id;
+    int16_t pressure_min_cbar;
+    int16_t pressure_max_cbar;
+    int16_t temperature_max_c;
+    uint16_t drop_cbar;
+    uint16_t missing_s;
+    bool battery_low;
+} TPMSAlertRule;
+
+/** What the checks of a sensor remember between frames */
+typedef struct {
+    int16_t pressure_cbar;
+    uint32_t timestamp;
+    uint8_t active;
+} TPMSAlertSensor;
+
+struct TPMSAlert {
+    bool enabled;
+    // Frames are checked on the worker thread, rules reload and expire on the main thread
+    FuriMutex* mutex;
+    TPMSAlertRule common;
+    TPMSAlertRule rule[TPMS_ALERT_RULES_MAX];
+    uint8_t rule_count;
+    uint8_t slot[TPMS_ALERT_SLOTS]; // rule index + 1, 0 when empty
+    TPMSTimerWheel* wheel; // timer n is the missing deadline of rule n
+    bool missing;
+    uint32_t missing_id;
+    uint16_t count;
+    TPMSAlertSensor* sensor;
+};
+
+static const char* const tpms_alert_name[TPMSAlertCount] = {
+    [TPMSAlertDrop] = "DROP",
+    [TPMSAlertPressureLow] = "LOW",
+    [TPMSAlertTemperatureHigh] = "HOT",
+    [TPMSAlertPressureHigh] = "HIGH",
+    [TPMSAlertBatteryLow] = "BATT",
+    [TPMSAlertMissing] = "MISSING",
+};
+
+static uint32_t tpms_alert_now(void) {
+    return furi_get_tick() / furi_kernel_get_tick_frequency();
+}
+
+static uint32_t tpms_alert_slot(uint32_t id) {
+    // Fibonacci hashing, ids are often sequential within a batch of sensors
+    return (id * 2654435769UL) >> (32 - TPMS_ALERT_SLOT_BITS);
+}
+
+static TPMSAlertRule* tpms_alert_find(TPMSAlert* instance, uint32_t id) {
+    for(uint32_t i = tpms_alert_slot(id);; i = (i + 1) % TPMS_ALERT_SLOTS) {
+        if(!instance->slot[i]) return NULL;
+        TPMSAlertRule* rule = &instance->rule[instance->slot[i] - 1];
+        if(rule->id == id) return rule;
+    }
+}
+
+static void tpms_alert_insert(TPMSAlert* instance, const TPMSAlertRule* rule) {
+    // Table is at most half full, so probing always ends on an empty slot
+    if(instance->rule_count >= TPMS_ALERT_RULES_MAX || tpms_alert_find(instance, rule->id)) {
+        FURI_LOG_W(TAG, "Rule for %08lX skipped", rule->id);
+        return;
+    }
+    uint32_t i = tpms_alert_slot(rule->id);
+    while(instance->slot[i]) i = (i + 1) % TPMS_ALERT_SLOTS;
+    instance->rule[instance->rule_count] = *rule;
+    instance->slot[i] = ++instance->rule_count;
+}
+
+static bool tpms_alert_read_rule(FlipperFormat* fff, TPMSAlertRule* rule, bool listed) {
+    float value;
+    uint32_t temp_data;
+    if(!flipper_format_read_float(fff, "Pressure_min", &value, 1)) return false;
+    rule->pressure_min_cbar = value * 100.0f + 0.5f;
+    if(!flipper_format_read_float(fff, "Pressure_max", &value, 1)) return false;
+    rule->pressure_max_cbar = value * 100.0f + 0.5f;
+    if(!flipper_format_read_float(fff, "Temperature_max", &value, 1)) return false;
+    rule->temperature_max_c = value;
+    if(!flipper_format_read_float(fff, "Drop", &value, 1)) return false;
+    rule->drop_cbar = value * 100.0f + 0.5f;
+    if(!flipper_format_read_uint32(fff, "Battery_low", &temp_data, 1)) return false;
+    rule->battery_low = temp_data;
+    if(listed) {
+        if(!flipper_format_read_uint32(fff, "Missing", &temp_data, 1)) return false;
+        rule->missing_s = MIN(temp_data, UINT16_MAX);
+    }
+    return true;
+}
+
+static bool tpms_alert_write_template(FlipperFormat* fff) {
+    const float zero = 0;
+    const uint32_t off = 0;
+    return flipper_format_write_header_cstr(
+               fff, TPMS_ALERT_FILE_TYPE, TPMS_ALERT_FILE_VERSION) &&
+           flipper_format_write_comment_cstr(fff, "Rule for every sensor, 0 turns a check off") &&
+           flipper_format_write_comment_cstr(
+               fff, "Pressure and drop in bar, temperature in C, missing in seconds") &&
+           flipper_format_write_float(fff, "Pressure_min", &zero, 1) &&
+           flipper_format_write_float(fff, "Pressure_max", &zero, 1) &&
+           flipper_format_write_float(fff, "Temperature_max", &zero, 1) &&
+           flipper_format_write_float(fff, "Drop", &zero, 1) &&
+           flipper_format_write_uint32(fff, "Battery_low", &off, 1) &&
+           flipper_format_write_comment_cstr(
+               fff, "Rules of single sensors follow, all keys in this order:") &&
+           flipper_format_write_comment_cstr(fff, "Id: 0A1B2C3D") &&
+           flipper_format_write_comment_cstr(fff, "Pressure_min: 2.0") &&
+           flipper_format_write_comment_cstr(fff, "Pressure_max: 3.2") &&
+           flipper_format_write_comment_cstr(fff, "Temperature_max: 80") &&
+           flipper_format_write_comment_cstr(fff, "Drop: 0.3") &&
+           flipper_format_write_comment_cstr(fff, "Battery_low: 1") &&
+           flipper_format_write_comment_cstr(fff, "Missing: 900");
+}
+
+static void tpms_alert_load(TPMSAlert* instance) {
+    memset(&instance->common, 0, sizeof(TPMSAlertRule));
+    memset(instance->slot, 0, sizeof(instance->slot));
+    instance->rule_count = 0;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* fff = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    uint32_t version = 0;
+
+    do {
+        if(!storage_file_exists(storage, TPMS_ALERT_PATH)) {
+            storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+            storage_simply_mkdir(storage, TPMS_APP_FOLDER);
+            if(!flipper_format_file_open_new(fff, TPMS_ALERT_PATH) ||
+               !tpms_alert_write_template(fff)) {
+                FURI_LOG_E(TAG, "Unable to write %s", TPMS_ALERT_PATH);
+            }
+            break;
+        }
+        if(!flipper_format_file_open_existing(fff, TPMS_ALERT_PATH)) {
+            FURI_LOG_E(TAG, "Unable to open %s", TPMS_ALERT_PATH);
+            break;
+        }
+        if(!flipper_format_read_header(fff, temp_str, &version) ||
+           furi_string_cmp_str(temp_str, TPMS_ALERT_FILE_TYPE) ||
+           version != TPMS_ALERT_FILE_VERSION) {
+            FURI_LOG_E(TAG, "Type or version mismatch");
+            break;
+        }
+        if(!tpms_alert_read_rule(fff, &instance->common, false)) {
+            FURI_LOG_E(TAG, "Missing common rule");
+            memset(&instance->common, 0, sizeof(TPMSAlertRule));
+            break;
+        }
+        while(flipper_format_read_string(fff, "Id", temp_str)) {
+            TPMSAlertRule rule = {.id = strtoul(furi_string_get_cstr(temp_str), NULL, 16)};
+            if(!tpms_alert_read_rule(fff, &rule, true)) {
+                FURI_LOG_E(TAG, "Incomplete rule for %08lX", rule.id);
+                break;
+            }
+            tpms_alert_insert(instance, &rule);
+        }
+    } while(false);
+
+    furi_string_free(temp_str);
+    flipper_format_free(fff);
+    furi_record_close(RECORD_STORAGE);
+
+    // Listed sensors must be heard from within their time from now on
+    uint32_t now = tpms_alert_now();
+    tpms_timer_wheel_reset(instance->wheel, now);
+    for(uint8_t i = 0; i < instance->rule_count; i++) {
+        if(instance->rule[i].missing_s) {
+            tpms_timer_wheel_schedule(instance->wheel, i, now + instance->rule[i].missing_s);
+        }
+    }
+    FURI_LOG_I(TAG, "%u sensor rules", instance->rule_count);
+}
+
+TPMSAlert* tpms_alert_alloc(uint16_t count) {
+    TPMSAlert* instance = malloc(sizeof(TPMSAlert));
+    memset(instance, 0, sizeof(TPMSAlert));
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    instance->wheel = tpms_timer_wheel_alloc(TPMS_ALERT_RULES_MAX, tpms_alert_now());
+    instance->count = count;
+    instance->sensor = malloc(count * sizeof(TPMSAlertSensor));
+    memset(instance->sensor, 0, count * sizeof(TPMSAlertSensor));
+    return instance;
+}
+
+void tpms_alert_free(TPMSAlert* instance) {
+    furi_assert(instance);
+    free(instance->sensor);
+    tpms_timer_wheel_free(instance->wheel);
+    furi_mutex_free(instance->mutex);
+    free(instance);
+}
+
+void tpms_alert_set_enabled(TPMSAlert* instance, bool enabled) {
+    furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    if(enabled && !instance->enabled) {
+        tpms_alert_load(instance);
+        memset(instance->sensor, 0, instance->count * sizeof(TPMSAlertSensor));
+    }
+    instance->enabled = enabled;
+    furi_mutex_release(instance->mutex);
+}
+
+bool tpms_alert_is_enabled(TPMSAlert* instance) {
+    furi_assert(instance);
+    return instance->enabled;
+}
+
+uint8_t tpms_alert_feed(
+    TPMSAlert* instance,
+    uint16_t idx,
+    bool new_sensor,
+    const TPMSBlockGeneric* frame) {
+    furi_assert(instance);
+    furi_assert(frame);
+    if(!instance->enabled || idx >= instance->count) return 0;
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    TPMSAlertSensor* sensor = &instance->sensor[idx];
+    if(new_sensor) {
+        sensor->pressure_cbar = TPMS_ALERT_NO_PRESSURE;
+        sensor->active = 0;
+    }
+
+    const TPMSAlertRule* rule = &instance->common;
+    TPMSAlertRule* listed = tpms_alert_find(instance, frame->id);
+    if(listed) {
+        rule = listed;
+        if(listed->missing_s) {
+            tpms_timer_wheel_schedule(
+                instance->wheel, listed - instance->rule, tpms_alert_now() + listed->missing_s);
+        }
+    }
+
+    int16_t pressure = frame->pressure * 100.0f + 0.5f;
+    uint8_t active = 0;
+    if(rule->pressure_min_cbar && pressure < rule->pressure_min_cbar) {
+        active |= TPMS_ALERT_MASK(TPMSAlertPressureLow);
+    }
+    if(rule->pressure_max_cbar && pressure > rule->pressure_max_cbar) {
+        active |= TPMS_ALERT_MASK(TPMSAlertPressureHigh);
+    }
+    if(rule->temperature_max_c && frame->temperature > rule->temperature_max_c) {
+        active |= TPMS_ALERT_MASK(TPMSAlertTemperatureHigh);
+    }
+    if(rule->battery_low && frame->battery_low == 1) {
+        active |= TPMS_ALERT_MASK(TPMSAlertBatteryLow);
+    }
+    if(rule->drop_cbar && sensor->pressure_cbar != TPMS_ALERT_NO_PRESSURE &&
+       frame->timestamp - sensor->timestamp <= TPMS_ALERT_DROP_WINDOW_S &&
+       sensor->pressure_cbar - pressure >= rule->drop_cbar) {
+        active |= TPMS_ALERT_MASK(TPMSAlertDrop);
+    }
+
+    // Only alerts that were not active on the previous frame notify
+    uint8_t raised = active & ~sensor->active;
+    sensor->active = active;
+    sensor->pressure_cbar = pressure;
+    sensor->timestamp = frame->timestamp;
+    furi_mutex_release(instance->mutex);
+    return raised;
+}
+
+static void tpms_alert_timer_callback(uint16_t timer, void* context) {
+    TPMSAlert* instance = context;
+    instance->missing = true;
+    instance->missing_id = instance->rule[timer].id;
+    FURI_LOG_I(TAG, "Sensor %08lX missing", instance->missing_id);
+}
+
+uint8_t tpms_alert_tick(TPMSAlert* instance, uint32_t* id) {
+    furi_assert(instance);
+    if(!instance->enabled) return 0;
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    instance->missing = false;
+    tpms_timer_wheel_advance(
+        instance->wheel, tpms_alert_now(), tpms_alert_timer_callback, instance);
+    bool missing = instance->missing;
+    if(missing && id) *id = instance->missing_id;
+    furi_mutex_release(instance->mutex);
+    return missing ? TPMS_ALERT_MASK(TPMSAlertMissing) : 0;
+}
+
+uint8_t tpms_alert_get_active(TPMSAlert* instance, uint16_t idx) {
+    furi_assert(instance);
+    if(!instance->enabled || idx >= instance->count) return 0;
+    return instance->sensor[idx].active;
+}
+
+const char* tpms_alert_get_name(TPMSAlertType type) {
+    return type < TPMSAlertCount ? tpms_alert_name[type] : "";
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <furi.h>
+#include "tpms_types.h"
+#include "../protocols/tpms_generic.h"
+
+/* Alert rules, read from TPMS_ALERT_PATH. One rule applies to every sensor, sensors listed by
+ * ID get their own. Listed sensors sit in an open addressing table, so a frame finds its rule
+ * in O(1) and is checked against a handful of thresholds. Missing sensors are found by a
+ * timer wheel, one timer per listed sensor pushed back by each of its frames. */
+
+#define TPMS_ALERT_PATH TPMS_APP_FOLDER "/alerts.txt"
+#define TPMS_ALERT_RULES_MAX 64
+#define TPMS_ALERT_DROP_WINDOW_S 300 // a drop counts against a reading this recent
+
+/** Alert types, most urgent first */
+typedef enum {
+    TPMSAlertDrop,
+    TPMSAlertPressureLow,
+    TPMSAlertTemperatureHigh,
+    TPMSAlertPressureHigh,
+    TPMSAlertBatteryLow,
+    TPMSAlertMissing,
+    TPMSAlertCount,
+} TPMSAlertType;
+
+#define TPMS_ALERT_MASK(type) (1u << (type))
+
+typedef struct TPMSAlert TPMSAlert;
+
+/** Allocate TPMSAlert. Rules are read when alerts are enabled
+ *
+ * @param count - number of sensors, one per history record
+ * @return TPMSAlert*
+ */
+TPMSAlert* tpms_alert_alloc(uint16_t count);
+
+/** Free TPMSAlert
+ *
+ * @param instance - TPMSAlert instance
+ */
+void tpms_alert_free(TPMSAlert* instance);
+
+/** Enable or disable alerts. Enabling reloads the rules, a commented template is written
+ * when there are none
+ *
+ * @param instance  - TPMSAlert instance
+ * @param enabled   - alerts state
+ */
+void tpms_alert_set_enabled(TPMSAlert* instance, bool enabled);
+
+/** Get alerts state
+ *
+ * @param instance  - TPMSAlert instance
+ * @return bool     - is enabled
+ */
+bool tpms_alert_is_enabled(TPMSAlert* instance);
+
+/** Check a frame against its rule. Called from rx callback on worker thread
+ *
+ * @param instance      - TPMSAlert instance
+ * @param idx           - history record index
+ * @param new_sensor    - the record holds a new sensor, drop what was known
+ * @param frame         - decoded frame
+ * @return uint8_t      - TPMS_ALERT_MASK of alerts just raised
+ */
+uint8_t tpms_alert_feed(
+    TPMSAlert* instance,
+    uint16_t idx,
+    bool new_sensor,
+    const TPMSBlockGeneric* frame);
+
+/** Find listed sensors that went missing. Called on main thread
+ *
+ * @param instance  - TPMSAlert instance
+ * @param id        - id of a sensor that went missing, when any
+ * @return uint8_t  - TPMS_ALERT_MASK(TPMSAlertMissing) when a sensor went missing
+ */
+uint8_t tpms_alert_tick(TPMSAlert* instance, uint32_t* id);
+
+/** Get alerts active on a sensor, as of its last frame
+ *
+ * @param instance  - TPMSAlert instance
+ * @param idx       - history record index
+ * @return uint8_t  - TPMS_ALERT_MASK of active alerts
+ */
+uint8_t tpms_alert_get_active(TPMSAlert* instance, uint16_t idx);
+
+/** Get short alert name
+ *
+ * @param type          - TPMSAlertType
+ * @return const char*  - name
+ */
+const char* tpms_alert_get_name(TPMSAlertType type);
@@ -0,0 +1,147 @@
+#include "tpms_baseline.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <storage/storage.h>
+#include <toolbox/stream/file_stream.h>
+
+#define TAG "TPMSBaseline"
+
+#define TPMS_BASELINE_SLOT_BITS 9
+#define TPMS_BASELINE_SLOTS (1 << TPMS_BASELINE_SLOT_BITS) // twice TPMS_BASELINE_MAX
+
+typedef struct {
+    uint32_t id;
+    float pressure; // bar
+} TPMSBaselineSensor;
+
+// Loaded and checked on main thread only
+struct TPMSBaseline {
+    TPMSBaselineSensor sensor[TPMS_BASELINE_MAX];
+    uint16_t count;
+    uint16_t slot[TPMS_BASELINE_SLOTS]; // sensor index + 1, 0 when empty
+};
+
+static const char* const tpms_baseline_mark[] = {
+    [TPMSBaselineMarkNone] = "",
+    [TPMSBaselineMarkNew] = "+",
+    [TPMSBaselineMarkUnchanged] = "=",
+    [TPMSBaselineMarkChanged] = "!",
+};
+
+static uint32_t tpms_baseline_slot(uint32_t id) {
+    // Fibonacci hashing, same as the alert rules
+    return (id * 2654435769UL) >> (32 - TPMS_BASELINE_SLOT_BITS);
+}
+
+static TPMSBaselineSensor* tpms_baseline_find(TPMSBaseline* instance, uint32_t id) {
+    for(uint32_t i = tpms_baseline_slot(id);; i = (i + 1) % TPMS_BASELINE_SLOTS) {
+        if(!instance->slot[i]) return NULL;
+        TPMSBaselineSensor* sensor = &instance->sensor[instance->slot[i] - 1];
+        if(sensor->id == id) return sensor;
+    }
+}
+
+static void tpms_baseline_set(TPMSBaseline* instance, uint32_t id, float pressure) {
+    TPMSBaselineSensor* sensor = tpms_baseline_find(instance, id);
+    if(!sensor) {
+        // Table is at most half full, so probing always ends on an empty slot
+        if(instance->count >= TPMS_BASELINE_MAX) {
+            FURI_LOG_W(TAG, "Sensor %08lX skipped", id);
+            return;
+        }
+        uint32_t i = tpms_baseline_slot(id);
+        while(instance->slot[i]) i = (i + 1) % TPMS_BASELINE_SLOTS;
+        sensor = &instance->sensor[instance->count++];
+        instance->slot[i] = instance->count;
+        sensor->id = id;
+    }
+    // Log is in time order, the last reading wins
+    sensor->pressure = pressure;
+}
+
+// "time,protocol,id,pressure,..." as written by tpms_session_log_save_pending
+static bool tpms_baseline_parse(const char* line, uint32_t* id, float* pressure) {
+    char* end = NULL;
+    strtoul(line, &end, 10);
+    if(end == line) return false;
+    // Milliseconds, in logs written since readings are timed on the tick
+    if(*end == '.') strtoul(end + 1, &end, 10);
+    if(*end != ',') return false;
+    const char* field = strchr(end + 1, ',');
+    if(!field) return false;
+    field++;
+    *id = strtoul(field, &end, 16);
+    if(end == field || *end != ',') return false;
+    field = end + 1;
+    *pressure = strtof(field, &end);
+    return end != field;
+}
+
+TPMSBaseline* tpms_baseline_alloc(void) {
+    TPMSBaseline* instance = malloc(sizeof(TPMSBaseline));
+    memset(instance, 0, sizeof(TPMSBaseline));
+    return instance;
+}
+
+void tpms_baseline_free(TPMSBaseline* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+bool tpms_baseline_load(TPMSBaseline* instance, const char* path) {
+    furi_assert(instance);
+    furi_assert(path);
+    tpms_baseline_clear(instance);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+    FuriString* line = furi_string_alloc();
+
+    if(file_stream_open(stream, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint32_t id = 0;
+        float pressure = 0;
+        while(stream_read_line(stream, line)) {
+            // Header and broken lines do not parse
+            if(tpms_baseline_parse(furi_string_get_cstr(line), &id, &pressure)) {
+                tpms_baseline_set(instance, id, pressure);
+            }
+        }
+    } else {
+        FURI_LOG_E(TAG, "Unable to open %s", path);
+    }
+
+    furi_string_free(line);
+    file_stream_close(stream);
+    stream_free(stream);
+    furi_record_close(RECORD_STORAGE);
+
+    FURI_LOG_I(TAG, "%u sensors from %s", instance->count, path);
+    return instance->count > 0;
+}
+
+void tpms_baseline_clear(TPMSBaseline* instance) {
+    furi_assert(instance);
+    instance->count = 0;
+    memset(instance->slot, 0, sizeof(instance->slot));
+}
+
+uint16_t tpms_baseline_get_count(TPMSBaseline* instance) {
+    furi_assert(instance);
+    return instance->count;
+}
+
+TPMSBaselineMark tpms_baseline_check(TPMSBaseline* instance, uint32_t id, float pressure) {
+    furi_assert(instance);
+    if(!instance->count) return TPMSBaselineMarkNone;
+    const TPMSBaselineSensor* sensor = tpms_baseline_find(instance, id);
+    if(!sensor) return TPMSBaselineMarkNew;
+    if(fabsf(pressure - sensor->pressure) >= TPMS_BASELINE_PRESSURE_DELTA) {
+        return TPMSBaselineMarkChanged;
+    }
+    return TPMSBaselineMarkUnchanged;
+}
+
+const char* tpms_baseline_get_mark(TPMSBaselineMark mark) {
+    return mark <= TPMSBaselineMarkChanged ? tpms_baseline_mark[mark] : "";
+}
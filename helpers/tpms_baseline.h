@@ -0,0 +1,69 @@
+#pragma once
+
+#include <furi.h>
+
+/* Baseline for a session diff, read from a saved session log. Baseline sensors sit in an
+ * open addressing table by ID with their last pressure, so each live reading is marked new,
+ * unchanged or changed with a single O(1) lookup. */
+
+#define TPMS_BASELINE_MAX 256
+#define TPMS_BASELINE_PRESSURE_DELTA 0.1f // bar, smaller changes count as unchanged
+
+/** Live sensor against the baseline */
+typedef enum {
+    TPMSBaselineMarkNone, // no baseline loaded
+    TPMSBaselineMarkNew,
+    TPMSBaselineMarkUnchanged,
+    TPMSBaselineMarkChanged, // known, pressure changed
+} TPMSBaselineMark;
+
+typedef struct TPMSBaseline TPMSBaseline;
+
+/** Allocate TPMSBaseline, empty
+ *
+ * @return TPMSBaseline*
+ */
+TPMSBaseline* tpms_baseline_alloc(void);
+
+/** Free TPMSBaseline
+ *
+ * @param instance - TPMSBaseline instance
+ */
+void tpms_baseline_free(TPMSBaseline* instance);
+
+/** Load a session log as the baseline, the last reading of each sensor counts
+ *
+ * @param instance  - TPMSBaseline instance
+ * @param path      - session log path
+ * @return bool     - any sensor was read
+ */
+bool tpms_baseline_load(TPMSBaseline* instance, const char* path);
+
+/** Drop the baseline, readings are not marked anymore
+ *
+ * @param instance - TPMSBaseline instance
+ */
+void tpms_baseline_clear(TPMSBaseline* instance);
+
+/** Get number of baseline sensors
+ *
+ * @param instance  - TPMSBaseline instance
+ * @return uint16_t - sensors, 0 when no baseline is loaded
+ */
+uint16_t tpms_baseline_get_count(TPMSBaseline* instance);
+
+/** Mark a live reading against the baseline
+ *
+ * @param instance          - TPMSBaseline instance
+ * @param id                - sensor id
+ * @param pressure          - bar
+ * @return TPMSBaselineMark - mark
+ */
+TPMSBaselineMark tpms_baseline_check(TPMSBaseline* instance, uint32_t id, float pressure);
+
+/** Get one character mark for the sensor list
+ *
+ * @param mark          - TPMSBaselineMark
+ * @return const char*  - mark, empty for TPMSBaselineMarkNone
+ */
+const char* tpms_baseline_get_mark(TPMSBaselineMark mark);
@@ -0,0 +1,392 @@
+#include "tpms_burst_library.h"
+#include "tpms_types.h"
+#include "../protocols/tpms_generic.h"
+
+#include <storage/storage.h>
+#include <lib/flipper_format/flipper_format.h>
+#include <lib/subghz/blocks/math.h>
+
+#define TAG "TPMSBurstLibrary"
+
+#define TPMS_BURST_LIBRARY_FOLDER TPMS_APP_FOLDER "/unknown"
+#define TPMS_BURST_LIBRARY_INDEX TPMS_BURST_LIBRARY_FOLDER "/index.bin"
+#define TPMS_BURST_LIBRARY_MAGIC 0x42555054 // "TPUB"
+#define TPMS_BURST_LIBRARY_VERSION 1
+
+#define TPMS_BURST_PULSES_MAX 1024
+#define TPMS_BURST_PULSES_MIN 32
+#define TPMS_BURST_RSSI_PULSE 16
+#define TPMS_BURST_RSSI_MIN -80.0f
+// Must stay longer than any decoder burst timeout, so decoders emit before the burst is judged
+#define TPMS_BURST_GAP_US 25000
+#define TPMS_BURST_RAW_LINE 512
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t next_slot;
+    uint16_t count;
+    uint16_t reserved;
+} TPMSBurstLibraryHeader;
+
+struct TPMSBurstLibrary {
+    bool enabled;
+    bool loaded;
+    bool decoded;
+    volatile bool pending;
+
+    uint32_t frequency;
+    float rssi;
+    uint32_t duration;
+    uint16_t pulse_count;
+    int32_t* pulses;
+    TPMSBurstFeatures features;
+
+    uint16_t next_slot;
+    uint16_t count;
+    uint32_t hashes[TPMS_BURST_LIBRARY_MAX];
+};
+
+TPMSBurstLibrary* tpms_burst_library_alloc(void) {
+    TPMSBurstLibrary* instance = malloc(sizeof(TPMSBurstLibrary));
+    memset(instance, 0, sizeof(TPMSBurstLibrary));
+    instance->pulses = malloc(sizeof(int32_t) * TPMS_BURST_PULSES_MAX);
+    instance->rssi = -127.0f;
+    return instance;
+}
+
+void tpms_burst_library_free(TPMSBurstLibrary* instance) {
+    furi_assert(instance);
+    free(instance->pulses);
+    free(instance);
+}
+
+static void tpms_burst_library_load(TPMSBurstLibrary* instance) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    TPMSBurstLibraryHeader header = {0};
+
+    instance->count = 0;
+    instance->next_slot = 0;
+    do {
+        if(!storage_file_open(file, TPMS_BURST_LIBRARY_INDEX, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+           header.magic != TPMS_BURST_LIBRARY_MAGIC ||
+           header.version != TPMS_BURST_LIBRARY_VERSION ||
+           header.count > TPMS_BURST_LIBRARY_MAX || header.next_slot >= TPMS_BURST_LIBRARY_MAX) {
+            FURI_LOG_W(TAG, "Index ignored");
+            break;
+        }
+        TPMSBurstFeatures features;
+        for(uint16_t i = 0; i < header.count; i++) {
+            if(storage_file_read(file, &features, sizeof(features)) != sizeof(features)) break;
+            instance->hashes[i] = features.hash;
+            instance->count++;
+        }
+        instance->next_slot = header.next_slot;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    instance->loaded = true;
+}
+
+void tpms_burst_library_set_enabled(TPMSBurstLibrary* instance, bool enabled) {
+    furi_assert(instance);
+    if(enabled && !instance->loaded) tpms_burst_library_load(instance);
+    tpms_burst_library_reset(instance);
+    instance->enabled = enabled;
+}
+
+bool tpms_burst_library_is_enabled(TPMSBurstLibrary* instance) {
+    furi_assert(instance);
+    return instance->enabled;
+}
+
+void tpms_burst_library_set_frequency(TPMSBurstLibrary* instance, uint32_t frequency) {
+    furi_assert(instance);
+    instance->frequency = frequency;
+}
+
+// Capture state belongs to whoever holds it: the worker while pending is clear, the main
+// thread while it is set
+static void tpms_burst_library_clear(TPMSBurstLibrary* instance) {
+    instance->pulse_count = 0;
+    instance->duration = 0;
+    instance->decoded = false;
+    instance->rssi = -127.0f;
+}
+
+void tpms_burst_library_reset(TPMSBurstLibrary* instance) {
+    furi_assert(instance);
+    if(instance->pending) return;
+    tpms_burst_library_clear(instance);
+}
+
+void tpms_burst_library_mark_decoded(TPMSBurstLibrary* instance) {
+    furi_assert(instance);
+    instance->decoded = true;
+}
+
+static uint32_t tpms_burst_library_hash(uint32_t hash, uint32_t value) {
+    // FNV-1a over the value bytes
+    for(uint8_t i = 0; i < sizeof(uint32_t); i++) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * Group pulse durations into clusters within 25% of the running centre.
+ * @return bool - the burst looks like a modulated signal rather than noise
+ */
+static bool tpms_burst_library_analyze(TPMSBurstLibrary* instance) {
+    TPMSBurstFeatures* features = &instance->features;
+    uint16_t outliers = 0;
+
+    memset(features, 0, sizeof(TPMSBurstFeatures));
+    for(uint16_t i = 0; i < instance->pulse_count; i++) {
+        uint32_t duration = abs(instance->pulses[i]);
+        uint8_t j = 0;
+        for(; j < features->cluster_count; j++) {
+            TPMSBurstCluster* cluster = &features->clusters[j];
+            if(DURATION_DIFF(duration, cluster->duration) < cluster->duration / 4) {
+                cluster->duration =
+                    (cluster->duration * cluster->count + duration) / (cluster->count + 1);
+                cluster->count++;
+                break;
+            }
+        }
+        if(j == features->cluster_count) {
+            if(features->cluster_count < TPMS_BURST_CLUSTERS_MAX && duration <= UINT16_MAX) {
+                features->clusters[features->cluster_count].duration = duration;
+                features->clusters[features->cluster_count].count = 1;
+                features->cluster_count++;
+            } else {
+                outliers++;
+            }
+        }
+    }
+
+    // Noise spreads over all lengths, a real transmission packs into few clusters
+    if(outliers > instance->pulse_count / 8) return false;
+
+    // Sort clusters by duration, so the hash does not depend on pulse order
+    for(uint8_t i = 1; i < features->cluster_count; i++) {
+        TPMSBurstCluster cluster = features->clusters[i];
+        uint8_t j = i;
+        for(; j > 0 && features->clusters[j - 1].duration > cluster.duration; j--) {
+            features->clusters[j] = features->clusters[j - 1];
+        }
+        features->clusters[j] = cluster;
+    }
+
+    features->frequency = instance->frequency;
+    features->duration = instance->duration;
+    features->pulse_count = instance->pulse_count;
+    features->rssi = (int8_t)instance->rssi;
+
+    // Quantize, so repeated transmissions of the same sensor collapse into one entry
+    uint32_t hash = 2166136261UL;
+    hash = tpms_burst_library_hash(hash, features->frequency / 100000);
+    hash = tpms_burst_library_hash(hash, features->pulse_count / 16);
+    for(uint8_t i = 0; i < features->cluster_count; i++) {
+        hash = tpms_burst_library_hash(hash, (features->clusters[i].duration + 8) / 16);
+    }
+    features->hash = hash;
+    return true;
+}
+
+static bool tpms_burst_library_close(TPMSBurstLibrary* instance) {
+    bool ready = !instance->decoded && instance->pulse_count >= TPMS_BURST_PULSES_MIN &&
+                 instance->rssi >= TPMS_BURST_RSSI_MIN && tpms_burst_library_analyze(instance);
+    if(ready) {
+        // Hands the burst to the main thread, after its last pulse is stored
+        __atomic_store_n(&instance->pending, true, __ATOMIC_RELEASE);
+    } else {
+        tpms_burst_library_clear(instance);
+    }
+    return ready;
+}
+
+bool tpms_burst_library_feed(TPMSBurstLibrary* instance, bool level, uint32_t duration) {
+    furi_assert(instance);
+    if(!instance->enabled || __atomic_load_n(&instance->pending, __ATOMIC_ACQUIRE)) return false;
+
+    if(duration >= TPMS_BURST_GAP_US) {
+        if(!instance->pulse_count) {
+            instance->decoded = false;
+            return false;
+        }
+        return tpms_burst_library_close(instance);
+    }
+
+    // Burst starts with a high level
+    if(!instance->pulse_count && !level) return false;
+
+    instance->pulses[instance->pulse_count++] = level ? (int32_t)duration : -(int32_t)duration;
+    instance->duration += duration;
+
+    if(instance->pulse_count == TPMS_BURST_RSSI_PULSE) {
+        // Sampled mid-burst, while the transmitter is still on air
+        instance->rssi = furi_hal_subghz_get_rssi();
+    }
+    if(instance->pulse_count == TPMS_BURST_PULSES_MAX) {
+        return tpms_burst_library_close(instance);
+    }
+    return false;
+}
+
+static bool tpms_burst_library_write_raw(
+    TPMSBurstLibrary* instance,
+    Storage* storage,
+    const char* path,
+    SubGhzRadioPreset* preset) {
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    TPMSBurstFeatures* features = &instance->features;
+    bool res = false;
+
+    do {
+        if(!flipper_format_file_open_always(flipper_format, path)) {
+            FURI_LOG_E(TAG, "Unable to open %s", path);
+            break;
+        }
+        if(!flipper_format_write_header_cstr(flipper_format, "Flipper SubGhz RAW File", 1)) {
+            break;
+        }
+        if(!flipper_format_write_uint32(flipper_format, "Frequency", &features->frequency, 1)) {
+            break;
+        }
+        tpms_block_generic_get_preset_name(furi_string_get_cstr(preset->name), temp_str);
+        if(!flipper_format_write_string(flipper_format, "Preset", temp_str)) break;
+        if(!strcmp(furi_string_get_cstr(temp_str), "FuriHalSubGhzPresetCustom")) {
+            if(!flipper_format_write_string_cstr(
+                   flipper_format, "Custom_preset_module", "CC1101")) {
+                break;
+            }
+            if(!flipper_format_write_hex(
+                   flipper_format, "Custom_preset_data", preset->data, preset->data_size)) {
+                break;
+            }
+        }
+        if(!flipper_format_write_string_cstr(flipper_format, "Protocol", "RAW")) break;
+
+        // Feature summary, ignored by SubGhz RAW loader
+        if(!flipper_format_write_hex(
+               flipper_format, "Feature_hash", (uint8_t*)&features->hash, sizeof(uint32_t))) {
+            break;
+        }
+        if(!flipper_format_write_uint32(flipper_format, "Duration", &features->duration, 1)) {
+            break;
+        }
+        uint32_t temp_data = features->pulse_count;
+        if(!flipper_format_write_uint32(flipper_format, "Pulses", &temp_data, 1)) break;
+        int32_t rssi = features->rssi;
+        if(!flipper_format_write_int32(flipper_format, "Rssi", &rssi, 1)) break;
+        uint32_t clusters[TPMS_BURST_CLUSTERS_MAX * 2];
+        for(uint8_t i = 0; i < features->cluster_count; i++) {
+            clusters[i * 2] = features->clusters[i].duration;
+            clusters[i * 2 + 1] = features->clusters[i].count;
+        }
+        if(!flipper_format_write_uint32(
+               flipper_format, "Clusters", clusters, features->cluster_count * 2)) {
+            break;
+        }
+
+        res = true;
+        for(uint16_t i = 0; i < instance->pulse_count; i += TPMS_BURST_RAW_LINE) {
+            uint16_t count = MIN(instance->pulse_count - i, TPMS_BURST_RAW_LINE);
+            if(!flipper_format_write_int32(
+                   flipper_format, "RAW_Data", &instance->pulses[i], count)) {
+                res = false;
+                break;
+            }
+        }
+    } while(false);
+
+    furi_string_free(temp_str);
+    flipper_format_free(flipper_format);
+    return res;
+}
+
+static bool tpms_burst_library_write_index(TPMSBurstLibrary* instance, Storage* storage) {
+    File* file = storage_file_alloc(storage);
+    TPMSBurstLibraryHeader header = {
+        .magic = TPMS_BURST_LIBRARY_MAGIC,
+        .version = TPMS_BURST_LIBRARY_VERSION,
+        .next_slot = instance->next_slot,
+        .count = instance->count,
+    };
+    // Slot written is the one just before next_slot
+    uint16_t slot = (instance->next_slot + TPMS_BURST_LIBRARY_MAX - 1) % TPMS_BURST_LIBRARY_MAX;
+    bool res = false;
+
+    do {
+        if(!storage_file_open(file, TPMS_BURST_LIBRARY_INDEX, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+            break;
+        }
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(!storage_file_seek(file, sizeof(header) + slot * sizeof(TPMSBurstFeatures), true)) {
+            break;
+        }
+        if(storage_file_write(file, &instance->features, sizeof(TPMSBurstFeatures)) !=
+           sizeof(TPMSBurstFeatures)) {
+            break;
+        }
+        res = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return res;
+}
+
+bool tpms_burst_library_save_pending(TPMSBurstLibrary* instance, SubGhzRadioPreset* preset) {
+    furi_assert(instance);
+    furi_assert(preset);
+    if(!__atomic_load_n(&instance->pending, __ATOMIC_ACQUIRE)) return false;
+
+    bool saved = false;
+    bool known = false;
+    for(uint16_t i = 0; i < instance->count; i++) {
+        if(instance->hashes[i] == instance->features.hash) {
+            known = true;
+            break;
+        }
+    }
+
+    if(!known) {
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+        storage_simply_mkdir(storage, TPMS_APP_FOLDER);
+        storage_simply_mkdir(storage, TPMS_BURST_LIBRARY_FOLDER);
+
+        // Library is a ring, the oldest burst gives way when full
+        uint16_t slot = instance->next_slot;
+        FuriString* path =
+            furi_string_alloc_printf(TPMS_BURST_LIBRARY_FOLDER "/burst_%02u.sub", slot);
+        if(tpms_burst_library_write_raw(instance, storage, furi_string_get_cstr(path), preset)) {
+            instance->hashes[slot] = instance->features.hash;
+            instance->next_slot = (slot + 1) % TPMS_BURST_LIBRARY_MAX;
+            if(instance->count < TPMS_BURST_LIBRARY_MAX) instance->count++;
+            saved = tpms_burst_library_write_index(instance, storage);
+            FURI_LOG_I(
+                TAG,
+                "Burst %08lX saved: %u pulses",
+                instance->features.hash,
+                instance->features.pulse_count);
+        }
+        furi_string_free(path);
+        furi_record_close(RECORD_STORAGE);
+    }
+
+    // The worker feeds again once pending is clear, so the capture is reset before that
+    tpms_burst_library_clear(instance);
+    __atomic_store_n(&instance->pending, false, __ATOMIC_RELEASE);
+    return saved;
+}
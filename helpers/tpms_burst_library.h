@@ -0,0 +1,89 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+#include <lib/subghz/types.h>
+
+#define TPMS_BURST_LIBRARY_MAX 64
+#define TPMS_BURST_CLUSTERS_MAX 4
+
+typedef struct TPMSBurstLibrary TPMSBurstLibrary;
+
+/** Timing cluster: pulses of similar length */
+typedef struct {
+    uint16_t duration; // cluster centre, us
+    uint16_t count;
+} TPMSBurstCluster;
+
+/** Compact feature record of an undecoded burst, as stored in the library index */
+typedef struct {
+    uint32_t hash;
+    uint32_t frequency;
+    uint32_t duration; // us
+    uint16_t pulse_count;
+    int8_t rssi;
+    uint8_t cluster_count;
+    TPMSBurstCluster clusters[TPMS_BURST_CLUSTERS_MAX];
+} TPMSBurstFeatures;
+
+/** Allocate TPMSBurstLibrary
+ *
+ * @return TPMSBurstLibrary*
+ */
+TPMSBurstLibrary* tpms_burst_library_alloc(void);
+
+/** Free TPMSBurstLibrary
+ *
+ * @param instance - TPMSBurstLibrary instance
+ */
+void tpms_burst_library_free(TPMSBurstLibrary* instance);
+
+/** Enable or disable capturing of undecoded bursts
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ * @param enabled   - capture state
+ */
+void tpms_burst_library_set_enabled(TPMSBurstLibrary* instance, bool enabled);
+
+/** Get capture state
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ * @return bool     - is enabled
+ */
+bool tpms_burst_library_is_enabled(TPMSBurstLibrary* instance);
+
+/** Set frequency the receiver is tuned to, attached to bursts captured from now on
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ * @param frequency - frequency Hz
+ */
+void tpms_burst_library_set_frequency(TPMSBurstLibrary* instance, uint32_t frequency);
+
+/** Drop the burst in progress, e.g. on worker overrun or frequency change
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ */
+void tpms_burst_library_reset(TPMSBurstLibrary* instance);
+
+/** Mark the burst in progress as decoded by some protocol. Called from rx callback
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ */
+void tpms_burst_library_mark_decoded(TPMSBurstLibrary* instance);
+
+/** Feed a level and duration pair. Called from worker thread after protocol decoders
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ * @param level     - signal level true-high false-low
+ * @param duration  - duration of this level in, us
+ * @return bool     - an undecoded burst is waiting for tpms_burst_library_save_pending
+ */
+bool tpms_burst_library_feed(TPMSBurstLibrary* instance, bool level, uint32_t duration);
+
+/** Store the pending burst on SD, unless a burst with the same feature hash is already there
+ *
+ * @param instance  - TPMSBurstLibrary instance
+ * @param preset    - SubGhzRadioPreset the burst was received with
+ * @return bool     - burst was saved
+ */
+bool tpms_burst_library_save_pending(TPMSBurstLibrary* instance, SubGhzRadioPreset* preset);
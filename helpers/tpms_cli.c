@@ -0,0 +1,120 @@
+#include "tpms_cli.h"
+
+#include <cli/cli.h>
+
+#define TAG "TPMSCli"
+
+typedef struct {
+    uint32_t tick;
+    uint32_t id;
+    uint32_t frequency; // Hz
+    float pressure; // bar
+    float temperature; // celsius
+    float rssi; // dBm
+    char protocol[TPMS_CLI_PROTOCOL_LEN];
+} TPMSCliRecord;
+
+struct TPMSCli {
+    Cli* cli;
+    // Single writer (worker) and single reader (CLI thread), the stream buffer needs no lock
+    FuriStreamBuffer* stream;
+    volatile bool streaming; // worker may write
+    // Command holds the instance. Set before it looks at closing, and free sets closing before
+    // it looks at running, so one of them always sees the other
+    volatile bool running;
+    volatile bool closing;
+    volatile uint32_t dropped;
+};
+
+static void tpms_cli_command(Cli* cli, FuriString* args, void* context) {
+    UNUSED(args);
+    TPMSCli* instance = context;
+    __atomic_store_n(&instance->running, true, __ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&instance->closing, __ATOMIC_SEQ_CST)) {
+        __atomic_store_n(&instance->running, false, __ATOMIC_SEQ_CST);
+        return;
+    }
+
+    // Frames from before the command are stale, the worker only writes while streaming
+    furi_stream_buffer_reset(instance->stream);
+    instance->dropped = 0;
+    instance->streaming = true;
+    printf("tick,protocol,id,pressure,temperature,rssi,frequency\r\n");
+
+    TPMSCliRecord record;
+    uint32_t dropped = 0;
+    while(!instance->closing && !cli_cmd_interrupt_received(cli)) {
+        if(furi_stream_buffer_receive(instance->stream, &record, sizeof(record), 100) !=
+           sizeof(record)) {
+            continue;
+        }
+        printf(
+            "%lu,%s,%08lX,%.2f,%.1f,%.1f,%lu\r\n",
+            record.tick,
+            record.protocol,
+            record.id,
+            (double)record.pressure,
+            (double)record.temperature,
+            (double)record.rssi,
+            record.frequency);
+        if(instance->dropped != dropped) {
+            dropped = instance->dropped;
+            printf("# %lu dropped\r\n", dropped);
+        }
+    }
+    instance->streaming = false;
+    // Last access, the instance may be freed right after
+    __atomic_store_n(&instance->running, false, __ATOMIC_SEQ_CST);
+}
+
+TPMSCli* tpms_cli_alloc(void) {
+    TPMSCli* instance = malloc(sizeof(TPMSCli));
+    memset(instance, 0, sizeof(TPMSCli));
+    instance->stream = furi_stream_buffer_alloc(
+        TPMS_CLI_BUFFER_RECORDS * sizeof(TPMSCliRecord), sizeof(TPMSCliRecord));
+    instance->cli = furi_record_open(RECORD_CLI);
+    cli_add_command(
+        instance->cli, TPMS_CLI_COMMAND, CliCommandFlagParallelSafe, tpms_cli_command, instance);
+    return instance;
+}
+
+void tpms_cli_free(TPMSCli* instance) {
+    furi_assert(instance);
+    cli_delete_command(instance->cli, TPMS_CLI_COMMAND);
+    // A running command still holds the instance, it checks closing every receive timeout
+    __atomic_store_n(&instance->closing, true, __ATOMIC_SEQ_CST);
+    while(__atomic_load_n(&instance->running, __ATOMIC_SEQ_CST)) {
+        furi_delay_ms(10);
+    }
+    furi_record_close(RECORD_CLI);
+    furi_stream_buffer_free(instance->stream);
+    free(instance);
+}
+
+void tpms_cli_feed(
+    TPMSCli* instance,
+    const char* protocol,
+    const TPMSBlockGeneric* generic,
+    uint32_t frequency) {
+    furi_assert(instance);
+    furi_assert(protocol);
+    furi_assert(generic);
+    if(!instance->streaming) return;
+
+    TPMSCliRecord record = {
+        .tick = furi_get_tick(),
+        .id = generic->id,
+        .frequency = frequency,
+        .pressure = generic->pressure,
+        .temperature = generic->temperature,
+        .rssi = generic->rssi,
+    };
+    strlcpy(record.protocol, protocol, sizeof(record.protocol));
+
+    // Whole records only: a partial write would shift every record after it. The reader only
+    // ever frees space, so the check holds until the send
+    if(furi_stream_buffer_spaces_available(instance->stream) < sizeof(record) ||
+       furi_stream_buffer_send(instance->stream, &record, sizeof(record), 0) != sizeof(record)) {
+        instance->dropped++;
+    }
+}
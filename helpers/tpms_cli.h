@@ -0,0 +1,39 @@
+#pragma once
+
+#include <furi.h>
+#include "../protocols/tpms_generic.h"
+
+/* `tpms` CLI command, streams each decoded frame as a line while the app runs. The worker
+ * hands fixed-size records to a stream buffer without waiting, a frame that finds the buffer
+ * full is counted and dropped, and the CLI thread formats and prints them at its own pace. */
+
+#define TPMS_CLI_COMMAND "tpms"
+#define TPMS_CLI_BUFFER_RECORDS 32
+#define TPMS_CLI_PROTOCOL_LEN 16
+
+typedef struct TPMSCli TPMSCli;
+
+/** Allocate TPMSCli and register the CLI command
+ *
+ * @return TPMSCli*
+ */
+TPMSCli* tpms_cli_alloc(void);
+
+/** Unregister the CLI command, wait for a running stream to stop, free TPMSCli
+ *
+ * @param instance - TPMSCli instance
+ */
+void tpms_cli_free(TPMSCli* instance);
+
+/** Pass a decoded frame to the stream, never blocks. Called from rx callback on worker thread
+ *
+ * @param instance  - TPMSCli instance
+ * @param protocol  - protocol name
+ * @param generic   - decoded frame
+ * @param frequency - frequency Hz the frame was received on
+ */
+void tpms_cli_feed(
+    TPMSCli* instance,
+    const char* protocol,
+    const TPMSBlockGeneric* generic,
+    uint32_t frequency);
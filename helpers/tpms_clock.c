@@ -0,0 +1,18 @@
+#include "tpms_clock.h"
+
+// Written once by tpms_clock_anchor, before the worker is started
+static uint32_t tpms_clock_rtc;
+static uint32_t tpms_clock_tick;
+
+void tpms_clock_anchor(void) {
+    tpms_clock_tick = furi_get_tick();
+    tpms_clock_rtc = furi_hal_rtc_get_timestamp();
+}
+
+uint32_t tpms_clock_get_timestamp(uint16_t* ms) {
+    // Unsigned difference, correct across one tick wrap (49 days at 1 kHz)
+    uint64_t elapsed_ms = (uint64_t)(furi_get_tick() - tpms_clock_tick) * 1000 /
+                          furi_kernel_get_tick_frequency();
+    if(ms) *ms = elapsed_ms % 1000;
+    return tpms_clock_rtc + elapsed_ms / 1000;
+}
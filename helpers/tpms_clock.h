@@ -0,0 +1,19 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+
+/* Wall clock for readings. The RTC is read once, when the app starts, together with the system
+ * tick. After that the time is the RTC reading plus the ticks since, which costs no RTC access
+ * and resolves milliseconds. Times are exact relative to each other, the anchor itself is only
+ * as good as the RTC second. */
+
+/** Take the RTC and tick anchor that reading times are counted from */
+void tpms_clock_anchor(void);
+
+/** Get the current time from the tick, safe from any thread
+ *
+ * @param ms        - milliseconds past the returned second, may be NULL
+ * @return uint32_t - unix timestamp
+ */
+uint32_t tpms_clock_get_timestamp(uint16_t* ms);
@@ -5,10 +5,25 @@ typedef enum {
     TPMSCustomEventStartId = 100,
 
     TPMSCustomEventSceneSettingLock,
+    TPMSCustomEventSceneSearch,
 
     TPMSCustomEventViewReceiverOK,
     TPMSCustomEventViewReceiverConfig,
     TPMSCustomEventViewReceiverBack,
     TPMSCustomEventViewReceiverOffDisplay,
     TPMSCustomEventViewReceiverUnlock,
+    TPMSCustomEventViewReceiverSort,
+    TPMSCustomEventViewReceiverSearch,
+
+    TPMSCustomEventViewLogUp,
+    TPMSCustomEventViewLogDown,
+    TPMSCustomEventViewLogPageUp,
+    TPMSCustomEventViewLogPageDown,
+    TPMSCustomEventViewLogFirst,
+    TPMSCustomEventViewLogLast,
+    TPMSCustomEventViewLogFilter,
+
+    TPMSCustomEventBurstCaptured,
+    TPMSCustomEventTrafficBucket,
+    TPMSCustomEventSessionLogPending,
 } TPMSCustomEvent;
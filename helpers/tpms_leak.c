@@ -0,0 +1,124 @@
+#include "tpms_leak.h"
+
+#include <math.h>
+
+#define TAG "TPMSLeak"
+
+#define TPMS_LEAK_ATM_BAR 1.01325f
+#define TPMS_LEAK_KELVIN 273.15f
+
+typedef struct {
+    uint32_t start; // timestamp of the first reading, times are kept relative to it
+    uint16_t count;
+    bool alert;
+    float span; // seconds from the first reading to the last
+    float last_pressure;
+    // Running means and co-moments of time t and compensated pressure p
+    float mean_t;
+    float mean_p;
+    float c_tt;
+    float c_tp;
+    float c_pp;
+} TPMSLeakSensor;
+
+struct TPMSLeak {
+    uint16_t count;
+    TPMSLeakSensor* sensor;
+};
+
+TPMSLeak* tpms_leak_alloc(uint16_t count) {
+    TPMSLeak* instance = malloc(sizeof(TPMSLeak));
+    instance->count = count;
+    instance->sensor = malloc(count * sizeof(TPMSLeakSensor));
+    memset(instance->sensor, 0, count * sizeof(TPMSLeakSensor));
+    return instance;
+}
+
+void tpms_leak_free(TPMSLeak* instance) {
+    furi_assert(instance);
+    free(instance->sensor);
+    free(instance);
+}
+
+static float tpms_leak_compensate(float pressure, float temperature) {
+    // Gauge to absolute, scaled to the reference temperature, back to gauge
+    float absolute = pressure + TPMS_LEAK_ATM_BAR;
+    return absolute * (TPMS_LEAK_REF_C + TPMS_LEAK_KELVIN) / (temperature + TPMS_LEAK_KELVIN) -
+           TPMS_LEAK_ATM_BAR;
+}
+
+static bool tpms_leak_slope(const TPMSLeakSensor* sensor, float* slope, float* error) {
+    if(sensor->count < 3 || sensor->c_tt <= 0.0f) return false;
+    *slope = sensor->c_tp / sensor->c_tt;
+    float residual = sensor->c_pp - *slope * sensor->c_tp;
+    if(residual < 0.0f) residual = 0.0f;
+    *error = sqrtf(residual / (sensor->count - 2) / sensor->c_tt);
+    return true;
+}
+
+bool tpms_leak_feed(
+    TPMSLeak* instance,
+    uint16_t idx,
+    bool new_sensor,
+    uint32_t timestamp,
+    float pressure,
+    float temperature) {
+    furi_assert(instance);
+    if(idx >= instance->count) return false;
+    TPMSLeakSensor* sensor = &instance->sensor[idx];
+
+    float p = tpms_leak_compensate(pressure, temperature);
+    if(new_sensor || !sensor->count || p > sensor->last_pressure + TPMS_LEAK_REFILL_BAR ||
+       (int32_t)(timestamp - sensor->start) < 0) {
+        memset(sensor, 0, sizeof(TPMSLeakSensor));
+        sensor->start = timestamp;
+    }
+    sensor->last_pressure = p;
+
+    // Welford update: co-moments take the deviation before and after the mean moves
+    float t = timestamp - sensor->start;
+    sensor->count++;
+    float dt = t - sensor->mean_t;
+    float dp = p - sensor->mean_p;
+    sensor->mean_t += dt / sensor->count;
+    sensor->mean_p += dp / sensor->count;
+    sensor->c_tt += dt * (t - sensor->mean_t);
+    sensor->c_tp += dt * (p - sensor->mean_p);
+    sensor->c_pp += dp * (p - sensor->mean_p);
+    if(t > sensor->span) sensor->span = t;
+
+    float slope;
+    float error;
+    bool alert = false;
+    if(sensor->count >= TPMS_LEAK_MIN_READINGS && sensor->span >= TPMS_LEAK_MIN_SPAN_S &&
+       tpms_leak_slope(sensor, &slope, &error)) {
+        // Sensor steps are coarse, up to 0.17 bar. A single step down early on fits a steep
+        // slope, so the loss must also add up to more than a step and clear two errors
+        float loss = -slope * 3600.0f;
+        alert = loss >= TPMS_LEAK_ALERT_BAR_H && -slope > 2.0f * error &&
+                -slope * sensor->span >= TPMS_LEAK_MIN_DROP_BAR;
+    }
+    bool raised = alert && !sensor->alert;
+    sensor->alert = alert;
+    if(raised) FURI_LOG_I(TAG, "Leak on record %u", idx);
+    return raised;
+}
+
+bool tpms_leak_get_rate(TPMSLeak* instance, uint16_t idx, float* rate) {
+    furi_assert(instance);
+    furi_assert(rate);
+    if(idx >= instance->count) return false;
+    const TPMSLeakSensor* sensor = &instance->sensor[idx];
+    float slope;
+    float error;
+    if(sensor->count < TPMS_LEAK_MIN_READINGS || !tpms_leak_slope(sensor, &slope, &error)) {
+        return false;
+    }
+    *rate = -slope * 3600.0f;
+    return true;
+}
+
+bool tpms_leak_is_alert(TPMSLeak* instance, uint16_t idx) {
+    furi_assert(instance);
+    return idx < instance->count && instance->sensor[idx].alert;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <furi.h>
+
+/* Leak rate per sensor, the least squares slope of pressure over time. Pressure is scaled to
+ * TPMS_LEAK_REF_C by the ideal gas law first, so a tyre cooling down is not taken for a leak.
+ * Each reading updates running means and co-moments, O(1) and a few floats per sensor. */
+
+#define TPMS_LEAK_REF_C 20.0f
+#define TPMS_LEAK_ALERT_BAR_H 0.02f // loss that raises an alert, bar per hour
+#define TPMS_LEAK_MIN_READINGS 5
+#define TPMS_LEAK_MIN_SPAN_S (30 * 60) // readings must cover this before an alert
+#define TPMS_LEAK_MIN_DROP_BAR 0.2f // fitted loss over the readings, above one sensor step
+#define TPMS_LEAK_REFILL_BAR 0.2f // a rise this big restarts the estimate
+
+typedef struct TPMSLeak TPMSLeak;
+
+/** Allocate TPMSLeak
+ *
+ * @param count - number of sensors, one per history record
+ * @return TPMSLeak*
+ */
+TPMSLeak* tpms_leak_alloc(uint16_t count);
+
+/** Free TPMSLeak
+ *
+ * @param instance - TPMSLeak instance
+ */
+void tpms_leak_free(TPMSLeak* instance);
+
+/** Add a reading. Called from rx callback on worker thread
+ *
+ * @param instance      - TPMSLeak instance
+ * @param idx           - history record index
+ * @param new_sensor    - the record holds a new sensor, drop what was known
+ * @param timestamp     - reading time, seconds
+ * @param pressure      - gauge pressure, bar
+ * @param temperature   - temperature, celsius
+ * @return bool         - the sensor has just crossed the alert threshold
+ */
+bool tpms_leak_feed(
+    TPMSLeak* instance,
+    uint16_t idx,
+    bool new_sensor,
+    uint32_t timestamp,
+    float pressure,
+    float temperature);
+
+/** Get the leak rate of a sensor
+ *
+ * @param instance  - TPMSLeak instance
+ * @param idx       - history record index
+ * @param rate      - pressure loss, bar per hour, negative when pressure rises
+ * @return bool     - enough readings for an estimate
+ */
+bool tpms_leak_get_rate(TPMSLeak* instance, uint16_t idx, float* rate);
+
+/** Get alert state of a sensor
+ *
+ * @param instance  - TPMSLeak instance
+ * @param idx       - history record index
+ * @return bool     - leak rate is above TPMS_LEAK_ALERT_BAR_H
+ */
+bool tpms_leak_is_alert(TPMSLeak* instance, uint16_t idx);
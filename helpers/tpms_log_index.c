@@ -0,0 +1,331 @@
+#include "tpms_log_index.h"
+
+#define TAG "TPMSLogIndex"
+
+#define TPMS_LOG_INDEX_MAGIC 0x494C5054 // "TPLI"
+#define TPMS_LOG_INDEX_VERSION 4
+
+#define TPMS_LOG_INDEX_ENTRY_SIZE (sizeof(TPMSLogSegment) + sizeof(TPMSLogIdFilter))
+
+/** File header, followed by a TPMSLogSegment and its TPMSLogIdFilter per segment */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;
+} TPMSLogIndexHeader;
+
+struct TPMSLogIndex {
+    uint16_t count;
+    TPMSLogSegment segment[TPMS_LOG_INDEX_SEGMENTS_MAX];
+    // Filter of the newest segment, the others are only in the file
+    TPMSLogIdFilter filter;
+};
+
+static const TPMSLogIndexHeader tpms_log_index_header = {
+    .magic = TPMS_LOG_INDEX_MAGIC,
+    .version = TPMS_LOG_INDEX_VERSION,
+    .entry_size = TPMS_LOG_INDEX_ENTRY_SIZE,
+};
+
+static uint32_t tpms_log_index_offset(uint16_t i) {
+    return sizeof(TPMSLogIndexHeader) + i * TPMS_LOG_INDEX_ENTRY_SIZE;
+}
+
+TPMSLogIndex* tpms_log_index_alloc(void) {
+    TPMSLogIndex* instance = malloc(sizeof(TPMSLogIndex));
+    memset(instance, 0, sizeof(TPMSLogIndex));
+    return instance;
+}
+
+void tpms_log_index_free(TPMSLogIndex* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+static bool tpms_log_index_check_header(const TPMSLogIndexHeader* header) {
+    return header->magic == TPMS_LOG_INDEX_MAGIC && header->version == TPMS_LOG_INDEX_VERSION &&
+           header->entry_size == TPMS_LOG_INDEX_ENTRY_SIZE;
+}
+
+static bool tpms_log_index_read_header(File* file) {
+    TPMSLogIndexHeader header;
+    return storage_file_read(file, &header, sizeof(header)) == sizeof(header) &&
+           tpms_log_index_check_header(&header);
+}
+
+TPMSLogIndexLoad tpms_log_index_load(TPMSLogIndex* instance, Storage* storage, const char* path) {
+    furi_assert(instance);
+    File* file = storage_file_alloc(storage);
+    TPMSLogIndexLoad res = TPMSLogIndexLoadError;
+    instance->count = 0;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            if(!storage_file_exists(storage, path)) res = TPMSLogIndexLoadMissing;
+            break;
+        }
+        TPMSLogIndexHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(!tpms_log_index_check_header(&header)) {
+            FURI_LOG_W(TAG, "Incompatible index in %s, starting over", path);
+            res = TPMSLogIndexLoadIncompatible;
+            break;
+        }
+        // A torn last entry, from a write cut short, is left out
+        size_t count =
+            (storage_file_size(file) - sizeof(TPMSLogIndexHeader)) / TPMS_LOG_INDEX_ENTRY_SIZE;
+        count = MIN(count, (size_t)TPMS_LOG_INDEX_SEGMENTS_MAX);
+        size_t i = 0;
+        for(; i < count; i++) {
+            if(!storage_file_seek(file, tpms_log_index_offset(i), true) ||
+               storage_file_read(file, &instance->segment[i], sizeof(TPMSLogSegment)) !=
+                   sizeof(TPMSLogSegment)) {
+                break;
+            }
+        }
+        if(i < count) break;
+        // Right after the newest segment
+        if(count && storage_file_read(file, &instance->filter, sizeof(TPMSLogIdFilter)) !=
+                        sizeof(TPMSLogIdFilter)) {
+            break;
+        }
+        instance->count = count;
+        res = TPMSLogIndexLoadOk;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return res;
+}
+
+static bool tpms_log_index_contains(TPMSLogIndex* instance, const char* name) {
+    for(uint16_t i = 0; i < instance->count; i++) {
+        if(!strcmp(instance->segment[i].name, name)) return true;
+    }
+    return false;
+}
+
+// First .csv file in folder the index does not list
+static bool tpms_log_index_find_orphan(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* folder,
+    char* name) {
+    File* dir = storage_file_alloc(storage);
+    FileInfo info;
+    bool found = false;
+    if(storage_dir_open(dir, folder)) {
+        while(!found && storage_dir_read(dir, &info, name, TPMS_LOG_INDEX_NAME_LEN)) {
+            size_t len = strlen(name);
+            found = !file_info_is_dir(&info) && len > 4 && !strcmp(name + len - 4, ".csv") &&
+                    !tpms_log_index_contains(instance, name);
+        }
+    }
+    storage_dir_close(dir);
+    storage_file_free(dir);
+    return found;
+}
+
+uint16_t tpms_log_index_remove_orphans(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* folder) {
+    furi_assert(instance);
+    furi_assert(folder);
+    char name[TPMS_LOG_INDEX_NAME_LEN];
+    FuriString* file_path = furi_string_alloc();
+    uint16_t count = 0;
+
+    // Listed again after each delete, the folder is not changed while it is read
+    while(tpms_log_index_find_orphan(instance, storage, folder, name)) {
+        furi_string_printf(file_path, "%s/%s", folder, name);
+        if(!storage_simply_remove(storage, furi_string_get_cstr(file_path))) {
+            FURI_LOG_E(TAG, "Unable to remove %s", name);
+            break;
+        }
+        FURI_LOG_I(TAG, "Removed orphan %s", name);
+        count++;
+    }
+    furi_string_free(file_path);
+    return count;
+}
+
+uint16_t tpms_log_index_read_count(Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    size_t count = 0;
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       tpms_log_index_read_header(file)) {
+        count =
+            (storage_file_size(file) - sizeof(TPMSLogIndexHeader)) / TPMS_LOG_INDEX_ENTRY_SIZE;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    return MIN(count, (size_t)TPMS_LOG_INDEX_SEGMENTS_MAX);
+}
+
+bool tpms_log_index_read(
+    Storage* storage,
+    const char* path,
+    uint16_t i,
+    TPMSLogSegment* segment,
+    TPMSLogIdFilter* filter) {
+    furi_assert(segment);
+    File* file = storage_file_alloc(storage);
+    bool res = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+               tpms_log_index_read_header(file) &&
+               storage_file_seek(file, tpms_log_index_offset(i), true) &&
+               storage_file_read(file, segment, sizeof(TPMSLogSegment)) ==
+                   sizeof(TPMSLogSegment) &&
+               (!filter || storage_file_read(file, filter, sizeof(TPMSLogIdFilter)) ==
+                               sizeof(TPMSLogIdFilter));
+    storage_file_close(file);
+    storage_file_free(file);
+    return res;
+}
+
+// Bit n of an ID, by double hashing on two multiplicative hashes
+static uint16_t tpms_log_index_filter_bit(uint32_t id, uint8_t n) {
+    uint32_t h1 = id * 2654435769UL;
+    uint32_t h2 = ((id ^ (id >> 15)) * 2246822519UL) | 1;
+    return (h1 + n * h2) >> (32 - TPMS_LOG_INDEX_FILTER_ORDER);
+}
+
+void tpms_log_index_add_id(TPMSLogIndex* instance, uint32_t id) {
+    furi_assert(instance);
+    for(uint8_t n = 0; n < TPMS_LOG_INDEX_FILTER_HASHES; n++) {
+        uint16_t bit = tpms_log_index_filter_bit(id, n);
+        instance->filter.word[bit / 32] |= 1UL << (bit % 32);
+    }
+}
+
+bool tpms_log_index_filter_check(const TPMSLogIdFilter* filter, uint32_t id) {
+    furi_assert(filter);
+    for(uint8_t n = 0; n < TPMS_LOG_INDEX_FILTER_HASHES; n++) {
+        uint16_t bit = tpms_log_index_filter_bit(id, n);
+        if(!(filter->word[bit / 32] & (1UL << (bit % 32)))) return false;
+    }
+    return true;
+}
+
+uint16_t tpms_log_index_get_count(TPMSLogIndex* instance) {
+    furi_assert(instance);
+    return instance->count;
+}
+
+TPMSLogSegment* tpms_log_index_get(TPMSLogIndex* instance, uint16_t i) {
+    furi_assert(instance);
+    return i < instance->count ? &instance->segment[i] : NULL;
+}
+
+static bool tpms_log_index_write_entry(
+    File* file,
+    uint16_t i,
+    const TPMSLogSegment* segment,
+    const TPMSLogIdFilter* filter) {
+    return storage_file_seek(file, tpms_log_index_offset(i), true) &&
+           storage_file_write(file, segment, sizeof(TPMSLogSegment)) == sizeof(TPMSLogSegment) &&
+           storage_file_write(file, filter, sizeof(TPMSLogIdFilter)) == sizeof(TPMSLogIdFilter);
+}
+
+// Filters of the older segments are not in memory, they are written as unknown
+static bool tpms_log_index_save(TPMSLogIndex* instance, Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    TPMSLogIdFilter* unknown = malloc(sizeof(TPMSLogIdFilter));
+    memset(unknown, 0xFF, sizeof(TPMSLogIdFilter));
+    bool res = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        if(storage_file_write(file, &tpms_log_index_header, sizeof(tpms_log_index_header)) !=
+           sizeof(tpms_log_index_header)) {
+            break;
+        }
+        uint16_t i = 0;
+        for(; i < instance->count; i++) {
+            const TPMSLogIdFilter* filter = i + 1 < instance->count ? unknown : &instance->filter;
+            if(!tpms_log_index_write_entry(file, i, &instance->segment[i], filter)) break;
+        }
+        res = i == instance->count;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(unknown);
+    return res;
+}
+
+bool tpms_log_index_append(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* path,
+    const TPMSLogSegment* segment) {
+    furi_assert(instance);
+    furi_assert(segment);
+    furi_check(instance->count < TPMS_LOG_INDEX_SEGMENTS_MAX);
+    instance->segment[instance->count++] = *segment;
+    memset(&instance->filter, 0, sizeof(TPMSLogIdFilter));
+
+    // The whole index is written when the file is new or was not readable
+    if(instance->count == 1 || !storage_file_exists(storage, path)) {
+        return tpms_log_index_save(instance, storage, path);
+    }
+    return tpms_log_index_update_last(instance, storage, path);
+}
+
+// At the entry offset, not at the end of the file, so a torn entry is written over
+bool tpms_log_index_update_last(TPMSLogIndex* instance, Storage* storage, const char* path) {
+    furi_assert(instance);
+    if(!instance->count) return false;
+    uint16_t last = instance->count - 1;
+    File* file = storage_file_alloc(storage);
+    bool res = storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING) &&
+               tpms_log_index_write_entry(file, last, &instance->segment[last], &instance->filter);
+    storage_file_close(file);
+    storage_file_free(file);
+    return res;
+}
+
+bool tpms_log_index_remove_oldest(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* path,
+    const char* folder,
+    uint16_t count) {
+    furi_assert(instance);
+    furi_assert(folder);
+    count = MIN(count, instance->count);
+    if(!count) return true;
+
+    FuriString* file_path = furi_string_alloc();
+    for(uint16_t i = 0; i < count; i++) {
+        furi_string_printf(file_path, "%s/%s", folder, instance->segment[i].name);
+        // Already gone when it was deleted by hand
+        storage_simply_remove(storage, furi_string_get_cstr(file_path));
+        FURI_LOG_I(TAG, "Removed %s", instance->segment[i].name);
+    }
+    furi_string_free(file_path);
+
+    instance->count -= count;
+    memmove(
+        &instance->segment[0],
+        &instance->segment[count],
+        instance->count * sizeof(TPMSLogSegment));
+
+    // Entries move down in place, each filter read from its old entry
+    File* file = storage_file_alloc(storage);
+    TPMSLogIdFilter* filter = malloc(sizeof(TPMSLogIdFilter));
+    bool res = storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING);
+    for(uint16_t i = 0; res && i < instance->count; i++) {
+        res = storage_file_seek(
+                  file, tpms_log_index_offset(i + count) + sizeof(TPMSLogSegment), true) &&
+              storage_file_read(file, filter, sizeof(TPMSLogIdFilter)) ==
+                  sizeof(TPMSLogIdFilter) &&
+              tpms_log_index_write_entry(file, i, &instance->segment[i], filter);
+    }
+    res = res && storage_file_seek(file, tpms_log_index_offset(instance->count), true) &&
+          storage_file_truncate(file);
+    storage_file_close(file);
+    storage_file_free(file);
+    free(filter);
+    return res || tpms_log_index_save(instance, storage, path);
+}
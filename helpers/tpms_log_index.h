@@ -0,0 +1,169 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+/* Index of session log segments, oldest first. A header and one fixed size entry per segment,
+ * so a segment is added by an append, the one being written is kept up to date in place, and
+ * listing or dropping the oldest never reads a log. Each entry carries a Bloom filter of the
+ * sensor IDs in its segment, a search by ID skips the segments that cannot hold it. Filters
+ * stay in the file, only the one of the segment being written is kept in memory. */
+
+#define TPMS_LOG_INDEX_SEGMENTS_MAX 64
+#define TPMS_LOG_INDEX_NAME_LEN 32
+/* A full segment holds about 3500 rows from a few hundred sensors. With 4 hashes in 4096 bits,
+ * 200 IDs give 0.1% false positives, 500 IDs 2% */
+#define TPMS_LOG_INDEX_FILTER_ORDER 12
+#define TPMS_LOG_INDEX_FILTER_HASHES 4
+#define TPMS_LOG_INDEX_FILTER_WORDS ((1 << TPMS_LOG_INDEX_FILTER_ORDER) / 32)
+
+/** One segment, a CSV file in the log folder */
+typedef struct {
+    char name[TPMS_LOG_INDEX_NAME_LEN];
+    uint32_t session; // unix timestamp the session started
+    uint32_t start; // unix timestamp the segment started
+    uint32_t end; // timestamp of the last record
+    uint32_t records;
+    uint32_t size; // bytes
+} TPMSLogSegment;
+
+/** Sensor IDs in a segment. All bits set when they are not known */
+typedef struct {
+    uint32_t word[TPMS_LOG_INDEX_FILTER_WORDS];
+} TPMSLogIdFilter;
+
+typedef struct TPMSLogIndex TPMSLogIndex;
+
+typedef enum {
+    TPMSLogIndexLoadOk,
+    TPMSLogIndexLoadMissing, // no index file
+    TPMSLogIndexLoadIncompatible, // written by another version, its segments are unknown
+    TPMSLogIndexLoadError,
+} TPMSLogIndexLoad;
+
+/** Allocate TPMSLogIndex, empty
+ *
+ * @return TPMSLogIndex*
+ */
+TPMSLogIndex* tpms_log_index_alloc(void);
+
+/** Free TPMSLogIndex
+ *
+ * @param instance - TPMSLogIndex instance
+ */
+void tpms_log_index_free(TPMSLogIndex* instance);
+
+/** Read the index file, the index is empty unless it was read
+ *
+ * @param instance          - TPMSLogIndex instance
+ * @param storage           - Storage instance
+ * @param path              - index file path
+ * @return TPMSLogIndexLoad - result
+ */
+TPMSLogIndexLoad tpms_log_index_load(TPMSLogIndex* instance, Storage* storage, const char* path);
+
+/** Delete the segment files in folder that the index does not list. Any .csv file there is
+ * taken for a segment
+ *
+ * @param instance  - TPMSLogIndex instance
+ * @param storage   - Storage instance
+ * @param folder    - folder of the segment files
+ * @return uint16_t - files deleted
+ */
+uint16_t tpms_log_index_remove_orphans(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* folder);
+
+/** Read the number of segments from the index file, without loading it
+ *
+ * @param storage   - Storage instance
+ * @param path      - index file path
+ * @return uint16_t - segments, 0 when there is no index
+ */
+uint16_t tpms_log_index_read_count(Storage* storage, const char* path);
+
+/** Read one segment from the index file, without loading it
+ *
+ * @param storage   - Storage instance
+ * @param path      - index file path
+ * @param i         - segment number, 0 is the oldest
+ * @param segment   - segment read
+ * @param filter    - its ID filter, NULL when not wanted
+ * @return bool     - segment was read
+ */
+bool tpms_log_index_read(
+    Storage* storage,
+    const char* path,
+    uint16_t i,
+    TPMSLogSegment* segment,
+    TPMSLogIdFilter* filter);
+
+/** Add a sensor ID to the filter of the newest segment
+ *
+ * @param instance  - TPMSLogIndex instance
+ * @param id        - sensor id
+ */
+void tpms_log_index_add_id(TPMSLogIndex* instance, uint32_t id);
+
+/** Check a sensor ID against the filter of a segment
+ *
+ * @param filter    - TPMSLogIdFilter
+ * @param id        - sensor id
+ * @return bool     - segment may hold the ID, false when it surely does not
+ */
+bool tpms_log_index_filter_check(const TPMSLogIdFilter* filter, uint32_t id);
+
+/** Get number of segments
+ *
+ * @param instance  - TPMSLogIndex instance
+ * @return uint16_t - segments
+ */
+uint16_t tpms_log_index_get_count(TPMSLogIndex* instance);
+
+/** Get a segment, 0 is the oldest
+ *
+ * @param instance          - TPMSLogIndex instance
+ * @param i                 - segment number
+ * @return TPMSLogSegment*  - segment, NULL when out of range
+ */
+TPMSLogSegment* tpms_log_index_get(TPMSLogIndex* instance, uint16_t i);
+
+/** Add a segment after the newest, with an empty filter. The index must not be full
+ *
+ * @param instance  - TPMSLogIndex instance
+ * @param storage   - Storage instance
+ * @param path      - index file path
+ * @param segment   - new segment
+ * @return bool     - index file was written
+ */
+bool tpms_log_index_append(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* path,
+    const TPMSLogSegment* segment);
+
+/** Write the newest segment and its filter over its entry in the index file
+ *
+ * @param instance  - TPMSLogIndex instance
+ * @param storage   - Storage instance
+ * @param path      - index file path
+ * @return bool     - index file was written
+ */
+bool tpms_log_index_update_last(TPMSLogIndex* instance, Storage* storage, const char* path);
+
+/** Delete the oldest segments with their files and rewrite the index file
+ *
+ * @param instance  - TPMSLogIndex instance
+ * @param storage   - Storage instance
+ * @param path      - index file path
+ * @param folder    - folder of the segment files
+ * @param count     - segments to delete
+ * @return bool     - index file was written
+ */
+bool tpms_log_index_remove_oldest(
+    TPMSLogIndex* instance,
+    Storage* storage,
+    const char* path,
+    const char* folder,
+    uint16_t count);
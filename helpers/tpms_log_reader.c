@@ -0,0 +1,364 @@
+#include "tpms_log_reader.h"
+#include "tpms_types.h"
+
+#include <storage/storage.h>
+
+#define TAG "TPMSLogReader"
+
+#define TPMS_LOG_READER_CACHE_ROWS 8
+// Rows a segment can hold, a flush may take it a queue of records past the size limit
+#define TPMS_LOG_READER_MATCH_ROWS (TPMS_SESSION_LOG_SEGMENT_SIZE / TPMS_SESSION_LOG_ROW_LEN + 64)
+
+typedef struct {
+    uint16_t segment;
+    uint32_t row;
+} TPMSLogReaderCursor;
+
+struct TPMSLogReader {
+    uint16_t segments;
+    TPMSLogReaderCursor top;
+    bool filter;
+    uint32_t id;
+
+    // Index entry of the segment last read with its ID filter, and an aligned run of its rows
+    bool loaded;
+    uint16_t segment_idx;
+    TPMSLogSegment segment;
+    TPMSLogIdFilter id_filter;
+    FuriString* path;
+    uint32_t cache_row;
+    uint8_t cache_count;
+    char cache[TPMS_LOG_READER_CACHE_ROWS * TPMS_SESSION_LOG_ROW_LEN];
+
+    // Rows of the filtered ID in one segment, a bit per row, found in one pass over the file.
+    // Paging through the matches then reads only the rows shown
+    uint32_t match_id;
+    char match_name[TPMS_LOG_INDEX_NAME_LEN];
+    uint32_t match_rows; // rows looked at so far
+    uint32_t match_records; // segment records when last looked, a short file is not read again
+    uint32_t match[(TPMS_LOG_READER_MATCH_ROWS + 31) / 32];
+};
+
+TPMSLogReader* tpms_log_reader_alloc(void) {
+    TPMSLogReader* instance = malloc(sizeof(TPMSLogReader));
+    memset(instance, 0, sizeof(TPMSLogReader));
+    instance->path = furi_string_alloc();
+    return instance;
+}
+
+void tpms_log_reader_free(TPMSLogReader* instance) {
+    furi_assert(instance);
+    furi_string_free(instance->path);
+    free(instance);
+}
+
+static bool tpms_log_reader_load(TPMSLogReader* instance, uint16_t segment) {
+    if(instance->loaded && instance->segment_idx == segment) return true;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    instance->loaded = tpms_log_index_read(
+        storage, TPMS_SESSION_LOG_INDEX, segment, &instance->segment, &instance->id_filter);
+    furi_record_close(RECORD_STORAGE);
+    if(!instance->loaded) {
+        FURI_LOG_E(TAG, "Unable to read segment %u", segment);
+        return false;
+    }
+    instance->segment_idx = segment;
+    instance->cache_count = 0;
+    furi_string_printf(instance->path, TPMS_SESSION_LOG_FOLDER "/%s", instance->segment.name);
+    return true;
+}
+
+static uint32_t tpms_log_reader_rows(TPMSLogReader* instance, uint16_t segment) {
+    if(segment >= instance->segments) return 0;
+    return tpms_log_reader_load(instance, segment) ? instance->segment.records : 0;
+}
+
+// Rows are read a cache at a time, the file is closed again so the log can still be written
+static const char* tpms_log_reader_row(TPMSLogReader* instance, TPMSLogReaderCursor cursor) {
+    if(!tpms_log_reader_load(instance, cursor.segment)) return NULL;
+    if(cursor.row < instance->cache_row ||
+       cursor.row >= instance->cache_row + instance->cache_count) {
+        instance->cache_row = cursor.row - cursor.row % TPMS_LOG_READER_CACHE_ROWS;
+        instance->cache_count = 0;
+
+        Storage* storage = furi_record_open(RECORD_STORAGE);
+        File* file = storage_file_alloc(storage);
+        uint32_t offset =
+            TPMS_SESSION_LOG_HEADER_LEN + instance->cache_row * TPMS_SESSION_LOG_ROW_LEN;
+        if(storage_file_open(
+               file, furi_string_get_cstr(instance->path), FSAM_READ, FSOM_OPEN_EXISTING) &&
+           storage_file_seek(file, offset, true)) {
+            size_t size = storage_file_read(file, instance->cache, sizeof(instance->cache));
+            instance->cache_count = size / TPMS_SESSION_LOG_ROW_LEN;
+        }
+        storage_file_close(file);
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+    }
+    if(cursor.row >= instance->cache_row + instance->cache_count) return NULL;
+    return &instance->cache[(cursor.row - instance->cache_row) * TPMS_SESSION_LOG_ROW_LEN];
+}
+
+static bool tpms_log_reader_get(
+    TPMSLogReader* instance,
+    TPMSLogReaderCursor cursor,
+    TPMSSessionLogRecord* record) {
+    const char* row = tpms_log_reader_row(instance, cursor);
+    // Rows are not terminated, the parser stops at the newline
+    return row && row[TPMS_SESSION_LOG_ROW_LEN - 1] == '\n' &&
+           tpms_session_log_parse(row, record);
+}
+
+// A segment is worth opening when it has rows and may hold the filtered ID
+static bool tpms_log_reader_segment_usable(TPMSLogReader* instance, uint16_t segment) {
+    if(!tpms_log_reader_rows(instance, segment)) return false;
+    return !instance->filter || tpms_log_index_filter_check(&instance->id_filter, instance->id);
+}
+
+/* Marks the rows of the filtered ID in the loaded segment, from the first row not looked at
+ * yet, so rows the log gained are added on. The file is opened once and read through the row
+ * cache, only the ID column of each row is parsed */
+static void tpms_log_reader_scan(TPMSLogReader* instance) {
+    if(instance->match_id != instance->id ||
+       strcmp(instance->match_name, instance->segment.name)) {
+        instance->match_id = instance->id;
+        strlcpy(instance->match_name, instance->segment.name, sizeof(instance->match_name));
+        instance->match_rows = 0;
+        instance->match_records = 0;
+        memset(instance->match, 0, sizeof(instance->match));
+    }
+    uint32_t rows = MIN(instance->segment.records, (uint32_t)TPMS_LOG_READER_MATCH_ROWS);
+    if(instance->match_rows >= rows || instance->match_records == instance->segment.records) {
+        return;
+    }
+    instance->match_records = instance->segment.records;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint32_t offset =
+        TPMS_SESSION_LOG_HEADER_LEN + instance->match_rows * TPMS_SESSION_LOG_ROW_LEN;
+    instance->cache_count = 0;
+    if(storage_file_open(
+           file, furi_string_get_cstr(instance->path), FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_seek(file, offset, true)) {
+        while(instance->match_rows < rows) {
+            size_t size = storage_file_read(file, instance->cache, sizeof(instance->cache));
+            uint32_t count = MIN(size / TPMS_SESSION_LOG_ROW_LEN, rows - instance->match_rows);
+            if(!count) break;
+            for(uint32_t i = 0; i < count; i++) {
+                const char* row = &instance->cache[i * TPMS_SESSION_LOG_ROW_LEN];
+                uint32_t n = instance->match_rows++;
+                if(row[TPMS_SESSION_LOG_ROW_LEN - 1] == '\n' &&
+                   strtoul(row + TPMS_SESSION_LOG_ID_OFFSET, NULL, 16) == instance->id) {
+                    instance->match[n / 32] |= 1UL << (n % 32);
+                }
+            }
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool tpms_log_reader_match(TPMSLogReader* instance, TPMSLogReaderCursor cursor) {
+    if(cursor.segment >= instance->segments) return false;
+    if(cursor.row >= tpms_log_reader_rows(instance, cursor.segment)) return false;
+    if(!instance->filter) return true;
+    if(!tpms_log_index_filter_check(&instance->id_filter, instance->id)) return false;
+    if(cursor.row >= TPMS_LOG_READER_MATCH_ROWS) {
+        // Past what a segment should hold, checked row by row
+        TPMSSessionLogRecord record;
+        return tpms_log_reader_get(instance, cursor, &record) && record.id == instance->id;
+    }
+    tpms_log_reader_scan(instance);
+    return instance->match[cursor.row / 32] & (1UL << (cursor.row % 32));
+}
+
+// Next or previous row, across segments. False past either end
+static bool tpms_log_reader_step(
+    TPMSLogReader* instance,
+    TPMSLogReaderCursor* cursor,
+    bool forward) {
+    if(forward) {
+        if(cursor->row + 1 < tpms_log_reader_rows(instance, cursor->segment)) {
+            cursor->row++;
+            return true;
+        }
+        for(uint16_t segment = cursor->segment + 1; segment < instance->segments; segment++) {
+            if(tpms_log_reader_segment_usable(instance, segment)) {
+                *cursor = (TPMSLogReaderCursor){segment, 0};
+                return true;
+            }
+        }
+    } else {
+        if(cursor->row > 0) {
+            cursor->row--;
+            return true;
+        }
+        for(uint16_t segment = cursor->segment; segment-- > 0;) {
+            if(tpms_log_reader_segment_usable(instance, segment)) {
+                *cursor = (TPMSLogReaderCursor){segment, instance->segment.records - 1};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool tpms_log_reader_seek(
+    TPMSLogReader* instance,
+    TPMSLogReaderCursor* cursor,
+    bool forward) {
+    TPMSLogReaderCursor next = *cursor;
+    while(!tpms_log_reader_match(instance, next)) {
+        // A segment the filter rules out is passed over whole, not row by row
+        if(!tpms_log_reader_segment_usable(instance, next.segment)) {
+            uint32_t rows = tpms_log_reader_rows(instance, next.segment);
+            next.row = forward && rows ? rows - 1 : 0;
+        }
+        if(!tpms_log_reader_step(instance, &next, forward)) return false;
+    }
+    *cursor = next;
+    return true;
+}
+
+/* Reads the segment count and the entry of the segment last read again, the log may have
+ * grown since. False when it did not. Rotation may also have dropped the oldest segments, the
+ * others then have new numbers and the top row goes back to the first row */
+static bool tpms_log_reader_refresh(TPMSLogReader* instance) {
+    uint16_t segments = instance->segments;
+    bool loaded = instance->loaded;
+    uint16_t segment = instance->segment_idx;
+    uint32_t records = instance->segment.records;
+    char name[TPMS_LOG_INDEX_NAME_LEN];
+    strlcpy(name, instance->segment.name, sizeof(name));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    instance->segments = tpms_log_index_read_count(storage, TPMS_SESSION_LOG_INDEX);
+    furi_record_close(RECORD_STORAGE);
+    instance->loaded = false;
+    if(!loaded) return instance->segments != segments;
+
+    tpms_log_reader_rows(instance, segment);
+    if(!instance->loaded || strcmp(name, instance->segment.name)) {
+        FURI_LOG_I(TAG, "Segments rotated");
+        tpms_log_reader_first(instance);
+        return false;
+    }
+    return instance->segments != segments || instance->segment.records != records;
+}
+
+// Next row that matches. At the end the index is read again, once per call of the caller
+static bool tpms_log_reader_next(
+    TPMSLogReader* instance,
+    TPMSLogReaderCursor* cursor,
+    bool* refreshed) {
+    TPMSLogReaderCursor next = *cursor;
+    if(tpms_log_reader_step(instance, &next, true) &&
+       tpms_log_reader_seek(instance, &next, true)) {
+        *cursor = next;
+        return true;
+    }
+    if(*refreshed) return false;
+    *refreshed = true;
+    if(!tpms_log_reader_refresh(instance)) return false;
+    next = *cursor;
+    if(tpms_log_reader_step(instance, &next, true) &&
+       tpms_log_reader_seek(instance, &next, true)) {
+        *cursor = next;
+        return true;
+    }
+    return false;
+}
+
+bool tpms_log_reader_open(TPMSLogReader* instance) {
+    furi_assert(instance);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    instance->segments = tpms_log_index_read_count(storage, TPMS_SESSION_LOG_INDEX);
+    furi_record_close(RECORD_STORAGE);
+    instance->loaded = false;
+    instance->filter = false;
+    tpms_log_reader_first(instance);
+    return instance->segments > 0;
+}
+
+void tpms_log_reader_set_filter(TPMSLogReader* instance, bool enabled, uint32_t id) {
+    furi_assert(instance);
+    instance->filter = enabled;
+    instance->id = id;
+    if(!tpms_log_reader_seek(instance, &instance->top, true)) {
+        tpms_log_reader_seek(instance, &instance->top, false);
+    }
+}
+
+bool tpms_log_reader_get_filter(TPMSLogReader* instance, uint32_t* id) {
+    furi_assert(instance);
+    if(id) *id = instance->id;
+    return instance->filter;
+}
+
+bool tpms_log_reader_move(TPMSLogReader* instance, int32_t rows) {
+    furi_assert(instance);
+    bool forward = rows > 0;
+    bool moved = false;
+    bool refreshed = false;
+    for(int32_t i = 0; i < abs(rows); i++) {
+        TPMSLogReaderCursor next = instance->top;
+        if(forward) {
+            if(!tpms_log_reader_next(instance, &next, &refreshed)) break;
+        } else if(
+            !tpms_log_reader_step(instance, &next, false) ||
+            !tpms_log_reader_seek(instance, &next, false)) {
+            break;
+        }
+        instance->top = next;
+        moved = true;
+    }
+    return moved;
+}
+
+void tpms_log_reader_first(TPMSLogReader* instance) {
+    furi_assert(instance);
+    instance->top = (TPMSLogReaderCursor){0, 0};
+    tpms_log_reader_seek(instance, &instance->top, true);
+}
+
+void tpms_log_reader_last(TPMSLogReader* instance, uint8_t page) {
+    furi_assert(instance);
+    tpms_log_reader_refresh(instance);
+    if(!instance->segments) return;
+    uint16_t segment = instance->segments - 1;
+    uint32_t rows = tpms_log_reader_rows(instance, segment);
+    instance->top = (TPMSLogReaderCursor){segment, rows ? rows - 1 : 0};
+    tpms_log_reader_seek(instance, &instance->top, false);
+    if(page > 1) tpms_log_reader_move(instance, 1 - page);
+}
+
+uint8_t tpms_log_reader_read(
+    TPMSLogReader* instance,
+    TPMSSessionLogRecord* records,
+    uint8_t count) {
+    furi_assert(instance);
+    furi_assert(records);
+    TPMSLogReaderCursor cursor = instance->top;
+    uint8_t read = 0;
+    bool refreshed = false;
+    if(!tpms_log_reader_match(instance, cursor)) return 0;
+    do {
+        if(tpms_log_reader_get(instance, cursor, &records[read])) read++;
+    } while(read < count && tpms_log_reader_next(instance, &cursor, &refreshed));
+    return read;
+}
+
+void tpms_log_reader_get_position(
+    TPMSLogReader* instance,
+    uint16_t* segment,
+    uint16_t* segments,
+    uint32_t* row,
+    uint32_t* rows) {
+    furi_assert(instance);
+    *segment = instance->top.segment;
+    *segments = instance->segments;
+    *row = instance->top.row;
+    *rows = tpms_log_reader_rows(instance, instance->top.segment);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <furi.h>
+#include "tpms_session_log.h"
+
+/* Pages through the session log segments listed in the index, oldest first. Rows have a fixed
+ * length, so any row is one seek away and only the rows shown are read, a few at a time. With
+ * a sensor ID filter, segments whose index filter rules the ID out are never opened, and a
+ * segment is read once to find its matching rows. Paging past the end reads the index again,
+ * so rows logged meanwhile show up. Memory use does not depend on the size of the log. */
+
+typedef struct TPMSLogReader TPMSLogReader;
+
+/** Allocate TPMSLogReader
+ *
+ * @return TPMSLogReader*
+ */
+TPMSLogReader* tpms_log_reader_alloc(void);
+
+/** Free TPMSLogReader
+ *
+ * @param instance - TPMSLogReader instance
+ */
+void tpms_log_reader_free(TPMSLogReader* instance);
+
+/** Read the segment count from the index and go to the first row, the filter is cleared
+ *
+ * @param instance  - TPMSLogReader instance
+ * @return bool     - there are segments
+ */
+bool tpms_log_reader_open(TPMSLogReader* instance);
+
+/** Show only the rows of one sensor, the top row moves to the nearest one that matches
+ *
+ * @param instance  - TPMSLogReader instance
+ * @param enabled   - filter state
+ * @param id        - sensor id
+ */
+void tpms_log_reader_set_filter(TPMSLogReader* instance, bool enabled, uint32_t id);
+
+/** Get filter state
+ *
+ * @param instance  - TPMSLogReader instance
+ * @param id        - sensor id, when filtered
+ * @return bool     - is filtered
+ */
+bool tpms_log_reader_get_filter(TPMSLogReader* instance, uint32_t* id);
+
+/** Move the top row by a number of rows, stopping at either end
+ *
+ * @param instance  - TPMSLogReader instance
+ * @param rows      - rows, negative to go back
+ * @return bool     - top row moved
+ */
+bool tpms_log_reader_move(TPMSLogReader* instance, int32_t rows);
+
+/** Go to the first row
+ *
+ * @param instance - TPMSLogReader instance
+ */
+void tpms_log_reader_first(TPMSLogReader* instance);
+
+/** Go to the last page
+ *
+ * @param instance  - TPMSLogReader instance
+ * @param page      - rows per page
+ */
+void tpms_log_reader_last(TPMSLogReader* instance, uint8_t page);
+
+/** Read rows from the top row on
+ *
+ * @param instance  - TPMSLogReader instance
+ * @param records   - records read
+ * @param count     - rows wanted
+ * @return uint8_t  - rows read, fewer at the end of the log
+ */
+uint8_t tpms_log_reader_read(
+    TPMSLogReader* instance,
+    TPMSSessionLogRecord* records,
+    uint8_t count);
+
+/** Get where the top row is
+ *
+ * @param instance  - TPMSLogReader instance
+ * @param segment   - segment number, 0 is the oldest
+ * @param segments  - number of segments
+ * @param row       - row in the segment
+ * @param rows      - rows in the segment
+ */
+void tpms_log_reader_get_position(
+    TPMSLogReader* instance,
+    uint16_t* segment,
+    uint16_t* segments,
+    uint32_t* row,
+    uint32_t* rows);
@@ -0,0 +1,277 @@
+#include "tpms_session_log.h"
+#include "tpms_types.h"
+
+#include <storage/storage.h>
+
+#define TAG "TPMSSessionLog"
+
+#define TPMS_SESSION_LOG_QUEUE_SIZE 32
+
+struct TPMSSessionLog {
+    volatile bool enabled;
+    volatile bool flush_pending; // set by feed, cleared when save_pending takes over
+    uint32_t dropped;
+
+    // Segments and index are only touched by tpms_session_log_save_pending, on main thread
+    TPMSLogIndex* index;
+    bool index_loaded;
+    bool segment_open; // the newest segment in the index is the one written to
+    uint32_t session;
+    FuriString* path;
+    FuriMessageQueue* queue;
+};
+
+TPMSSessionLog* tpms_session_log_alloc(void) {
+    TPMSSessionLog* instance = malloc(sizeof(TPMSSessionLog));
+    memset(instance, 0, sizeof(TPMSSessionLog));
+    instance->path = furi_string_alloc();
+    instance->index = tpms_log_index_alloc();
+    instance->queue =
+        furi_message_queue_alloc(TPMS_SESSION_LOG_QUEUE_SIZE, sizeof(TPMSSessionLogRecord));
+    return instance;
+}
+
+void tpms_session_log_free(TPMSSessionLog* instance) {
+    furi_assert(instance);
+    tpms_session_log_save_pending(instance);
+    furi_message_queue_free(instance->queue);
+    tpms_log_index_free(instance->index);
+    furi_string_free(instance->path);
+    free(instance);
+}
+
+void tpms_session_log_set_enabled(TPMSSessionLog* instance, bool enabled) {
+    furi_assert(instance);
+    if(enabled && !instance->enabled) {
+        // Records of the previous session go to its own segments
+        tpms_session_log_save_pending(instance);
+        instance->segment_open = false;
+        instance->session = 0;
+    }
+    instance->enabled = enabled;
+}
+
+bool tpms_session_log_is_enabled(TPMSSessionLog* instance) {
+    furi_assert(instance);
+    return instance->enabled;
+}
+
+bool tpms_session_log_feed(
+    TPMSSessionLog* instance,
+    const char* protocol,
+    const TPMSBlockGeneric* generic,
+    uint32_t frequency) {
+    furi_assert(instance);
+    furi_assert(protocol);
+    furi_assert(generic);
+    if(!instance->enabled) return false;
+
+    TPMSSessionLogRecord record = {
+        .timestamp = generic->timestamp,
+        .timestamp_ms = generic->timestamp_ms,
+        .id = generic->id,
+        .frequency = frequency,
+        .pressure = generic->pressure,
+        .temperature = generic->temperature,
+        .rssi = generic->rssi,
+        .battery_low = generic->battery_low,
+        .mode = generic->mode,
+        .alarm = generic->alarm,
+    };
+    strlcpy(record.protocol, protocol, sizeof(record.protocol));
+
+    if(furi_message_queue_put(instance->queue, &record, 0) != FuriStatusOk) {
+        instance->dropped++;
+    }
+    // One flush request at a time, the rest ride along with it. Records a failed flush left
+    // behind ask again with the next frame
+    if(instance->flush_pending || !furi_message_queue_get_count(instance->queue)) return false;
+    instance->flush_pending = true;
+    return true;
+}
+
+// Fixed width, so row n of a segment starts at a known offset. Numbers are zero padded and
+// clamped to their width, the protocol is padded with spaces
+static void tpms_session_log_format(const TPMSSessionLogRecord* record, char* row) {
+    snprintf(
+        row,
+        TPMS_SESSION_LOG_ROW_LEN + 1,
+        "%010lu.%03u,%-15.15s,%08lX,%06.2f,%04.0f,%u,%u,%u,%04.0f,%09lu\n",
+        record->timestamp,
+        MIN(record->timestamp_ms, 999),
+        record->protocol,
+        record->id,
+        (double)CLAMP(record->pressure, 999.99f, 0.0f),
+        (double)CLAMP(record->temperature, 999.0f, -99.0f),
+        MIN(record->battery_low, 9),
+        MIN(record->mode, 9),
+        record->alarm,
+        (double)CLAMP(record->rssi, 0.0f, -999.0f),
+        MIN(record->frequency, 999999999UL));
+}
+
+bool tpms_session_log_parse(const char* row, TPMSSessionLogRecord* record) {
+    furi_assert(row);
+    furi_assert(record);
+    unsigned timestamp_ms = 0;
+    unsigned battery_low = 0;
+    unsigned mode = 0;
+    unsigned alarm = 0;
+    if(sscanf(
+           row,
+           "%lu.%u,%15[^,],%lx,%f,%f,%u,%u,%u,%f,%lu",
+           &record->timestamp,
+           &timestamp_ms,
+           record->protocol,
+           &record->id,
+           &record->pressure,
+           &record->temperature,
+           &battery_low,
+           &mode,
+           &alarm,
+           &record->rssi,
+           &record->frequency) != 11) {
+        return false;
+    }
+    for(size_t len = strlen(record->protocol); len && record->protocol[len - 1] == ' ';) {
+        record->protocol[--len] = '\0';
+    }
+    record->timestamp_ms = timestamp_ms;
+    record->battery_low = battery_low;
+    record->mode = mode;
+    record->alarm = alarm;
+    return true;
+}
+
+// Start a new segment, first dropping the oldest ones past the retention limits
+static TPMSLogSegment* tpms_session_log_rotate(TPMSSessionLog* instance, Storage* storage) {
+    TPMSLogIndex* index = instance->index;
+    uint16_t count = tpms_log_index_get_count(index);
+    uint64_t total = 0;
+    for(uint16_t i = 0; i < count; i++) {
+        total += tpms_log_index_get(index, i)->size;
+    }
+    // Room for the new segment at its full size
+    uint16_t remove = 0;
+    while(remove < count &&
+          (count - remove >= TPMS_SESSION_LOG_SEGMENTS_MAX ||
+           total + TPMS_SESSION_LOG_SEGMENT_SIZE > TPMS_SESSION_LOG_BYTES_MAX)) {
+        total -= tpms_log_index_get(index, remove)->size;
+        remove++;
+    }
+    if(remove) {
+        tpms_log_index_remove_oldest(
+            index, storage, TPMS_SESSION_LOG_INDEX, TPMS_SESSION_LOG_FOLDER, remove);
+    }
+
+    DateTime dt;
+    furi_hal_rtc_get_datetime(&dt);
+    TPMSLogSegment segment = {
+        .start = datetime_datetime_to_timestamp(&dt),
+    };
+    snprintf(
+        segment.name,
+        sizeof(segment.name),
+        "session_%04u%02u%02u_%02u%02u%02u.csv",
+        dt.year,
+        dt.month,
+        dt.day,
+        dt.hour,
+        dt.minute,
+        dt.second);
+    if(!instance->session) instance->session = segment.start;
+    segment.session = instance->session;
+    segment.end = segment.start;
+
+    // Started within the same second as the newest, which keeps both names and records
+    count = tpms_log_index_get_count(index);
+    TPMSLogSegment* last = tpms_log_index_get(index, count - 1);
+    if(!last || strcmp(last->name, segment.name)) {
+        tpms_log_index_append(index, storage, TPMS_SESSION_LOG_INDEX, &segment);
+        last = tpms_log_index_get(index, count);
+    }
+    instance->segment_open = true;
+    return last;
+}
+
+bool tpms_session_log_save_pending(TPMSSessionLog* instance) {
+    furi_assert(instance);
+    // Before the queue is read, so a record queued from now on asks for another flush
+    instance->flush_pending = false;
+    if(furi_message_queue_get_count(instance->queue) == 0) return true;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+    storage_simply_mkdir(storage, TPMS_APP_FOLDER);
+    storage_simply_mkdir(storage, TPMS_SESSION_LOG_FOLDER);
+
+    if(!instance->index_loaded) {
+        if(tpms_log_index_load(instance->index, storage, TPMS_SESSION_LOG_INDEX) ==
+           TPMSLogIndexLoadIncompatible) {
+            // Segments of the old index would never be counted against the limits
+            tpms_log_index_remove_orphans(instance->index, storage, TPMS_SESSION_LOG_FOLDER);
+        }
+        instance->index_loaded = true;
+    }
+    TPMSLogSegment* segment = NULL;
+    if(instance->segment_open) {
+        segment = tpms_log_index_get(
+            instance->index, tpms_log_index_get_count(instance->index) - 1);
+    }
+    if(!segment || segment->size >= TPMS_SESSION_LOG_SEGMENT_SIZE ||
+       furi_hal_rtc_get_timestamp() - segment->start >= TPMS_SESSION_LOG_SEGMENT_S) {
+        segment = tpms_session_log_rotate(instance, storage);
+    }
+    furi_string_printf(instance->path, TPMS_SESSION_LOG_FOLDER "/%s", segment->name);
+
+    File* file = storage_file_alloc(storage);
+    char row[TPMS_SESSION_LOG_ROW_LEN + 1];
+    bool saved = false;
+
+    do {
+        if(!storage_file_open(
+               file, furi_string_get_cstr(instance->path), FSAM_WRITE, FSOM_OPEN_APPEND)) {
+            FURI_LOG_E(TAG, "Unable to open %s", furi_string_get_cstr(instance->path));
+            break;
+        }
+        uint64_t size = storage_file_size(file);
+        if(size < TPMS_SESSION_LOG_HEADER_LEN) {
+            // New, or its header was cut short
+            storage_file_seek(file, 0, true);
+            storage_file_truncate(file);
+            size = storage_file_write(file, TPMS_SESSION_LOG_HEADER, TPMS_SESSION_LOG_HEADER_LEN);
+        }
+
+        saved = size >= TPMS_SESSION_LOG_HEADER_LEN;
+        TPMSSessionLogRecord record;
+        while(saved && furi_message_queue_get(instance->queue, &record, 0) == FuriStatusOk) {
+            tpms_session_log_format(&record, row);
+            if(storage_file_write(file, row, TPMS_SESSION_LOG_ROW_LEN) !=
+               TPMS_SESSION_LOG_ROW_LEN) {
+                // Cut back to the last whole row, rows are found by their offset. The record
+                // is lost, the rest stay queued for the next flush
+                FURI_LOG_E(TAG, "Write error in %s", furi_string_get_cstr(instance->path));
+                storage_file_seek(file, size, true);
+                storage_file_truncate(file);
+                saved = false;
+                break;
+            }
+            size += TPMS_SESSION_LOG_ROW_LEN;
+            segment->records++;
+            segment->end = record.timestamp;
+            tpms_log_index_add_id(instance->index, record.id);
+        }
+        segment->size = storage_file_size(file);
+    } while(false);
+
+    if(instance->dropped) {
+        FURI_LOG_W(TAG, "%lu records dropped, queue full", instance->dropped);
+        instance->dropped = 0;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    tpms_log_index_update_last(instance->index, storage, TPMS_SESSION_LOG_INDEX);
+    furi_record_close(RECORD_STORAGE);
+    return saved;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+#include "../protocols/tpms_generic.h"
+#include "tpms_log_index.h"
+
+#define TPMS_SESSION_LOG_FOLDER TPMS_APP_FOLDER "/log"
+#define TPMS_SESSION_LOG_INDEX TPMS_SESSION_LOG_FOLDER "/index.bin"
+// A session is split into segments of at most this size or age, oldest deleted past the limits
+#define TPMS_SESSION_LOG_SEGMENT_SIZE (256 * 1024)
+#define TPMS_SESSION_LOG_SEGMENT_S (60 * 60)
+#define TPMS_SESSION_LOG_SEGMENTS_MAX TPMS_LOG_INDEX_SEGMENTS_MAX
+#define TPMS_SESSION_LOG_BYTES_MAX (8 * 1024 * 1024)
+#define TPMS_SESSION_LOG_PROTOCOL_LEN 16
+#define TPMS_SESSION_LOG_HEADER \
+    "time,protocol,id,pressure,temperature,battery,mode,alarm,rssi,frequency\n"
+#define TPMS_SESSION_LOG_HEADER_LEN (sizeof(TPMS_SESSION_LOG_HEADER) - 1)
+// Every row has this length, row n of a segment starts at TPMS_SESSION_LOG_HEADER_LEN + n * it
+#define TPMS_SESSION_LOG_ROW_LEN 73
+// The ID, 8 hex digits, starts here in every row: after the time and the padded protocol
+#define TPMS_SESSION_LOG_ID_OFFSET 31
+
+typedef struct TPMSSessionLog TPMSSessionLog;
+
+/** One decoded frame, as written to the session log */
+typedef struct {
+    uint32_t timestamp; // unix timestamp
+    uint16_t timestamp_ms; // milliseconds past timestamp
+    uint32_t id;
+    uint32_t frequency; // Hz
+    float pressure; // bar
+    float temperature; // celsius
+    float rssi; // dBm
+    uint8_t battery_low;
+    uint8_t mode; // TPMSMode
+    bool alarm;
+    char protocol[TPMS_SESSION_LOG_PROTOCOL_LEN];
+} TPMSSessionLogRecord;
+
+/** Allocate TPMSSessionLog
+ *
+ * @return TPMSSessionLog*
+ */
+TPMSSessionLog* tpms_session_log_alloc(void);
+
+/** Free TPMSSessionLog, pending records are written to SD first
+ *
+ * @param instance - TPMSSessionLog instance
+ */
+void tpms_session_log_free(TPMSSessionLog* instance);
+
+/** Enable or disable logging. Enabling starts a new session file
+ *
+ * @param instance  - TPMSSessionLog instance
+ * @param enabled   - logging state
+ */
+void tpms_session_log_set_enabled(TPMSSessionLog* instance, bool enabled);
+
+/** Get logging state
+ *
+ * @param instance  - TPMSSessionLog instance
+ * @return bool     - is enabled
+ */
+bool tpms_session_log_is_enabled(TPMSSessionLog* instance);
+
+/** Queue a decoded frame. Called from rx callback on worker thread
+ *
+ * @param instance  - TPMSSessionLog instance
+ * @param protocol  - protocol name
+ * @param generic   - decoded frame
+ * @param frequency - frequency Hz the frame was received on
+ * @return bool     - records wait for tpms_session_log_save_pending
+ */
+bool tpms_session_log_feed(
+    TPMSSessionLog* instance,
+    const char* protocol,
+    const TPMSBlockGeneric* generic,
+    uint32_t frequency);
+
+/** Parse a session log row
+ *
+ * @param row       - row, as written to a segment
+ * @param record    - record read
+ * @return bool     - row was parsed
+ */
+bool tpms_session_log_parse(const char* row, TPMSSessionLogRecord* record);
+
+/** Append queued records to the session file on SD
+ *
+ * @param instance  - TPMSSessionLog instance
+ * @return bool     - all records were written
+ */
+bool tpms_session_log_save_pending(TPMSSessionLog* instance);
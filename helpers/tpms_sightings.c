@@ -0,0 +1,138 @@
+#include "tpms_sightings.h"
+
+#define TAG "TPMSSightings"
+
+#define TPMS_SIGHTINGS_MAGIC 0x53435054 // "TPCS"
+#define TPMS_SIGHTINGS_VERSION 1
+#define TPMS_SIGHTINGS_COUNTER_MAX UINT16_MAX
+
+/** File header, followed by DEPTH rows of WIDTH little-endian uint16 counters */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t depth;
+    uint8_t reserved;
+    uint16_t width;
+    uint16_t reserved2;
+    uint32_t total;
+} TPMSSightingsHeader;
+
+struct TPMSSightings {
+    uint32_t total;
+    uint16_t counters[TPMS_SIGHTINGS_DEPTH][TPMS_SIGHTINGS_WIDTH];
+};
+
+TPMSSightings* tpms_sightings_alloc(void) {
+    TPMSSightings* instance = malloc(sizeof(TPMSSightings));
+    memset(instance, 0, sizeof(TPMSSightings));
+    return instance;
+}
+
+void tpms_sightings_free(TPMSSightings* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+/** Row indexes by double hashing: h1 + row * h2, h2 odd so rows never coincide */
+static void tpms_sightings_index(uint32_t hash, uint16_t* index) {
+    uint32_t h2 = hash ^ (hash >> 15);
+    h2 *= 0x2C1B3C6DUL;
+    h2 ^= h2 >> 12;
+    h2 |= 1;
+    for(size_t row = 0; row < TPMS_SIGHTINGS_DEPTH; row++) {
+        index[row] = (hash + row * h2) % TPMS_SIGHTINGS_WIDTH;
+    }
+}
+
+uint32_t tpms_sightings_add(TPMSSightings* instance, uint32_t hash) {
+    furi_assert(instance);
+    uint16_t index[TPMS_SIGHTINGS_DEPTH];
+    tpms_sightings_index(hash, index);
+
+    uint16_t count = TPMS_SIGHTINGS_COUNTER_MAX;
+    for(size_t row = 0; row < TPMS_SIGHTINGS_DEPTH; row++) {
+        count = MIN(count, instance->counters[row][index[row]]);
+    }
+    if(count < TPMS_SIGHTINGS_COUNTER_MAX) count++;
+
+    // Conservative update: only counters below the new estimate grow, which keeps
+    // collisions from inflating other sensors as much as a plain increment would
+    for(size_t row = 0; row < TPMS_SIGHTINGS_DEPTH; row++) {
+        uint16_t* counter = &instance->counters[row][index[row]];
+        if(*counter < count) *counter = count;
+    }
+    instance->total++;
+    return count;
+}
+
+uint32_t tpms_sightings_get(TPMSSightings* instance, uint32_t hash) {
+    furi_assert(instance);
+    uint16_t index[TPMS_SIGHTINGS_DEPTH];
+    tpms_sightings_index(hash, index);
+
+    uint16_t count = TPMS_SIGHTINGS_COUNTER_MAX;
+    for(size_t row = 0; row < TPMS_SIGHTINGS_DEPTH; row++) {
+        count = MIN(count, instance->counters[row][index[row]]);
+    }
+    return count;
+}
+
+uint32_t tpms_sightings_get_total(TPMSSightings* instance) {
+    furi_assert(instance);
+    return instance->total;
+}
+
+bool tpms_sightings_load(TPMSSightings* instance, Storage* storage, const char* path) {
+    furi_assert(instance);
+    File* file = storage_file_alloc(storage);
+    TPMSSightingsHeader header;
+    bool res = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != TPMS_SIGHTINGS_MAGIC || header.version != TPMS_SIGHTINGS_VERSION ||
+           header.depth != TPMS_SIGHTINGS_DEPTH || header.width != TPMS_SIGHTINGS_WIDTH) {
+            FURI_LOG_W(TAG, "Incompatible sketch in %s, starting over", path);
+            break;
+        }
+        if(storage_file_read(file, instance->counters, sizeof(instance->counters)) !=
+           sizeof(instance->counters)) {
+            memset(instance->counters, 0, sizeof(instance->counters));
+            break;
+        }
+        instance->total = header.total;
+        res = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return res;
+}
+
+bool tpms_sightings_save(TPMSSightings* instance, Storage* storage, const char* path) {
+    furi_assert(instance);
+    File* file = storage_file_alloc(storage);
+    TPMSSightingsHeader header = {
+        .magic = TPMS_SIGHTINGS_MAGIC,
+        .version = TPMS_SIGHTINGS_VERSION,
+        .depth = TPMS_SIGHTINGS_DEPTH,
+        .width = TPMS_SIGHTINGS_WIDTH,
+        .total = instance->total,
+    };
+    bool res = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, instance->counters, sizeof(instance->counters)) !=
+           sizeof(instance->counters)) {
+            break;
+        }
+        res = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return res;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+// 16 KB of counters. A count is off by at most e/WIDTH (0.13%) of all sightings,
+// with probability 1 - e^-DEPTH (98%)
+#define TPMS_SIGHTINGS_DEPTH 4
+#define TPMS_SIGHTINGS_WIDTH 2048
+
+typedef struct TPMSSightings TPMSSightings;
+
+/** Allocate TPMSSightings, a count-min sketch of how often each sensor was seen
+ *
+ * @return TPMSSightings*
+ */
+TPMSSightings* tpms_sightings_alloc(void);
+
+/** Free TPMSSightings
+ *
+ * @param instance - TPMSSightings instance
+ */
+void tpms_sightings_free(TPMSSightings* instance);
+
+/** Count one sighting
+ *
+ * @param instance  - TPMSSightings instance
+ * @param hash      - sensor hash
+ * @return uint32_t - sightings of this sensor so far, never underestimated
+ */
+uint32_t tpms_sightings_add(TPMSSightings* instance, uint32_t hash);
+
+/** Get sightings of a sensor
+ *
+ * @param instance  - TPMSSightings instance
+ * @param hash      - sensor hash
+ * @return uint32_t - sightings, never underestimated
+ */
+uint32_t tpms_sightings_get(TPMSSightings* instance, uint32_t hash);
+
+/** Get number of sightings counted in total
+ *
+ * @param instance  - TPMSSightings instance
+ * @return uint32_t - total
+ */
+uint32_t tpms_sightings_get_total(TPMSSightings* instance);
+
+/** Load sketch from file, so counts carry over between sessions
+ *
+ * @param instance  - TPMSSightings instance
+ * @param storage   - Storage instance
+ * @param path      - file path
+ * @return bool     - sketch loaded
+ */
+bool tpms_sightings_load(TPMSSightings* instance, Storage* storage, const char* path);
+
+/** Save sketch to file
+ *
+ * @param instance  - TPMSSightings instance
+ * @param storage   - Storage instance
+ * @param path      - file path
+ * @return bool     - sketch saved
+ */
+bool tpms_sightings_save(TPMSSightings* instance, Storage* storage, const char* path);
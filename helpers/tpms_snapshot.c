@@ -0,0 +1,51 @@
+#include "tpms_snapshot.h"
+
+#define TPMS_SNAPSHOT_SLOTS 3
+#define TPMS_SNAPSHOT_FRESH 0x80 // set on the ready slot index when it was not read yet
+
+struct TPMSSnapshot {
+    size_t size;
+    uint8_t* slot;
+    uint8_t back; // writer only
+    uint8_t front; // reader only
+    uint8_t ready; // exchanged by both
+};
+
+TPMSSnapshot* tpms_snapshot_alloc(size_t size) {
+    TPMSSnapshot* instance = malloc(sizeof(TPMSSnapshot));
+    instance->size = size;
+    instance->slot = malloc(TPMS_SNAPSHOT_SLOTS * size);
+    memset(instance->slot, 0, TPMS_SNAPSHOT_SLOTS * size);
+    instance->back = 0;
+    instance->ready = 1;
+    instance->front = 2;
+    return instance;
+}
+
+void tpms_snapshot_free(TPMSSnapshot* instance) {
+    furi_assert(instance);
+    free(instance->slot);
+    free(instance);
+}
+
+void* tpms_snapshot_back(TPMSSnapshot* instance) {
+    furi_assert(instance);
+    return instance->slot + instance->back * instance->size;
+}
+
+void tpms_snapshot_publish(TPMSSnapshot* instance) {
+    furi_assert(instance);
+    // Release: the reader sees the slot contents once it sees the index
+    uint8_t old = __atomic_exchange_n(
+        &instance->ready, instance->back | TPMS_SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    instance->back = old & ~TPMS_SNAPSHOT_FRESH;
+}
+
+const void* tpms_snapshot_front(TPMSSnapshot* instance) {
+    furi_assert(instance);
+    if(__atomic_load_n(&instance->ready, __ATOMIC_ACQUIRE) & TPMS_SNAPSHOT_FRESH) {
+        uint8_t old = __atomic_exchange_n(&instance->ready, instance->front, __ATOMIC_ACQ_REL);
+        instance->front = old & ~TPMS_SNAPSHOT_FRESH;
+    }
+    return instance->slot + instance->front * instance->size;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <furi.h>
+
+/* Snapshot buffer for a view model with one writer and one reader. The writer fills its back
+ * slot and publishes it with an atomic exchange, the reader takes the newest published slot.
+ * Neither side waits: a third slot is kept so the writer always has one the reader is not
+ * looking at. Writers on several threads must serialize among themselves. */
+
+typedef struct TPMSSnapshot TPMSSnapshot;
+
+/** Allocate TPMSSnapshot, all slots zeroed
+ *
+ * @param size  - slot size, bytes
+ * @return TPMSSnapshot*
+ */
+TPMSSnapshot* tpms_snapshot_alloc(size_t size);
+
+/** Free TPMSSnapshot
+ *
+ * @param instance - TPMSSnapshot instance
+ */
+void tpms_snapshot_free(TPMSSnapshot* instance);
+
+/** Get the slot to fill. It holds an older snapshot, the writer must fill it whole
+ *
+ * @param instance  - TPMSSnapshot instance
+ * @return void*    - back slot
+ */
+void* tpms_snapshot_back(TPMSSnapshot* instance);
+
+/** Publish the back slot, a new back slot is taken
+ *
+ * @param instance - TPMSSnapshot instance
+ */
+void tpms_snapshot_publish(TPMSSnapshot* instance);
+
+/** Get the newest snapshot. Stays valid until the next call
+ *
+ * @param instance      - TPMSSnapshot instance
+ * @return const void*  - front slot
+ */
+const void* tpms_snapshot_front(TPMSSnapshot* instance);
@@ -0,0 +1,208 @@
+#include "tpms_sort.h"
+
+#define TAG "TPMSSort"
+
+typedef struct {
+    uint32_t first_seen; // sequence number, a replaced record gets a new one
+    uint32_t last_seen;
+    float rssi;
+    float pressure;
+    char protocol[TPMS_SORT_PROTOCOL_LEN];
+    char id[TPMS_SORT_ID_LEN];
+} TPMSSortKey;
+
+struct TPMSSort {
+    uint16_t count;
+    uint16_t size;
+    uint32_t sequence;
+    TPMSSortOrder active;
+    TPMSSortKey* key;
+    // index[order][pos] is the record at pos, position[order][idx] its inverse. First seen
+    // has a row too, so every order reads the same way. It is the identity until a record
+    // is reused for another sensor
+    uint16_t* index[TPMSSortCount];
+    uint16_t* position[TPMSSortCount];
+};
+
+static const char* const tpms_sort_name[TPMSSortCount] = {
+    [TPMSSortFirstSeen] = "First seen",
+    [TPMSSortLastSeen] = "Last seen",
+    [TPMSSortRssi] = "RSSI",
+    [TPMSSortPressure] = "Pressure",
+    [TPMSSortProtocol] = "Protocol",
+    [TPMSSortId] = "ID",
+};
+
+TPMSSort* tpms_sort_alloc(uint16_t count) {
+    TPMSSort* instance = malloc(sizeof(TPMSSort));
+    instance->count = count;
+    instance->size = 0;
+    instance->sequence = 0;
+    instance->active = TPMSSortFirstSeen;
+    instance->key = malloc(count * sizeof(TPMSSortKey));
+    for(uint8_t order = 0; order < TPMSSortCount; order++) {
+        instance->index[order] = malloc(count * sizeof(uint16_t));
+        instance->position[order] = malloc(count * sizeof(uint16_t));
+    }
+    return instance;
+}
+
+void tpms_sort_free(TPMSSort* instance) {
+    furi_assert(instance);
+    for(uint8_t order = 0; order < TPMSSortCount; order++) {
+        free(instance->index[order]);
+        free(instance->position[order]);
+    }
+    free(instance->key);
+    free(instance);
+}
+
+void tpms_sort_reset(TPMSSort* instance) {
+    furi_assert(instance);
+    instance->size = 0;
+    instance->sequence = 0;
+}
+
+// Negative when record a goes before record b. Ties keep first seen order, so an order is
+// the same whatever the sequence of updates that led to it
+static int32_t tpms_sort_compare(TPMSSort* instance, TPMSSortOrder order, uint16_t a, uint16_t b) {
+    const TPMSSortKey* key_a = &instance->key[a];
+    const TPMSSortKey* key_b = &instance->key[b];
+    int32_t res = 0;
+    switch(order) {
+    case TPMSSortLastSeen:
+        res = (int32_t)(key_b->last_seen - key_a->last_seen);
+        break;
+    case TPMSSortRssi:
+        res = (key_a->rssi < key_b->rssi) - (key_a->rssi > key_b->rssi);
+        break;
+    case TPMSSortPressure:
+        res = (key_a->pressure > key_b->pressure) - (key_a->pressure < key_b->pressure);
+        break;
+    case TPMSSortProtocol:
+        res = strcmp(key_a->protocol, key_b->protocol);
+        break;
+    case TPMSSortId:
+        res = strcmp(key_a->id, key_b->id);
+        break;
+    default:
+        break;
+    }
+    if(res) return res;
+    return (key_a->first_seen > key_b->first_seen) - (key_a->first_seen < key_b->first_seen);
+}
+
+static void tpms_sort_place(TPMSSort* instance, TPMSSortOrder order, uint16_t idx, bool added) {
+    uint16_t* index = instance->index[order];
+    uint16_t* position = instance->position[order];
+    uint16_t size = instance->size;
+
+    // Take the record out, then binary search its place among the others
+    uint16_t from = size - 1;
+    if(!added) {
+        from = position[idx];
+        memmove(&index[from], &index[from + 1], (size - 1 - from) * sizeof(uint16_t));
+    }
+    uint16_t low = 0;
+    uint16_t high = size - 1;
+    while(low < high) {
+        uint16_t mid = (low + high) / 2;
+        if(tpms_sort_compare(instance, order, index[mid], idx) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    memmove(&index[low + 1], &index[low], (size - 1 - low) * sizeof(uint16_t));
+    index[low] = idx;
+
+    // Only the records between the old and the new place moved
+    uint16_t first = MIN(from, low);
+    uint16_t last = MAX(from, low);
+    for(uint16_t pos = first; pos <= last; pos++) {
+        position[index[pos]] = pos;
+    }
+}
+
+void tpms_sort_update(
+    TPMSSort* instance,
+    uint16_t idx,
+    uint32_t id,
+    uint32_t last_seen,
+    float rssi,
+    float pressure,
+    const char* protocol) {
+    furi_assert(instance);
+    furi_assert(protocol);
+    bool added = idx == instance->size;
+    if(idx > instance->size || idx >= instance->count) {
+        FURI_LOG_E(TAG, "Record %u out of order", idx);
+        return;
+    }
+
+    TPMSSortKey* key = &instance->key[idx];
+    char id_str[TPMS_SORT_ID_LEN];
+    snprintf(id_str, sizeof(id_str), "%lX", id);
+    // The history reused the record of a gone sensor: the new one is seen first now
+    bool replaced = !added && strcmp(key->id, id_str) != 0;
+    if(added || replaced) key->first_seen = instance->sequence++;
+    key->last_seen = last_seen;
+    key->rssi = rssi;
+    key->pressure = pressure;
+    strlcpy(key->protocol, protocol, sizeof(key->protocol));
+    strlcpy(key->id, id_str, sizeof(key->id));
+
+    if(added) instance->size++;
+    // Other readings keep the first seen place, every order is searched again otherwise
+    uint8_t first = added || replaced ? TPMSSortFirstSeen : TPMSSortFirstSeen + 1;
+    for(uint8_t order = first; order < TPMSSortCount; order++) {
+        tpms_sort_place(instance, order, idx, added);
+    }
+}
+
+bool tpms_sort_find_id(TPMSSort* instance, const char* prefix, uint16_t* idx) {
+    furi_assert(instance);
+    furi_assert(prefix);
+    furi_assert(idx);
+    const uint16_t* index = instance->index[TPMSSortId];
+
+    // The first ID not below the prefix is the lowest one starting with it, if any does
+    uint16_t low = 0;
+    uint16_t high = instance->size;
+    while(low < high) {
+        uint16_t mid = (low + high) / 2;
+        if(strcmp(instance->key[index[mid]].id, prefix) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if(low == instance->size ||
+       strncmp(instance->key[index[low]].id, prefix, strlen(prefix)) != 0) {
+        return false;
+    }
+    *idx = index[low];
+    return true;
+}
+
+TPMSSortOrder tpms_sort_next(TPMSSort* instance) {
+    furi_assert(instance);
+    instance->active = (instance->active + 1) % TPMSSortCount;
+    return instance->active;
+}
+
+TPMSSortOrder tpms_sort_get_active(TPMSSort* instance) {
+    furi_assert(instance);
+    return instance->active;
+}
+
+const uint16_t* tpms_sort_get_index(TPMSSort* instance, uint16_t* size) {
+    furi_assert(instance);
+    furi_assert(size);
+    *size = instance->size;
+    return instance->index[instance->active];
+}
+
+const char* tpms_sort_get_name(TPMSSortOrder order) {
+    return order < TPMSSortCount ? tpms_sort_name[order] : "";
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <furi.h>
+
+/* Orders of the sensor list besides first seen. Each order is an index array of history
+ * records kept sorted as readings come in, with its inverse to find a record in O(1). A
+ * reading moves its record by a binary search and one memmove, switching orders costs
+ * nothing and no redraw ever sorts. The ID order doubles as the index searched by ID
+ * prefix. */
+
+#define TPMS_SORT_PROTOCOL_LEN 16
+#define TPMS_SORT_ID_LEN 9 // "%lX" of a 32 bit id
+
+typedef enum {
+    TPMSSortFirstSeen,
+    TPMSSortLastSeen, // most recent first
+    TPMSSortRssi, // strongest first
+    TPMSSortPressure, // lowest first
+    TPMSSortProtocol, // by name
+    TPMSSortId, // by hex ID, as text so IDs sharing a prefix sit together
+    TPMSSortCount,
+} TPMSSortOrder;
+
+typedef struct TPMSSort TPMSSort;
+
+/** Allocate TPMSSort
+ *
+ * @param count - number of records, one per history record
+ * @return TPMSSort*
+ */
+TPMSSort* tpms_sort_alloc(uint16_t count);
+
+/** Free TPMSSort
+ *
+ * @param instance - TPMSSort instance
+ */
+void tpms_sort_free(TPMSSort* instance);
+
+/** Drop all records, the active order stays
+ *
+ * @param instance - TPMSSort instance
+ */
+void tpms_sort_reset(TPMSSort* instance);
+
+/** Add a record or move it after a new reading. Records are added in index order. A record
+ * that comes with another ID holds a new sensor, it goes last in first seen order
+ *
+ * @param instance  - TPMSSort instance
+ * @param idx       - history record index
+ * @param id        - sensor id
+ * @param last_seen - reading time, seconds
+ * @param rssi      - dBm
+ * @param pressure  - bar
+ * @param protocol  - protocol name
+ */
+void tpms_sort_update(
+    TPMSSort* instance,
+    uint16_t idx,
+    uint32_t id,
+    uint32_t last_seen,
+    float rssi,
+    float pressure,
+    const char* protocol);
+
+/** Find the record with the lowest ID starting with prefix, by binary search on the ID order
+ *
+ * @param instance  - TPMSSort instance
+ * @param prefix    - upper case hex digits
+ * @param idx       - history record index, when found
+ * @return bool     - is found
+ */
+bool tpms_sort_find_id(TPMSSort* instance, const char* prefix, uint16_t* idx);
+
+/** Switch to the next order
+ *
+ * @param instance          - TPMSSort instance
+ * @return TPMSSortOrder    - order now active
+ */
+TPMSSortOrder tpms_sort_next(TPMSSort* instance);
+
+/** Get the active order
+ *
+ * @param instance          - TPMSSort instance
+ * @return TPMSSortOrder    - active order
+ */
+TPMSSortOrder tpms_sort_get_active(TPMSSort* instance);
+
+/** Get history indices in the active order
+ *
+ * @param instance          - TPMSSort instance
+ * @param size              - number of records
+ * @return const uint16_t*  - record index at each list position
+ */
+const uint16_t* tpms_sort_get_index(TPMSSort* instance, uint16_t* size);
+
+/** Get short order name
+ *
+ * @param order         - TPMSSortOrder
+ * @return const char*  - name
+ */
+const char* tpms_sort_get_name(TPMSSortOrder order);
@@ -0,0 +1,109 @@
+#include "tpms_timer_wheel.h"
+
+#define TAG "TPMSTimerWheel"
+
+#define TPMS_TIMER_WHEEL_MASK (TPMS_TIMER_WHEEL_SLOTS - 1)
+
+typedef struct {
+    uint32_t deadline;
+    uint16_t next;
+    uint16_t prev;
+    bool pending;
+} TPMSTimerWheelEntry;
+
+struct TPMSTimerWheel {
+    uint32_t now;
+    uint16_t count;
+    uint16_t slot[TPMS_TIMER_WHEEL_SLOTS];
+    TPMSTimerWheelEntry* entry;
+};
+
+TPMSTimerWheel* tpms_timer_wheel_alloc(uint16_t count, uint32_t now) {
+    furi_assert(count < TPMS_TIMER_WHEEL_NONE);
+    TPMSTimerWheel* instance = malloc(sizeof(TPMSTimerWheel));
+    instance->count = count;
+    instance->entry = malloc(count * sizeof(TPMSTimerWheelEntry));
+    tpms_timer_wheel_reset(instance, now);
+    return instance;
+}
+
+void tpms_timer_wheel_free(TPMSTimerWheel* instance) {
+    furi_assert(instance);
+    free(instance->entry);
+    free(instance);
+}
+
+void tpms_timer_wheel_reset(TPMSTimerWheel* instance, uint32_t now) {
+    furi_assert(instance);
+    instance->now = now;
+    for(size_t i = 0; i < TPMS_TIMER_WHEEL_SLOTS; i++) {
+        instance->slot[i] = TPMS_TIMER_WHEEL_NONE;
+    }
+    memset(instance->entry, 0, instance->count * sizeof(TPMSTimerWheelEntry));
+}
+
+static void tpms_timer_wheel_unlink(TPMSTimerWheel* instance, uint16_t timer) {
+    TPMSTimerWheelEntry* entry = &instance->entry[timer];
+    if(entry->prev != TPMS_TIMER_WHEEL_NONE) {
+        instance->entry[entry->prev].next = entry->next;
+    } else {
+        instance->slot[entry->deadline & TPMS_TIMER_WHEEL_MASK] = entry->next;
+    }
+    if(entry->next != TPMS_TIMER_WHEEL_NONE) {
+        instance->entry[entry->next].prev = entry->prev;
+    }
+    entry->pending = false;
+}
+
+void tpms_timer_wheel_schedule(TPMSTimerWheel* instance, uint16_t timer, uint32_t deadline) {
+    furi_assert(instance);
+    furi_assert(timer < instance->count);
+    TPMSTimerWheelEntry* entry = &instance->entry[timer];
+    if(entry->pending) tpms_timer_wheel_unlink(instance, timer);
+
+    // Overdue timers go to the next slot visited, they would wait a whole lap otherwise
+    if((int32_t)(deadline - instance->now) <= 0) deadline = instance->now + 1;
+
+    uint16_t* head = &instance->slot[deadline & TPMS_TIMER_WHEEL_MASK];
+    entry->deadline = deadline;
+    entry->prev = TPMS_TIMER_WHEEL_NONE;
+    entry->next = *head;
+    entry->pending = true;
+    if(*head != TPMS_TIMER_WHEEL_NONE) instance->entry[*head].prev = timer;
+    *head = timer;
+}
+
+void tpms_timer_wheel_cancel(TPMSTimerWheel* instance, uint16_t timer) {
+    furi_assert(instance);
+    furi_assert(timer < instance->count);
+    if(instance->entry[timer].pending) tpms_timer_wheel_unlink(instance, timer);
+}
+
+void tpms_timer_wheel_advance(
+    TPMSTimerWheel* instance,
+    uint32_t now,
+    TPMSTimerWheelCallback callback,
+    void* context) {
+    furi_assert(instance);
+    furi_assert(callback);
+
+    int32_t steps = now - instance->now;
+    if(steps <= 0) return;
+    // One lap visits every slot, a longer gap only has more timers due
+    if(steps > TPMS_TIMER_WHEEL_SLOTS) steps = TPMS_TIMER_WHEEL_SLOTS;
+    uint32_t from = instance->now + 1;
+    instance->now = now;
+
+    for(int32_t step = 0; step < steps; step++) {
+        uint16_t timer = instance->slot[(from + step) & TPMS_TIMER_WHEEL_MASK];
+        while(timer != TPMS_TIMER_WHEEL_NONE) {
+            TPMSTimerWheelEntry* entry = &instance->entry[timer];
+            uint16_t next = entry->next;
+            if((int32_t)(entry->deadline - now) <= 0) {
+                tpms_timer_wheel_unlink(instance, timer);
+                callback(timer, context);
+            }
+            timer = next;
+        }
+    }
+}
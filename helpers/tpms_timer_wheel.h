@@ -0,0 +1,70 @@
+#pragma once
+
+#include <furi.h>
+
+/* Hashed timer wheel. Timers are numbered 0..count-1, each is pending at most once.
+ * A timer lives in the slot of its deadline modulo the wheel size, so scheduling, cancelling
+ * and advancing by one slot cost O(1) on average whatever the number of timers. Deadlines
+ * further than one lap away stay in their slot and are skipped until they are due. */
+
+#define TPMS_TIMER_WHEEL_SLOTS 64
+#define TPMS_TIMER_WHEEL_NONE 0xFFFF
+
+typedef struct TPMSTimerWheel TPMSTimerWheel;
+
+/** Called for each expired timer. The callback may schedule the expired timer again
+ *
+ * @param timer     - expired timer
+ * @param context   - context passed to tpms_timer_wheel_advance
+ */
+typedef void (*TPMSTimerWheelCallback)(uint16_t timer, void* context);
+
+/** Allocate TPMSTimerWheel
+ *
+ * @param count - number of timers
+ * @param now   - current time, in the unit the deadlines use
+ * @return TPMSTimerWheel*
+ */
+TPMSTimerWheel* tpms_timer_wheel_alloc(uint16_t count, uint32_t now);
+
+/** Free TPMSTimerWheel
+ *
+ * @param instance - TPMSTimerWheel instance
+ */
+void tpms_timer_wheel_free(TPMSTimerWheel* instance);
+
+/** Cancel all timers
+ *
+ * @param instance  - TPMSTimerWheel instance
+ * @param now       - current time
+ */
+void tpms_timer_wheel_reset(TPMSTimerWheel* instance, uint32_t now);
+
+/** Schedule a timer, moving it when already pending. A deadline in the past fires on the
+ * next advance
+ *
+ * @param instance  - TPMSTimerWheel instance
+ * @param timer     - timer number
+ * @param deadline  - expiry time
+ */
+void tpms_timer_wheel_schedule(TPMSTimerWheel* instance, uint16_t timer, uint32_t deadline);
+
+/** Cancel a timer, nothing happens when it is not pending
+ *
+ * @param instance  - TPMSTimerWheel instance
+ * @param timer     - timer number
+ */
+void tpms_timer_wheel_cancel(TPMSTimerWheel* instance, uint16_t timer);
+
+/** Advance the wheel to now and fire the timers due
+ *
+ * @param instance  - TPMSTimerWheel instance
+ * @param now       - current time
+ * @param callback  - TPMSTimerWheelCallback
+ * @param context   - callback context
+ */
+void tpms_timer_wheel_advance(
+    TPMSTimerWheel* instance,
+    uint32_t now,
+    TPMSTimerWheelCallback callback,
+    void* context);
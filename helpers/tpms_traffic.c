@@ -0,0 +1,257 @@
+#include "tpms_traffic.h"
+#include "tpms_types.h"
+#include "tpms_clock.h"
+#include "tpms_sightings.h"
+
+#include <storage/storage.h>
+
+#define TAG "TPMSTraffic"
+
+#define TPMS_TRAFFIC_LOG TPMS_APP_FOLDER "/traffic.csv"
+#define TPMS_TRAFFIC_SIGHTINGS TPMS_APP_FOLDER "/sightings.bin"
+#define TPMS_TRAFFIC_LOG_HEADER "start,seconds,frames,distinct,session_distinct\n"
+#define TPMS_TRAFFIC_QUEUE_SIZE 8
+
+// HyperLogLog with 2^12 one-byte registers: 4 KB per sketch, 1.04/sqrt(4096) = 1.6% std error
+#define TPMS_TRAFFIC_HLL_P 12
+#define TPMS_TRAFFIC_HLL_M (1 << TPMS_TRAFFIC_HLL_P)
+
+typedef struct {
+    uint8_t registers[TPMS_TRAFFIC_HLL_M];
+} TPMSTrafficSketch;
+
+struct TPMSTraffic {
+    volatile bool enabled;
+    volatile bool restart;
+    volatile bool sightings_dirty;
+
+    uint32_t bucket_start;
+    uint32_t frames;
+    TPMSTrafficSketch bucket;
+    TPMSTrafficSketch session;
+
+    FuriMessageQueue* queue;
+    TPMSSightings* sightings;
+};
+
+static void tpms_traffic_sketch_reset(TPMSTrafficSketch* sketch) {
+    memset(sketch->registers, 0, sizeof(sketch->registers));
+}
+
+static void tpms_traffic_sketch_add(TPMSTrafficSketch* sketch, uint32_t hash) {
+    uint32_t index = hash >> (32 - TPMS_TRAFFIC_HLL_P);
+    // Guard bit caps the rank when all remaining bits are zero
+    uint32_t rest = (hash << TPMS_TRAFFIC_HLL_P) | (1 << (TPMS_TRAFFIC_HLL_P - 1));
+    uint8_t rank = __builtin_clz(rest) + 1;
+    if(sketch->registers[index] < rank) sketch->registers[index] = rank;
+}
+
+static void tpms_traffic_sketch_merge(TPMSTrafficSketch* sketch, const TPMSTrafficSketch* other) {
+    for(size_t i = 0; i < TPMS_TRAFFIC_HLL_M; i++) {
+        if(sketch->registers[i] < other->registers[i])
+            sketch->registers[i] = other->registers[i];
+    }
+}
+
+static uint32_t tpms_traffic_sketch_estimate(const TPMSTrafficSketch* sketch) {
+    const float m = TPMS_TRAFFIC_HLL_M;
+    const float alpha = 0.7213f / (1.0f + 1.079f / m);
+
+    float sum = 0.0f;
+    uint32_t zeros = 0;
+    for(size_t i = 0; i < TPMS_TRAFFIC_HLL_M; i++) {
+        sum += ldexpf(1.0f, -sketch->registers[i]);
+        if(sketch->registers[i] == 0) zeros++;
+    }
+
+    float estimate = alpha * m * m / sum;
+    // Linear counting is more accurate while registers are still sparse. Switching on its own
+    // estimate rather than the raw one keeps the error under 2% through the crossover
+    if(zeros > 0) {
+        float linear = m * logf(m / zeros);
+        if(linear <= 3.0f * m) estimate = linear;
+    }
+    return (uint32_t)(estimate + 0.5f);
+}
+
+/** FNV-1a over protocol name and id, finished with murmur3 fmix32 to spread low entropy ids */
+static uint32_t tpms_traffic_hash(const char* protocol, uint32_t id) {
+    uint32_t hash = 2166136261UL;
+    for(const char* p = protocol; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619UL;
+    }
+    for(size_t i = 0; i < sizeof(id); i++) {
+        hash = (hash ^ ((id >> (i * 8)) & 0xFF)) * 16777619UL;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BUL;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35UL;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+TPMSTraffic* tpms_traffic_alloc(void) {
+    TPMSTraffic* instance = malloc(sizeof(TPMSTraffic));
+    memset(instance, 0, sizeof(TPMSTraffic));
+    instance->queue =
+        furi_message_queue_alloc(TPMS_TRAFFIC_QUEUE_SIZE, sizeof(TPMSTrafficBucket));
+    instance->sightings = tpms_sightings_alloc();
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    tpms_sightings_load(instance->sightings, storage, TPMS_TRAFFIC_SIGHTINGS);
+    furi_record_close(RECORD_STORAGE);
+    return instance;
+}
+
+/** Hand the bucket in progress over to the main thread and start the next one */
+static bool tpms_traffic_close_bucket(TPMSTraffic* instance, uint32_t now) {
+    if(instance->frames == 0) return false;
+
+    tpms_traffic_sketch_merge(&instance->session, &instance->bucket);
+    TPMSTrafficBucket bucket = {
+        .start = instance->bucket_start,
+        .seconds = MIN(now - instance->bucket_start, (uint32_t)TPMS_TRAFFIC_BUCKET_S),
+        .frames = instance->frames,
+        .distinct = tpms_traffic_sketch_estimate(&instance->bucket),
+        .session_distinct = tpms_traffic_sketch_estimate(&instance->session),
+    };
+    if(furi_message_queue_put(instance->queue, &bucket, 0) != FuriStatusOk) {
+        FURI_LOG_W(TAG, "Bucket %lu dropped, queue full", bucket.start);
+    }
+
+    tpms_traffic_sketch_reset(&instance->bucket);
+    instance->frames = 0;
+    return true;
+}
+
+void tpms_traffic_free(TPMSTraffic* instance) {
+    furi_assert(instance);
+    // Worker is stopped by now, the bucket in progress can be closed from here
+    tpms_traffic_close_bucket(instance, tpms_clock_get_timestamp(NULL));
+    tpms_traffic_save_pending(instance);
+    tpms_sightings_free(instance->sightings);
+    furi_message_queue_free(instance->queue);
+    free(instance);
+}
+
+void tpms_traffic_set_enabled(TPMSTraffic* instance, bool enabled) {
+    furi_assert(instance);
+    // Sketches belong to the worker thread, it starts the new session on the next frame
+    if(enabled && !instance->enabled) instance->restart = true;
+    instance->enabled = enabled;
+}
+
+bool tpms_traffic_is_enabled(TPMSTraffic* instance) {
+    furi_assert(instance);
+    return instance->enabled;
+}
+
+bool tpms_traffic_feed(TPMSTraffic* instance, const char* protocol, uint32_t id) {
+    furi_assert(instance);
+    furi_assert(protocol);
+
+    uint32_t hash = tpms_traffic_hash(protocol, id);
+    tpms_sightings_add(instance->sightings, hash);
+    instance->sightings_dirty = true;
+    if(!instance->enabled) return false;
+
+    bool closed = false;
+    // Called for every frame, the tick clock spares the worker an RTC read each time
+    uint32_t now = tpms_clock_get_timestamp(NULL);
+    uint32_t bucket_start = now - now % TPMS_TRAFFIC_BUCKET_S;
+
+    if(instance->restart) {
+        instance->restart = false;
+        closed = tpms_traffic_close_bucket(instance, now);
+        tpms_traffic_sketch_reset(&instance->session);
+        instance->bucket_start = bucket_start;
+    } else if(bucket_start != instance->bucket_start) {
+        closed =
+            tpms_traffic_close_bucket(instance, instance->bucket_start + TPMS_TRAFFIC_BUCKET_S);
+        instance->bucket_start = bucket_start;
+    }
+
+    tpms_traffic_sketch_add(&instance->bucket, hash);
+    instance->frames++;
+    return closed;
+}
+
+uint32_t tpms_traffic_get_sightings(TPMSTraffic* instance, const char* protocol, uint32_t id) {
+    furi_assert(instance);
+    furi_assert(protocol);
+    return tpms_sightings_get(instance->sightings, tpms_traffic_hash(protocol, id));
+}
+
+uint32_t tpms_traffic_get_sightings_total(TPMSTraffic* instance) {
+    furi_assert(instance);
+    return tpms_sightings_get_total(instance->sightings);
+}
+
+static bool tpms_traffic_write_log(TPMSTraffic* instance, Storage* storage) {
+    File* file = storage_file_alloc(storage);
+    FuriString* line = furi_string_alloc();
+    bool res = false;
+
+    do {
+        if(!storage_file_open(file, TPMS_TRAFFIC_LOG, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+            FURI_LOG_E(TAG, "Unable to open %s", TPMS_TRAFFIC_LOG);
+            break;
+        }
+        if(storage_file_size(file) == 0) {
+            furi_string_set(line, TPMS_TRAFFIC_LOG_HEADER);
+            storage_file_write(file, furi_string_get_cstr(line), furi_string_size(line));
+        }
+        res = true;
+        TPMSTrafficBucket bucket;
+        while(furi_message_queue_get(instance->queue, &bucket, 0) == FuriStatusOk) {
+            furi_string_printf(
+                line,
+                "%lu,%lu,%lu,%lu,%lu\n",
+                bucket.start,
+                bucket.seconds,
+                bucket.frames,
+                bucket.distinct,
+                bucket.session_distinct);
+            if(storage_file_write(file, furi_string_get_cstr(line), furi_string_size(line)) !=
+               furi_string_size(line)) {
+                FURI_LOG_E(TAG, "Unable to write bucket %lu", bucket.start);
+                res = false;
+            }
+        }
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_string_free(line);
+    return res;
+}
+
+bool tpms_traffic_save_pending(TPMSTraffic* instance) {
+    furi_assert(instance);
+    bool log_pending = furi_message_queue_get_count(instance->queue) > 0;
+    if(!log_pending && !instance->sightings_dirty) return true;
+
+    bool saved = true;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, EXT_PATH("apps_data"));
+    storage_simply_mkdir(storage, TPMS_APP_FOLDER);
+
+    if(log_pending) {
+        saved = tpms_traffic_write_log(instance, storage);
+    }
+
+    // Exported along with the log. Counters the worker bumps meanwhile may land either side of
+    // the snapshot, which is within what the sketch promises anyway
+    if(instance->sightings_dirty) {
+        instance->sightings_dirty = false;
+        if(!tpms_sightings_save(instance->sightings, storage, TPMS_TRAFFIC_SIGHTINGS)) {
+            FURI_LOG_E(TAG, "Unable to save %s", TPMS_TRAFFIC_SIGHTINGS);
+            instance->sightings_dirty = true;
+            saved = false;
+        }
+    }
+
+    furi_record_close(RECORD_STORAGE);
+    return saved;
+}
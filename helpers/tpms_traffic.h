@@ -0,0 +1,76 @@
+#pragma once
+
+#include <furi.h>
+#include <furi_hal.h>
+
+#define TPMS_TRAFFIC_BUCKET_S 60
+
+typedef struct TPMSTraffic TPMSTraffic;
+
+/** Closed time bucket, as written to the traffic log */
+typedef struct {
+    uint32_t start; // unix timestamp
+    uint32_t seconds;
+    uint32_t frames;
+    uint32_t distinct; // estimated distinct sensors in this bucket
+    uint32_t session_distinct; // estimated distinct sensors since counting was enabled
+} TPMSTrafficBucket;
+
+/** Allocate TPMSTraffic
+ *
+ * @return TPMSTraffic*
+ */
+TPMSTraffic* tpms_traffic_alloc(void);
+
+/** Free TPMSTraffic, the bucket in progress and sightings are written to SD first
+ *
+ * @param instance - TPMSTraffic instance
+ */
+void tpms_traffic_free(TPMSTraffic* instance);
+
+/** Enable or disable traffic counting. Enabling starts a new session
+ *
+ * @param instance  - TPMSTraffic instance
+ * @param enabled   - counting state
+ */
+void tpms_traffic_set_enabled(TPMSTraffic* instance, bool enabled);
+
+/** Get traffic counting state
+ *
+ * @param instance  - TPMSTraffic instance
+ * @return bool     - is enabled
+ */
+bool tpms_traffic_is_enabled(TPMSTraffic* instance);
+
+/** Count a decoded frame. Sightings are always counted, distinct sensors only while enabled.
+ * Called from rx callback on worker thread
+ *
+ * @param instance  - TPMSTraffic instance
+ * @param protocol  - protocol name
+ * @param id        - sensor id
+ * @return bool     - a bucket was closed and waits for tpms_traffic_save_pending
+ */
+bool tpms_traffic_feed(TPMSTraffic* instance, const char* protocol, uint32_t id);
+
+/** Get how many frames of a sensor were seen, across sessions
+ *
+ * @param instance  - TPMSTraffic instance
+ * @param protocol  - protocol name
+ * @param id        - sensor id
+ * @return uint32_t - sightings, may be overestimated but never underestimated
+ */
+uint32_t tpms_traffic_get_sightings(TPMSTraffic* instance, const char* protocol, uint32_t id);
+
+/** Get how many frames were seen in total, across sessions
+ *
+ * @param instance  - TPMSTraffic instance
+ * @return uint32_t - total sightings
+ */
+uint32_t tpms_traffic_get_sightings_total(TPMSTraffic* instance);
+
+/** Append closed buckets to the traffic log and export sightings on SD
+ *
+ * @param instance  - TPMSTraffic instance
+ * @return bool     - everything was written
+ */
+bool tpms_traffic_save_pending(TPMSTraffic* instance);
@@ -7,6 +7,8 @@
 #define TPMS_DEVELOPED "wosk"
 #define TPMS_GITHUB "https://github.com/beewosk/flipperzero-tpms"
 
+#define TPMS_APP_FOLDER EXT_PATH("apps_data/tpms")
+
 #define TPMS_KEY_FILE_VERSION 1
 #define TPMS_KEY_FILE_TYPE "Flipper Tire Pressure Monitoring System Key File"
 
@@ -26,6 +28,13 @@ typedef enum {
     TPMSHopperStateRSSITimeOut,
 } TPMSHopperState;
 
+/** Sensor state in history, from the time since its last reading */
+typedef enum {
+    TPMSSensorStateFresh,
+    TPMSSensorStateStale,
+    TPMSSensorStateGone,
+} TPMSSensorState;
+
 typedef enum {
     TPMSLockOff,
     TPMSLockOn,
@@ -37,6 +46,8 @@ typedef enum {
     TPMSViewReceiver,
     TPMSViewReceiverInfo,
     TPMSViewWidget,
+    TPMSViewTextInput,
+    TPMSViewLogViewer,
 } TPMSView;
 
 /** TPMSTxRx state */
@@ -2,6 +2,9 @@
 
 const SubGhzProtocol* tpms_protocol_registry_items[] = {
     &tpms_protocol_schrader_gg4,
+    &tpms_protocol_schrader_eg53ma4,
+    &tpms_protocol_toyota_pmv107j,
+    &tpms_protocol_vdo,
 };
 
 const SubGhzProtocolRegistry tpms_protocol_registry = {
@@ -2,5 +2,8 @@
 #include "../tpms_app_i.h"
 
 #include "schrader_gg4.h"
+#include "schrader_eg53ma4.h"
+#include "toyota_pmv107j.h"
+#include "vdo.h"
 
 extern const SubGhzProtocolRegistry tpms_protocol_registry;
@@ -0,0 +1,285 @@
+#include "schrader_eg53ma4.h"
+#include "tpms_manchester.h"
+
+#define TAG "SchraderEG53MA4"
+
+// https://github.com/merbanan/rtl_433/blob/master/src/devices/schraeder.c
+// https://fccid.io/MRXEG53MA4
+
+/**
+ * Schrader EG53MA4
+
+OEM:
+Abarth 124 Spider
+Mazda MX-5 ND
+
+* Frequency: 315MHz, 433.92MHz
+* Modulation: ASK
+* Manchester II, 120us half bit, same front end as Schrader GG4
+
+Examples:
+01400000a1b2c3587a29
+01400000a1b2c35a7c2d
+014000000d4e21548293
+
+Frame is 120 bits, sent after silence: 40 bit sync 0x0AAAAAAAA9, then 80 bit data.
+The first bit is always 0, its low half is lost in the silence before the frame.
+
+Data layout:
+ * | Byte 0-3  | Byte 4    | Byte 5    | Byte 6    | Byte 7    | Byte 8    | Byte 9    |
+ * | --------- | --------- | --------- | --------- | --------- | --------- | --------- |
+ * | FFFF ...  | IIII IIII | IIII IIII | IIII IIII | PPPP PPPP | TTTT TTTT | CCCC CCCC |
+ *
+
+- F: 32 bit flags, not decoded
+- I: 24 bit ID
+- P: 8 bit Pressure (multiplyed by 2.5 = kPa)
+- T: 8 bit Temperature (deg. F offset by 50)
+- C: 8 bit Checksum (sum of bytes 0-8)
+
+Bytes 2-9 are kept as 64 bit data.
+*/
+
+#define SYNC_BITS_LEN 40
+#define SYNC_BYTES (SYNC_BITS_LEN / 8)
+#define FRAME_BITS_LEN 120
+#define FRAME_BYTES (FRAME_BITS_LEN / 8)
+
+static const SubGhzBlockConst tpms_protocol_schrader_eg53ma4_const = {
+    .te_short = 120,
+    .te_long = 240,
+    .te_delta = 55, // 50% of te_short due to poor sensitivity
+    .min_count_bit_for_found = 64,
+};
+
+struct TPMSProtocolDecoderSchraderEG53MA4 {
+    SubGhzProtocolDecoderBase base;
+
+    SubGhzBlockDecoder decoder;
+    TPMSBlockGeneric generic;
+
+    // Pulse classifier and Manchester stage, shared with Schrader GG4
+    TPMSManchesterFrontEnd* front_end;
+    uint8_t frame[FRAME_BYTES];
+};
+
+struct TPMSProtocolEncoderSchraderEG53MA4 {
+    SubGhzProtocolEncoderBase base;
+
+    SubGhzProtocolBlockEncoder encoder;
+    TPMSBlockGeneric generic;
+};
+
+typedef enum {
+    SchraderEG53MA4DecoderStepReset = 0,
+    SchraderEG53MA4DecoderStepWaitStart,
+    SchraderEG53MA4DecoderStepDecoderData,
+} SchraderEG53MA4DecoderStep;
+
+const SubGhzProtocolDecoder tpms_protocol_schrader_eg53ma4_decoder = {
+    .alloc = tpms_protocol_decoder_schrader_eg53ma4_alloc,
+    .free = tpms_protocol_decoder_schrader_eg53ma4_free,
+
+    .feed = tpms_protocol_decoder_schrader_eg53ma4_feed,
+    .reset = tpms_protocol_decoder_schrader_eg53ma4_reset,
+
+    .get_hash_data = tpms_protocol_decoder_schrader_eg53ma4_get_hash_data,
+    .serialize = tpms_protocol_decoder_schrader_eg53ma4_serialize,
+    .deserialize = tpms_protocol_decoder_schrader_eg53ma4_deserialize,
+    .get_string = tpms_protocol_decoder_schrader_eg53ma4_get_string,
+};
+
+const SubGhzProtocolEncoder tpms_protocol_schrader_eg53ma4_encoder = {
+    .alloc = NULL,
+    .free = NULL,
+
+    .deserialize = NULL,
+    .stop = NULL,
+    .yield = NULL,
+};
+
+const SubGhzProtocol tpms_protocol_schrader_eg53ma4 = {
+    .name = TPMS_PROTOCOL_SCHRADER_EG53MA4_NAME,
+    .type = SubGhzProtocolTypeStatic,
+    .flag = SubGhzProtocolFlag_433 | SubGhzProtocolFlag_315 | SubGhzProtocolFlag_AM |
+            SubGhzProtocolFlag_Decodable,
+
+    .decoder = &tpms_protocol_schrader_eg53ma4_decoder,
+    .encoder = &tpms_protocol_schrader_eg53ma4_encoder,
+};
+
+void* tpms_protocol_decoder_schrader_eg53ma4_alloc(SubGhzEnvironment* environment) {
+    UNUSED(environment);
+    TPMSProtocolDecoderSchraderEG53MA4* instance =
+        malloc(sizeof(TPMSProtocolDecoderSchraderEG53MA4));
+    instance->base.protocol = &tpms_protocol_schrader_eg53ma4;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->front_end =
+        tpms_manchester_front_end_acquire(&tpms_protocol_schrader_eg53ma4_const);
+    return instance;
+}
+
+void tpms_protocol_decoder_schrader_eg53ma4_free(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+    tpms_manchester_front_end_release(instance->front_end);
+    free(instance);
+}
+
+void tpms_protocol_decoder_schrader_eg53ma4_reset(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+    instance->decoder.parser_step = SchraderEG53MA4DecoderStepReset;
+}
+
+static const uint8_t tpms_protocol_schrader_eg53ma4_sync[SYNC_BYTES] = {
+    0x0A, 0xAA, 0xAA, 0xAA, 0xA9};
+
+static bool tpms_protocol_schrader_eg53ma4_check_checksum(
+    TPMSProtocolDecoderSchraderEG53MA4* instance) {
+    const uint8_t* data = &instance->frame[SYNC_BITS_LEN / 8];
+    return subghz_protocol_blocks_add_bytes(data, 9) == data[9];
+}
+
+/**
+ * Analysis of received data
+ * @param instance Pointer to a TPMSBlockGeneric* instance
+ */
+static void tpms_protocol_schrader_eg53ma4_analyze(TPMSBlockGeneric* instance) {
+    instance->id = (instance->data >> 24) & 0xFFFFFF;
+
+    instance->battery_low = TPMS_NO_BATT;
+
+    instance->temperature = locale_fahrenheit_to_celsius(((instance->data >> 8) & 0xFF) - 50.0f);
+    instance->pressure = ((instance->data >> 16) & 0xFF) * 2.5 * 0.01;
+}
+
+static void
+    tpms_protocol_schrader_eg53ma4_frame_end(TPMSProtocolDecoderSchraderEG53MA4* instance) {
+    if(instance->decoder.decode_count_bit != FRAME_BITS_LEN) {
+        if(instance->decoder.decode_count_bit > SYNC_BITS_LEN) {
+            FURI_LOG_D(TAG, "reset accumulated %d bits", instance->decoder.decode_count_bit);
+        }
+        return;
+    }
+    // Any 120 bits of Manchester pass an 8 bit sum once in 256, the sync rules them out
+    if(memcmp(instance->frame, tpms_protocol_schrader_eg53ma4_sync, SYNC_BYTES) != 0) {
+        FURI_LOG_D(TAG, "Sync mismatch");
+        return;
+    }
+    if(!tpms_protocol_schrader_eg53ma4_check_checksum(instance)) {
+        FURI_LOG_D(TAG, "Checksum mismatch");
+        return;
+    }
+
+    FURI_LOG_D(TAG, "%016llx", instance->decoder.decode_data);
+    instance->generic.data = instance->decoder.decode_data;
+    instance->generic.data_count_bit =
+        tpms_protocol_schrader_eg53ma4_const.min_count_bit_for_found;
+    tpms_protocol_schrader_eg53ma4_analyze(&instance->generic);
+    if(instance->base.callback) instance->base.callback(&instance->base, instance->base.context);
+}
+
+static void tpms_protocol_schrader_eg53ma4_add_bit(
+    TPMSProtocolDecoderSchraderEG53MA4* instance,
+    bool bit) {
+    uint16_t count = instance->decoder.decode_count_bit;
+    if(count >= FRAME_BITS_LEN) {
+        // Too long for this protocol, wait for the next silence
+        instance->decoder.parser_step = SchraderEG53MA4DecoderStepReset;
+        return;
+    }
+    instance->frame[count / 8] |= bit << (7 - count % 8);
+    subghz_protocol_blocks_add_bit(&instance->decoder, bit);
+}
+
+void tpms_protocol_decoder_schrader_eg53ma4_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+
+    // Every pulse goes through the shared stage, so its Manchester state follows the signal.
+    // The silence is a reset there, which starts the state as the high half of a bit
+    const TPMSManchesterSymbol* symbol =
+        tpms_manchester_front_end_feed(instance->front_end, level, duration);
+
+    switch(instance->decoder.parser_step) {
+    case SchraderEG53MA4DecoderStepReset:
+        // Frame is preceded by silence longer than any Manchester symbol
+        if((!level) && (duration > tpms_protocol_schrader_eg53ma4_const.te_long +
+                                       tpms_protocol_schrader_eg53ma4_const.te_delta)) {
+            instance->decoder.parser_step = SchraderEG53MA4DecoderStepWaitStart;
+        }
+        break;
+
+    case SchraderEG53MA4DecoderStepWaitStart:
+        if(!level) break;
+        instance->decoder.decode_data = 0;
+        instance->decoder.decode_count_bit = 0;
+        memset(instance->frame, 0, sizeof(instance->frame));
+        // Low half of the leading 0 bit merged into the silence, so it can not be decoded
+        tpms_protocol_schrader_eg53ma4_add_bit(instance, 0);
+        instance->decoder.parser_step = SchraderEG53MA4DecoderStepDecoderData;
+        // fall through
+
+    case SchraderEG53MA4DecoderStepDecoderData:
+        if(symbol->event == ManchesterEventReset) {
+            if(level) {
+                instance->decoder.parser_step = SchraderEG53MA4DecoderStepReset;
+                break;
+            }
+            // Silence after the frame
+            tpms_protocol_schrader_eg53ma4_frame_end(instance);
+            instance->decoder.parser_step = SchraderEG53MA4DecoderStepWaitStart;
+            break;
+        }
+        if(symbol->bit_valid) {
+            tpms_protocol_schrader_eg53ma4_add_bit(instance, symbol->bit);
+        }
+        break;
+    }
+}
+
+uint8_t tpms_protocol_decoder_schrader_eg53ma4_get_hash_data(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+    // Block decoder holds the whole 120 bit frame count, hash the kept 64 bits
+    SubGhzBlockDecoder decoder = {
+        .decode_data = instance->generic.data,
+        .decode_count_bit = instance->generic.data_count_bit,
+    };
+    return subghz_protocol_blocks_get_hash_data(&decoder, (decoder.decode_count_bit / 8) + 1);
+}
+
+SubGhzProtocolStatus tpms_protocol_decoder_schrader_eg53ma4_serialize(
+    void* context,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+    return tpms_block_generic_serialize(&instance->generic, flipper_format, preset);
+}
+
+SubGhzProtocolStatus tpms_protocol_decoder_schrader_eg53ma4_deserialize(
+    void* context,
+    FlipperFormat* flipper_format) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+    return tpms_block_generic_deserialize_check_count_bit(
+        &instance->generic,
+        flipper_format,
+        tpms_protocol_schrader_eg53ma4_const.min_count_bit_for_found);
+}
+
+void tpms_protocol_decoder_schrader_eg53ma4_get_string(void* context, FuriString* output) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderEG53MA4* instance = context;
+    furi_string_printf(
+        output,
+        "%s\r\n"
+        "Id:0x%06lX\r\n"
+        "Temp:%2.0f C Bar:%2.1f",
+        instance->generic.protocol_name,
+        instance->generic.id,
+        (double)instance->generic.temperature,
+        (double)instance->generic.pressure);
+}
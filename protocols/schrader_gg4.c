@@ -1,5 +1,5 @@
 #include "schrader_gg4.h"
-#include <lib/toolbox/manchester_decoder.h>
+#include "tpms_manchester.h"
 
 #define TAG "Schrader"
 
@@ -33,16 +33,41 @@ Data layout:
  *
 
 - The preamble is 0b000
-- S: always 0x30 in relearn state
+- S: status
+  - bit 7: pressure alarm, frame is sent out of schedule
+  - bit 6: low battery
+  - bits 5-4: mode, 0b00 parked, 0b01 and 0b10 driving, 0b11 relearn (0x30 with a tool)
+  - bits 3-0: frame counter while driving, not part of the measurement
 - I: 32 bit ID
 - P: 8 bit Pressure (multiplyed by 2.5 = PSI)
 - T: 8 bit Temperature (deg. C offset by 50)
 - C: 8 bit Checksum (CRC8, Poly 0x7, Init 0x0)
+
+A burst carries several copies of the frame. They are aggregated into one event, emitted
+when no new frame starts for BURST_GAP_US, with repeat count and per-repeat CRC status.
+Status is not covered by the CRC, so repeats are matched on bytes 1-7 only. A frame that
+fails the CRC counts as a failed repeat only when it carries the ID of the burst. A frame with
+the alarm flag is emitted at once, the rest of its burst only updates the counters.
+
+A sync pulse inside a frame restarts the decoder. The frame in progress cannot be finished:
+the bits after the sync belong to the new frame, whatever state it would be decoded with.
 */
 
 #define PREAMBLE 0b000
 #define PREAMBLE_BITS_LEN 3
 
+#define BURST_GAP_US 20000
+#define BURST_REPEATS_MAX 8
+
+#define STATUS_ALARM (1 << 7)
+#define STATUS_BATTERY_LOW (1 << 6)
+#define STATUS_MODE_SHIFT 4
+#define STATUS_MODE_MASK 0x3
+
+// Bytes 1-7: everything but the status byte
+#define FRAME_PAYLOAD_MASK 0x00FFFFFFFFFFFFFFULL
+#define FRAME_ID(data) ((uint32_t)((data) >> 24))
+
 static const SubGhzBlockConst tpms_protocol_schrader_gg4_const = {
     .te_short = 120,
     .te_long = 240,
@@ -53,11 +78,20 @@ static const SubGhzBlockConst tpms_protocol_schrader_gg4_const = {
 struct TPMSProtocolDecoderSchraderGG4 {
     SubGhzProtocolDecoderBase base;
 
+    // Pulse classifier and Manchester stage, shared with Schrader EG53MA4
+    TPMSManchesterFrontEnd* front_end;
+
     SubGhzBlockDecoder decoder;
+    uint16_t header_count;
     TPMSBlockGeneric generic;
 
-    ManchesterState manchester_saved_state;
-    uint16_t header_count;
+    uint64_t burst_data;
+    uint32_t burst_id; // ID of the first frame, until a frame passes the CRC
+    uint32_t burst_idle;
+    float burst_rssi;
+    uint8_t burst_repeats;
+    uint8_t burst_crc_ok_mask;
+    bool burst_emitted;
 };
 
 struct TPMSProtocolEncoderSchraderGG4 {
@@ -112,12 +146,14 @@ void* tpms_protocol_decoder_schrader_gg4_alloc(SubGhzEnvironment* environment) {
     TPMSProtocolDecoderSchraderGG4* instance = malloc(sizeof(TPMSProtocolDecoderSchraderGG4));
     instance->base.protocol = &tpms_protocol_schrader_gg4;
     instance->generic.protocol_name = instance->base.protocol->name;
+    instance->front_end = tpms_manchester_front_end_acquire(&tpms_protocol_schrader_gg4_const);
     return instance;
 }
 
 void tpms_protocol_decoder_schrader_gg4_free(void* context) {
     furi_assert(context);
     TPMSProtocolDecoderSchraderGG4* instance = context;
+    tpms_manchester_front_end_release(instance->front_end);
     free(instance);
 }
 
@@ -125,19 +161,16 @@ void tpms_protocol_decoder_schrader_gg4_reset(void* context) {
     furi_assert(context);
     TPMSProtocolDecoderSchraderGG4* instance = context;
     instance->decoder.parser_step = SchraderGG4DecoderStepReset;
+    instance->burst_repeats = 0;
+    instance->burst_crc_ok_mask = 0;
+    instance->burst_emitted = false;
 }
 
-static bool tpms_protocol_schrader_gg4_check_crc(TPMSProtocolDecoderSchraderGG4* instance) {
-    uint8_t msg[] = {
-        instance->decoder.decode_data >> 48,
-        instance->decoder.decode_data >> 40,
-        instance->decoder.decode_data >> 32,
-        instance->decoder.decode_data >> 24,
-        instance->decoder.decode_data >> 16,
-        instance->decoder.decode_data >> 8};
+static bool tpms_protocol_schrader_gg4_check_crc(uint64_t data) {
+    uint8_t msg[] = {data >> 48, data >> 40, data >> 32, data >> 24, data >> 16, data >> 8};
 
     uint8_t crc = subghz_protocol_blocks_crc8(msg, 6, 0x7, 0);
-    return (crc == (instance->decoder.decode_data & 0xFF));
+    return (crc == (data & 0xFF));
 }
 
 /**
@@ -145,82 +178,98 @@ static bool tpms_protocol_schrader_gg4_check_crc(TPMSProtocolDecoderSchraderGG4*
  * @param instance Pointer to a TPMSBlockGeneric* instance
  */
 static void tpms_protocol_schrader_gg4_analyze(TPMSBlockGeneric* instance) {
+    static const TPMSMode modes[] = {
+        TPMSModeParked, TPMSModeDriving, TPMSModeDriving, TPMSModeRelearn};
+    uint8_t status = instance->data >> 56;
+
     instance->id = instance->data >> 24;
 
-    // TODO locate and fix
-    instance->battery_low = TPMS_NO_BATT;
+    instance->battery_low = (status & STATUS_BATTERY_LOW) ? 1 : 0;
+    instance->alarm = (status & STATUS_ALARM) != 0;
+    instance->mode = modes[(status >> STATUS_MODE_SHIFT) & STATUS_MODE_MASK];
 
     instance->temperature = ((instance->data >> 8) & 0xFF) - 50;
     instance->pressure = ((instance->data >> 16) & 0xFF) * 2.5 * 0.069;
 }
 
-static ManchesterEvent level_and_duration_to_event(bool level, uint32_t duration) {
-    bool is_long = false;
+static void tpms_protocol_schrader_gg4_burst_emit(TPMSProtocolDecoderSchraderGG4* instance) {
+    instance->generic.data = instance->burst_data;
+    instance->generic.data_count_bit = tpms_protocol_schrader_gg4_const.min_count_bit_for_found;
+    instance->generic.repeat_count = instance->burst_repeats;
+    instance->generic.crc_ok_mask = instance->burst_crc_ok_mask;
+    instance->generic.rssi = instance->burst_rssi;
+    tpms_protocol_schrader_gg4_analyze(&instance->generic);
+    instance->burst_emitted = true;
+    if(instance->base.callback) instance->base.callback(&instance->base, instance->base.context);
+}
 
-    if(DURATION_DIFF(duration, tpms_protocol_schrader_gg4_const.te_long) <
-       tpms_protocol_schrader_gg4_const.te_delta) {
-        is_long = true;
+static void tpms_protocol_schrader_gg4_burst_end(TPMSProtocolDecoderSchraderGG4* instance) {
+    if(instance->burst_crc_ok_mask && !instance->burst_emitted) {
+        tpms_protocol_schrader_gg4_burst_emit(instance);
+    }
+    instance->burst_repeats = 0;
+    instance->burst_crc_ok_mask = 0;
+    instance->burst_emitted = false;
+}
+
+static void
+    tpms_protocol_schrader_gg4_burst_add(TPMSProtocolDecoderSchraderGG4* instance, uint64_t data) {
+    bool crc_ok = tpms_protocol_schrader_gg4_check_crc(data);
+    bool same_id = instance->burst_repeats && FRAME_ID(data) == instance->burst_id;
+    if(!crc_ok) {
+        FURI_LOG_D(TAG, "CRC mismatch");
+        // Not a repeat of this burst, nothing says which sensor sent it
+        if(instance->burst_repeats && !same_id) return;
     } else if(
-        DURATION_DIFF(duration, tpms_protocol_schrader_gg4_const.te_short) <
-        tpms_protocol_schrader_gg4_const.te_delta) {
-        is_long = false;
-    } else {
-        return ManchesterEventReset;
+        instance->burst_crc_ok_mask &&
+        (instance->burst_data & FRAME_PAYLOAD_MASK) != (data & FRAME_PAYLOAD_MASK)) {
+        // Another sensor right after the previous one
+        tpms_protocol_schrader_gg4_burst_end(instance);
+    } else if(!instance->burst_crc_ok_mask && instance->burst_repeats && !same_id) {
+        // Failed frames so far were another sensor's
+        instance->burst_repeats = 0;
     }
 
-    if(level)
-        return is_long ? ManchesterEventLongHigh : ManchesterEventShortHigh;
-    else
-        return is_long ? ManchesterEventLongLow : ManchesterEventShortLow;
+    if(!instance->burst_repeats) instance->burst_id = FRAME_ID(data);
+    if(crc_ok && !instance->burst_crc_ok_mask) {
+        instance->burst_data = data;
+        // Sampled while the rest of the burst is still on air
+        instance->burst_rssi = furi_hal_subghz_get_rssi();
+    }
+    if(crc_ok && instance->burst_repeats < BURST_REPEATS_MAX) {
+        instance->burst_crc_ok_mask |= 1 << instance->burst_repeats;
+    }
+    if(instance->burst_repeats < UINT8_MAX) instance->burst_repeats++;
+    instance->burst_idle = 0;
+
+    // Alarm is not held back until the burst is over
+    if(crc_ok && (data >> 56) & STATUS_ALARM && !instance->burst_emitted) {
+        instance->burst_data = data;
+        tpms_protocol_schrader_gg4_burst_emit(instance);
+    }
 }
 
-void tpms_protocol_decoder_schrader_gg4_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    bool bit = false;
-    bool have_bit = false;
-    TPMSProtocolDecoderSchraderGG4* instance = context;
+static void tpms_protocol_schrader_gg4_symbol_feed(
+    TPMSProtocolDecoderSchraderGG4* instance,
+    const TPMSManchesterSymbol* symbol) {
+    bool bit = symbol->bit;
 
     // low-level bit sequence decoding
-    if(instance->decoder.parser_step != SchraderGG4DecoderStepReset) {
-        ManchesterEvent event = level_and_duration_to_event(level, duration);
-
-        if(event == ManchesterEventReset) {
-            if((instance->decoder.parser_step == SchraderGG4DecoderStepDecoderData) &&
-               instance->decoder.decode_count_bit) {
-                // FURI_LOG_D(TAG, "%d-%ld", level, duration);
-                FURI_LOG_D(
-                    TAG,
-                    "reset accumulated %d bits: %llx",
-                    instance->decoder.decode_count_bit,
-                    instance->decoder.decode_data);
-            }
-
-            instance->decoder.parser_step = SchraderGG4DecoderStepReset;
-        } else {
-            have_bit = manchester_advance(
-                instance->manchester_saved_state, event, &instance->manchester_saved_state, &bit);
-            if(!have_bit) return;
-
-            // Invert value, due to signal is Manchester II and decoder is Manchester I
-            bit = !bit;
+    if(symbol->event == ManchesterEventReset) {
+        if((instance->decoder.parser_step == SchraderGG4DecoderStepDecoderData) &&
+           instance->decoder.decode_count_bit) {
+            FURI_LOG_D(
+                TAG,
+                "reset accumulated %d bits: %llx",
+                instance->decoder.decode_count_bit,
+                instance->decoder.decode_data);
         }
+        instance->decoder.parser_step = SchraderGG4DecoderStepReset;
+        return;
     }
+    if(!symbol->bit_valid) return;
 
     switch(instance->decoder.parser_step) {
-    case SchraderGG4DecoderStepReset:
-        // wait for start ~480us pulse
-        if((level) && (DURATION_DIFF(duration, tpms_protocol_schrader_gg4_const.te_long * 2) <
-                       tpms_protocol_schrader_gg4_const.te_delta)) {
-            instance->decoder.parser_step = SchraderGG4DecoderStepCheckPreamble;
-            instance->header_count = 0;
-            instance->decoder.decode_data = 0;
-            instance->decoder.decode_count_bit = 0;
-
-            // First will be short space, so set correct initial state for machine
-            // https://clearwater.com.au/images/rc5/rc5-state-machine.gif
-            instance->manchester_saved_state = ManchesterStateStart1;
-        }
-        break;
     case SchraderGG4DecoderStepCheckPreamble:
         if(bit != 0) {
             instance->decoder.parser_step = SchraderGG4DecoderStepReset;
@@ -237,26 +286,56 @@ void tpms_protocol_decoder_schrader_gg4_feed(void* context, bool level, uint32_t
         if(instance->decoder.decode_count_bit ==
            tpms_protocol_schrader_gg4_const.min_count_bit_for_found) {
             FURI_LOG_D(TAG, "%016llx", instance->decoder.decode_data);
-            if(!tpms_protocol_schrader_gg4_check_crc(instance)) {
-                FURI_LOG_D(TAG, "CRC mismatch drop");
-            } else {
-                instance->generic.data = instance->decoder.decode_data;
-                instance->generic.data_count_bit = instance->decoder.decode_count_bit;
-                tpms_protocol_schrader_gg4_analyze(&instance->generic);
-                if(instance->base.callback)
-                    instance->base.callback(&instance->base, instance->base.context);
-            }
+            tpms_protocol_schrader_gg4_burst_add(instance, instance->decoder.decode_data);
             instance->decoder.parser_step = SchraderGG4DecoderStepReset;
         }
         break;
     }
 }
 
+void tpms_protocol_decoder_schrader_gg4_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    TPMSProtocolDecoderSchraderGG4* instance = context;
+
+    // Start ~480us pulse is checked first, it starts a new frame over any frame in progress
+    bool sync = level && DURATION_DIFF(duration, tpms_protocol_schrader_gg4_const.te_long * 2) <
+                             tpms_protocol_schrader_gg4_const.te_delta;
+    bool in_frame = sync || instance->decoder.parser_step != SchraderGG4DecoderStepReset;
+
+    // Every pulse goes through the shared stage, so its Manchester state follows the signal.
+    // The sync is a reset there, which starts the state as a new frame needs it
+    const TPMSManchesterSymbol* symbol =
+        tpms_manchester_front_end_feed(instance->front_end, level, duration);
+
+    if(sync) {
+        if(instance->decoder.parser_step == SchraderGG4DecoderStepDecoderData) {
+            FURI_LOG_D(
+                TAG, "sync after %d bits, frame dropped", instance->decoder.decode_count_bit);
+        }
+        instance->decoder.parser_step = SchraderGG4DecoderStepCheckPreamble;
+        instance->header_count = 0;
+        instance->decoder.decode_data = 0;
+        instance->decoder.decode_count_bit = 0;
+    } else if(in_frame) {
+        tpms_protocol_schrader_gg4_symbol_feed(instance, symbol);
+    }
+
+    // Burst is over when no frame has been in progress for a while
+    if(instance->burst_repeats && !in_frame) {
+        instance->burst_idle += duration;
+        if(instance->burst_idle >= BURST_GAP_US) tpms_protocol_schrader_gg4_burst_end(instance);
+    }
+}
+
 uint8_t tpms_protocol_decoder_schrader_gg4_get_hash_data(void* context) {
     furi_assert(context);
     TPMSProtocolDecoderSchraderGG4* instance = context;
-    return subghz_protocol_blocks_get_hash_data(
-        &instance->decoder, (instance->decoder.decode_count_bit / 8) + 1);
+    // Hash the emitted frame, the block decoder already holds the next one
+    SubGhzBlockDecoder decoder = {
+        .decode_data = instance->generic.data,
+        .decode_count_bit = instance->generic.data_count_bit,
+    };
+    return subghz_protocol_blocks_get_hash_data(&decoder, (decoder.decode_count_bit / 8) + 1);
 }
 
 SubGhzProtocolStatus tpms_protocol_decoder_schrader_gg4_serialize(
@@ -286,10 +365,14 @@ void tpms_protocol_decoder_schrader_gg4_get_string(void* context, FuriString* ou
         "%s\r\n"
         "Id:0x%08lX\r\n"
         "Bat:%d\r\n"
-        "Temp:%2.0f C Bar:%2.1f",
+        "Temp:%2.0f C Bar:%2.1f\r\n"
+        "Rep:%d Rssi:%.0f%s",
         instance->generic.protocol_name,
         instance->generic.id,
         instance->generic.battery_low,
         (double)instance->generic.temperature,
-        (double)instance->generic.pressure);
+        (double)instance->generic.pressure,
+        instance->generic.repeat_count,
+        (double)instance->generic.rssi,
+        instance->generic.alarm ? " ALARM" : "");
 }
@@ -0,0 +1,301 @@
+#include "toyota_pmv107j.h"
+
+#define TAG "ToyotaPMV107J"
+
+// https://github.com/merbanan/rtl_433/blob/master/src/devices/tpms_toyota.c
+// https://fccid.io/PAXPMV107J
+
+/**
+ * Toyota PMV-107J (Pacific Industrial)
+
+OEM:
+Toyota 42607-33021
+Lexus
+
+* Frequency: 315MHz
+* Modulation: FSK
+* PCM 52us, data is differential Manchester
+
+Examples:
+1234abcd4e20806365
+1234abcd4d21806526
+0f0e5a21d61d0053bf
+
+Frame:
+- Preamble and sync 0b10101001111 in raw PCM bits
+- 72 bit of data, each bit is two PCM halves with a transition in the middle,
+  bit is 1 when the first half differs from the last half of the previous bit
+
+Data layout:
+ * | Byte 0-3  | Byte 4    | Byte 5    | Byte 6    | Byte 7    | Byte 8    |
+ * | --------- | --------- | --------- | --------- | --------- | --------- |
+ * | IIII ...  | SPPP PPPP | PTTT TTTT | TSSS SSSS | pppp pppp | CCCC CCCC |
+ *
+
+- I: 32 bit ID
+- S: 8 bit status, not decoded
+- P: 8 bit Pressure (multiplyed by 0.25 minus 7 = PSI)
+- T: 8 bit Temperature (deg. C offset by 40)
+- p: inverted Pressure
+- C: 8 bit Checksum (CRC8, Poly 0x7, Init 0x80) of bytes 0-7
+
+Bytes 0-7 are kept as 64 bit data.
+*/
+
+#define SYNC 0b10101001111
+// Sync ends with a run of four 1, the rest is compared against the shift register
+#define SYNC_TAIL_LEN 4
+#define SYNC_HEAD (SYNC >> SYNC_TAIL_LEN)
+#define SYNC_HEAD_MASK 0x7F
+
+#define FRAME_BITS_LEN 72
+
+static const SubGhzBlockConst tpms_protocol_toyota_pmv107j_const = {
+    .te_short = 52,
+    .te_long = 104,
+    .te_delta = 20,
+    .min_count_bit_for_found = 64,
+};
+
+struct TPMSProtocolDecoderToyotaPMV107J {
+    SubGhzProtocolDecoderBase base;
+
+    SubGhzBlockDecoder decoder;
+    TPMSBlockGeneric generic;
+
+    uint16_t sync_shift;
+    uint8_t half_count;
+    bool half_first;
+    bool half_prev;
+    uint8_t frame[FRAME_BITS_LEN / 8];
+};
+
+struct TPMSProtocolEncoderToyotaPMV107J {
+    SubGhzProtocolEncoderBase base;
+
+    SubGhzProtocolBlockEncoder encoder;
+    TPMSBlockGeneric generic;
+};
+
+typedef enum {
+    ToyotaPMV107JDecoderStepReset = 0,
+    ToyotaPMV107JDecoderStepDecoderData,
+} ToyotaPMV107JDecoderStep;
+
+const SubGhzProtocolDecoder tpms_protocol_toyota_pmv107j_decoder = {
+    .alloc = tpms_protocol_decoder_toyota_pmv107j_alloc,
+    .free = tpms_protocol_decoder_toyota_pmv107j_free,
+
+    .feed = tpms_protocol_decoder_toyota_pmv107j_feed,
+    .reset = tpms_protocol_decoder_toyota_pmv107j_reset,
+
+    .get_hash_data = tpms_protocol_decoder_toyota_pmv107j_get_hash_data,
+    .serialize = tpms_protocol_decoder_toyota_pmv107j_serialize,
+    .deserialize = tpms_protocol_decoder_toyota_pmv107j_deserialize,
+    .get_string = tpms_protocol_decoder_toyota_pmv107j_get_string,
+};
+
+const SubGhzProtocolEncoder tpms_protocol_toyota_pmv107j_encoder = {
+    .alloc = NULL,
+    .free = NULL,
+
+    .deserialize = NULL,
+    .stop = NULL,
+    .yield = NULL,
+};
+
+const SubGhzProtocol tpms_protocol_toyota_pmv107j = {
+    .name = TPMS_PROTOCOL_TOYOTA_PMV107J_NAME,
+    .type = SubGhzProtocolTypeStatic,
+    .flag = SubGhzProtocolFlag_315 | SubGhzProtocolFlag_FM | SubGhzProtocolFlag_Decodable,
+
+    .decoder = &tpms_protocol_toyota_pmv107j_decoder,
+    .encoder = &tpms_protocol_toyota_pmv107j_encoder,
+};
+
+void* tpms_protocol_decoder_toyota_pmv107j_alloc(SubGhzEnvironment* environment) {
+    UNUSED(environment);
+    TPMSProtocolDecoderToyotaPMV107J* instance = malloc(sizeof(TPMSProtocolDecoderToyotaPMV107J));
+    instance->base.protocol = &tpms_protocol_toyota_pmv107j;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    return instance;
+}
+
+void tpms_protocol_decoder_toyota_pmv107j_free(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+    free(instance);
+}
+
+void tpms_protocol_decoder_toyota_pmv107j_reset(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+    instance->decoder.parser_step = ToyotaPMV107JDecoderStepReset;
+    instance->sync_shift = 0;
+}
+
+static bool tpms_protocol_toyota_pmv107j_check_crc(TPMSProtocolDecoderToyotaPMV107J* instance) {
+    uint8_t crc = subghz_protocol_blocks_crc8(instance->frame, 8, 0x7, 0x80);
+    return (crc == instance->frame[8]);
+}
+
+/**
+ * Analysis of received data
+ * @param instance Pointer to a TPMSBlockGeneric* instance
+ */
+static void tpms_protocol_toyota_pmv107j_analyze(TPMSBlockGeneric* instance) {
+    instance->id = instance->data >> 32;
+
+    instance->battery_low = TPMS_NO_BATT;
+
+    // 9 bit fields straddle byte boundaries: P at bits 30..23, T at 22..15
+    uint8_t pressure = (instance->data >> 23) & 0xFF;
+    uint8_t temperature = (instance->data >> 15) & 0xFF;
+    instance->temperature = temperature - 40;
+    instance->pressure = (pressure * 0.25 - 7) * 0.069;
+}
+
+static void tpms_protocol_toyota_pmv107j_frame_end(TPMSProtocolDecoderToyotaPMV107J* instance) {
+    instance->decoder.parser_step = ToyotaPMV107JDecoderStepReset;
+
+    if(!tpms_protocol_toyota_pmv107j_check_crc(instance)) {
+        FURI_LOG_D(TAG, "CRC mismatch");
+        return;
+    }
+    uint8_t pressure = (instance->frame[4] & 0x7F) << 1 | instance->frame[5] >> 7;
+    uint8_t pressure_inv = ~instance->frame[7];
+    if(pressure_inv != pressure) {
+        FURI_LOG_D(TAG, "Pressure check mismatch");
+        return;
+    }
+
+    instance->generic.data = 0;
+    for(uint8_t i = 0; i < 8; i++) {
+        instance->generic.data = instance->generic.data << 8 | instance->frame[i];
+    }
+    FURI_LOG_D(TAG, "%016llx", instance->generic.data);
+    instance->generic.data_count_bit = tpms_protocol_toyota_pmv107j_const.min_count_bit_for_found;
+    tpms_protocol_toyota_pmv107j_analyze(&instance->generic);
+    if(instance->base.callback) instance->base.callback(&instance->base, instance->base.context);
+}
+
+static void tpms_protocol_toyota_pmv107j_add_half(
+    TPMSProtocolDecoderToyotaPMV107J* instance,
+    bool half) {
+    if(!(instance->half_count++ & 1)) {
+        instance->half_first = half;
+        return;
+    }
+    if(half == instance->half_first) {
+        // No transition in the middle of the bit
+        FURI_LOG_D(TAG, "reset accumulated %d bits", instance->decoder.decode_count_bit);
+        instance->decoder.parser_step = ToyotaPMV107JDecoderStepReset;
+        return;
+    }
+
+    uint16_t count = instance->decoder.decode_count_bit;
+    bool bit = instance->half_first != instance->half_prev;
+    instance->half_prev = half;
+    instance->frame[count / 8] |= bit << (7 - count % 8);
+    instance->decoder.decode_count_bit++;
+
+    if(instance->decoder.decode_count_bit == FRAME_BITS_LEN) {
+        tpms_protocol_toyota_pmv107j_frame_end(instance);
+    }
+}
+
+void tpms_protocol_decoder_toyota_pmv107j_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+
+    // Number of PCM bits in this pulse
+    uint32_t bits = (duration + tpms_protocol_toyota_pmv107j_const.te_short / 2) /
+                    tpms_protocol_toyota_pmv107j_const.te_short;
+    if(bits == 0 ||
+       (bits < 16 && DURATION_DIFF(duration, bits * tpms_protocol_toyota_pmv107j_const.te_short) >
+                         tpms_protocol_toyota_pmv107j_const.te_delta)) {
+        instance->decoder.parser_step = ToyotaPMV107JDecoderStepReset;
+        instance->sync_shift = 0;
+        return;
+    }
+
+    switch(instance->decoder.parser_step) {
+    case ToyotaPMV107JDecoderStepReset:
+        // Whole pulse is shifted in at once, sync can only complete on its run of 1
+        if(level && bits >= SYNC_TAIL_LEN && bits <= SYNC_TAIL_LEN + 2 &&
+           (instance->sync_shift & SYNC_HEAD_MASK) == SYNC_HEAD) {
+            instance->decoder.parser_step = ToyotaPMV107JDecoderStepDecoderData;
+            instance->decoder.decode_count_bit = 0;
+            instance->half_count = 0;
+            instance->half_prev = true;
+            memset(instance->frame, 0, sizeof(instance->frame));
+            // Halves after the sync already belong to the first bit
+            for(bits -= SYNC_TAIL_LEN; bits; bits--) {
+                tpms_protocol_toyota_pmv107j_add_half(instance, level);
+            }
+            instance->sync_shift = 0;
+            break;
+        }
+        if(bits >= 16) {
+            instance->sync_shift = level ? UINT16_MAX : 0;
+        } else {
+            instance->sync_shift = instance->sync_shift << bits | (level ? (1 << bits) - 1 : 0);
+        }
+        break;
+
+    case ToyotaPMV107JDecoderStepDecoderData:
+        // Last bit may merge into the silence, a longer run stops at the third half
+        for(; bits && instance->decoder.parser_step == ToyotaPMV107JDecoderStepDecoderData;
+            bits--) {
+            tpms_protocol_toyota_pmv107j_add_half(instance, level);
+        }
+        if(instance->decoder.parser_step == ToyotaPMV107JDecoderStepReset && bits) {
+            instance->sync_shift = level ? UINT16_MAX : 0;
+        }
+        break;
+    }
+}
+
+uint8_t tpms_protocol_decoder_toyota_pmv107j_get_hash_data(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+    SubGhzBlockDecoder decoder = {
+        .decode_data = instance->generic.data,
+        .decode_count_bit = instance->generic.data_count_bit,
+    };
+    return subghz_protocol_blocks_get_hash_data(&decoder, (decoder.decode_count_bit / 8) + 1);
+}
+
+SubGhzProtocolStatus tpms_protocol_decoder_toyota_pmv107j_serialize(
+    void* context,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+    return tpms_block_generic_serialize(&instance->generic, flipper_format, preset);
+}
+
+SubGhzProtocolStatus tpms_protocol_decoder_toyota_pmv107j_deserialize(
+    void* context,
+    FlipperFormat* flipper_format) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+    return tpms_block_generic_deserialize_check_count_bit(
+        &instance->generic,
+        flipper_format,
+        tpms_protocol_toyota_pmv107j_const.min_count_bit_for_found);
+}
+
+void tpms_protocol_decoder_toyota_pmv107j_get_string(void* context, FuriString* output) {
+    furi_assert(context);
+    TPMSProtocolDecoderToyotaPMV107J* instance = context;
+    furi_string_printf(
+        output,
+        "%s\r\n"
+        "Id:0x%08lX\r\n"
+        "Temp:%2.0f C Bar:%2.1f",
+        instance->generic.protocol_name,
+        instance->generic.id,
+        (double)instance->generic.temperature,
+        (double)instance->generic.pressure);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <lib/subghz/protocols/base.h>
+
+#include <lib/subghz/blocks/const.h>
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/encoder.h>
+#include "tpms_generic.h"
+#include <lib/subghz/blocks/math.h>
+
+#define TPMS_PROTOCOL_TOYOTA_PMV107J_NAME "Toyota PMV-107J"
+
+typedef struct TPMSProtocolDecoderToyotaPMV107J TPMSProtocolDecoderToyotaPMV107J;
+typedef struct TPMSProtocolEncoderToyotaPMV107J TPMSProtocolEncoderToyotaPMV107J;
+
+extern const SubGhzProtocolDecoder tpms_protocol_toyota_pmv107j_decoder;
+extern const SubGhzProtocolEncoder tpms_protocol_toyota_pmv107j_encoder;
+extern const SubGhzProtocol tpms_protocol_toyota_pmv107j;
+
+/**
+ * Allocate TPMSProtocolDecoderToyotaPMV107J.
+ * @param environment Pointer to a SubGhzEnvironment instance
+ * @return TPMSProtocolDecoderToyotaPMV107J* pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ */
+void* tpms_protocol_decoder_toyota_pmv107j_alloc(SubGhzEnvironment* environment);
+
+/**
+ * Free TPMSProtocolDecoderToyotaPMV107J.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ */
+void tpms_protocol_decoder_toyota_pmv107j_free(void* context);
+
+/**
+ * Reset decoder TPMSProtocolDecoderToyotaPMV107J.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ */
+void tpms_protocol_decoder_toyota_pmv107j_reset(void* context);
+
+/**
+ * Parse a raw sequence of levels and durations received from the air.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ * @param level Signal level true-high false-low
+ * @param duration Duration of this level in, us
+ */
+void tpms_protocol_decoder_toyota_pmv107j_feed(void* context, bool level, uint32_t duration);
+
+/**
+ * Getting the hash sum of the last randomly received parcel.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ * @return hash Hash sum
+ */
+uint8_t tpms_protocol_decoder_toyota_pmv107j_get_hash_data(void* context);
+
+/**
+ * Serialize data TPMSProtocolDecoderToyotaPMV107J.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param preset The modulation on which the signal was received, SubGhzRadioPreset
+ * @return status
+ */
+SubGhzProtocolStatus tpms_protocol_decoder_toyota_pmv107j_serialize(
+    void* context,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset);
+
+/**
+ * Deserialize data TPMSProtocolDecoderToyotaPMV107J.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return status
+ */
+SubGhzProtocolStatus
+    tpms_protocol_decoder_toyota_pmv107j_deserialize(void* context, FlipperFormat* flipper_format);
+
+/**
+ * Getting a textual representation of the received data.
+ * @param context Pointer to a TPMSProtocolDecoderToyotaPMV107J instance
+ * @param output Resulting text
+ */
+void tpms_protocol_decoder_toyota_pmv107j_get_string(void* context, FuriString* output);
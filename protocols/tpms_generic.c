@@ -2,6 +2,7 @@
 #include <lib/toolbox/stream/stream.h>
 #include <lib/flipper_format/flipper_format_i.h>
 #include "../helpers/tpms_types.h"
+#include "../helpers/tpms_clock.h"
 
 #define TAG "TPMSBlockGeneric"
 
@@ -110,12 +111,9 @@ SubGhzProtocolStatus tpms_block_generic_serialize(
             break;
         }
 
-        //DATE AGE set
-        DateTime curr_dt;
-        furi_hal_rtc_get_datetime(&curr_dt);
-        uint32_t curr_ts = datetime_datetime_to_timestamp(&curr_dt);
-
-        temp_data = curr_ts;
+        //DATE AGE set, counted on the tick from the clock anchor
+        uint16_t curr_ms = 0;
+        temp_data = tpms_clock_get_timestamp(&curr_ms);
         if(!flipper_format_write_uint32(flipper_format, "Ts", &temp_data, 1)) {
             FURI_LOG_E(TAG, "Unable to add timestamp");
             res = SubGhzProtocolStatusErrorParserOthers;
@@ -129,6 +127,48 @@ SubGhzProtocolStatus tpms_block_generic_serialize(
             break;
         }
 
+        temp = instance->rssi;
+        if(!flipper_format_write_float(flipper_format, "Rssi", &temp, 1)) {
+            FURI_LOG_E(TAG, "Unable to add Rssi");
+            res = SubGhzProtocolStatusErrorParserOthers;
+            break;
+        }
+
+        temp_data = instance->repeat_count;
+        if(!flipper_format_write_uint32(flipper_format, "Repeats", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Unable to add Repeats");
+            res = SubGhzProtocolStatusErrorParserOthers;
+            break;
+        }
+
+        temp_data = instance->crc_ok_mask;
+        if(!flipper_format_write_uint32(flipper_format, "Crc_ok", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Unable to add Crc_ok");
+            res = SubGhzProtocolStatusErrorParserOthers;
+            break;
+        }
+
+        temp_data = instance->mode;
+        if(!flipper_format_write_uint32(flipper_format, "Mode", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Unable to add Mode");
+            res = SubGhzProtocolStatusErrorParserOthers;
+            break;
+        }
+
+        temp_data = instance->alarm;
+        if(!flipper_format_write_uint32(flipper_format, "Alarm", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Unable to add Alarm");
+            res = SubGhzProtocolStatusErrorParserOthers;
+            break;
+        }
+
+        temp_data = curr_ms;
+        if(!flipper_format_write_uint32(flipper_format, "Ts_ms", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Unable to add timestamp ms");
+            res = SubGhzProtocolStatusErrorParserOthers;
+            break;
+        }
+
         res = SubGhzProtocolStatusOk;
     } while(false);
     furi_string_free(temp_str);
@@ -202,6 +242,22 @@ SubGhzProtocolStatus
         }
         instance->temperature = temp;
 
+        // Burst quality, absent in records saved before aggregation
+        instance->rssi = flipper_format_read_float(flipper_format, "Rssi", &temp, 1) ? temp : 0;
+        instance->repeat_count =
+            flipper_format_read_uint32(flipper_format, "Repeats", &temp_data, 1) ? temp_data : 0;
+        instance->crc_ok_mask =
+            flipper_format_read_uint32(flipper_format, "Crc_ok", &temp_data, 1) ? temp_data : 0;
+
+        // Sensor status, absent in older records and protocols without it
+        instance->mode =
+            flipper_format_read_uint32(flipper_format, "Mode", &temp_data, 1) ? temp_data : 0;
+        instance->alarm =
+            flipper_format_read_uint32(flipper_format, "Alarm", &temp_data, 1) && temp_data;
+        // Absent in records saved before millisecond timestamps
+        instance->timestamp_ms =
+            flipper_format_read_uint32(flipper_format, "Ts_ms", &temp_data, 1) ? temp_data : 0;
+
         res = SubGhzProtocolStatusOk;
     } while(0);
 
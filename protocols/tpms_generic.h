@@ -16,6 +16,14 @@ extern "C" {
 
 #define TPMS_NO_BATT 0xFF
 
+/** Operating mode reported by the sensor, when the protocol carries it */
+typedef enum {
+    TPMSModeUnknown = 0,
+    TPMSModeParked,
+    TPMSModeDriving,
+    TPMSModeRelearn,
+} TPMSMode;
+
 typedef struct TPMSBlockGeneric TPMSBlockGeneric;
 
 struct TPMSBlockGeneric {
@@ -24,12 +32,20 @@ struct TPMSBlockGeneric {
     uint8_t data_count_bit;
 
     uint32_t timestamp;
+    uint16_t timestamp_ms; // milliseconds past timestamp
 
     uint32_t id;
     uint8_t battery_low;
     // bool storage;
     float pressure; // bar
     float temperature; // celsius
+
+    float rssi; // dBm, sampled while the burst was on air
+    uint8_t repeat_count; // frames received in the burst
+    uint8_t crc_ok_mask; // bit n set when repeat n passed CRC
+
+    uint8_t mode; // TPMSMode
+    bool alarm; // sensor signals a pressure alarm
 };
 
 /**
@@ -0,0 +1,108 @@
+#include "tpms_manchester.h"
+#include <lib/subghz/blocks/math.h>
+
+#include <furi.h>
+
+// Decoders with different timing each get their own
+#define FRONT_ENDS_MAX 2
+
+// Manchester states and the four non reset events, ManchesterEventShortLow to LongHigh
+#define STATES 4
+#define EVENTS 4
+
+typedef struct {
+    uint8_t state : 2;
+    uint8_t bit_valid : 1;
+    uint8_t bit : 1;
+} TPMSManchesterStep;
+
+static TPMSManchesterFrontEnd tpms_manchester_front_ends[FRONT_ENDS_MAX];
+
+// tpms_manchester_advance for every state and event, filled once so a pulse is one lookup
+static TPMSManchesterStep tpms_manchester_steps[STATES][EVENTS];
+static bool tpms_manchester_steps_ready;
+
+ManchesterEvent
+    tpms_manchester_event(const SubGhzBlockConst* timing, bool level, uint32_t duration) {
+    if(DURATION_DIFF(duration, timing->te_long) < timing->te_delta) {
+        return level ? ManchesterEventLongHigh : ManchesterEventLongLow;
+    } else if(DURATION_DIFF(duration, timing->te_short) < timing->te_delta) {
+        return level ? ManchesterEventShortHigh : ManchesterEventShortLow;
+    }
+    return ManchesterEventReset;
+}
+
+bool tpms_manchester_advance(ManchesterState* state, ManchesterEvent event, bool* bit) {
+    if(!manchester_advance(*state, event, state, bit)) return false;
+    // Invert value, due to signal is Manchester II and decoder is Manchester I
+    *bit = !*bit;
+    return true;
+}
+
+TPMSManchesterFrontEnd* tpms_manchester_front_end_acquire(const SubGhzBlockConst* timing) {
+    TPMSManchesterFrontEnd* free_slot = NULL;
+    for(size_t i = 0; i < FRONT_ENDS_MAX; i++) {
+        TPMSManchesterFrontEnd* front_end = &tpms_manchester_front_ends[i];
+        if(!front_end->users) {
+            if(!free_slot) free_slot = front_end;
+        } else if(
+            front_end->te_short == timing->te_short && front_end->te_long == timing->te_long &&
+            front_end->te_delta == timing->te_delta) {
+            front_end->users++;
+            return front_end;
+        }
+    }
+    furi_check(free_slot);
+    if(!tpms_manchester_steps_ready) {
+        for(uint8_t state = 0; state < STATES; state++) {
+            for(uint8_t event = 0; event < EVENTS; event++) {
+                ManchesterState next = state;
+                bool bit = false;
+                bool bit_valid = tpms_manchester_advance(&next, event * 2, &bit);
+                tpms_manchester_steps[state][event] = (TPMSManchesterStep){
+                    .state = next, .bit_valid = bit_valid, .bit = bit};
+            }
+        }
+        tpms_manchester_steps_ready = true;
+    }
+    memset(free_slot, 0, sizeof(TPMSManchesterFrontEnd));
+    free_slot->te_short = timing->te_short;
+    free_slot->te_long = timing->te_long;
+    free_slot->te_delta = timing->te_delta;
+    free_slot->users = 1;
+    free_slot->state = ManchesterStateMid1;
+    return free_slot;
+}
+
+void tpms_manchester_front_end_release(TPMSManchesterFrontEnd* front_end) {
+    furi_assert(front_end);
+    furi_assert(front_end->users);
+    front_end->users--;
+    front_end->pending = 0;
+}
+
+const TPMSManchesterSymbol* tpms_manchester_front_end_update(
+    TPMSManchesterFrontEnd* front_end,
+    bool level,
+    uint32_t duration) {
+    front_end->level = level;
+    front_end->duration = duration;
+    front_end->pending = front_end->users - 1;
+
+    TPMSManchesterSymbol* symbol = &front_end->symbol;
+    if(DURATION_DIFF(duration, front_end->te_long) < front_end->te_delta) {
+        symbol->event = level ? ManchesterEventLongHigh : ManchesterEventLongLow;
+    } else if(DURATION_DIFF(duration, front_end->te_short) < front_end->te_delta) {
+        symbol->event = level ? ManchesterEventShortHigh : ManchesterEventShortLow;
+    } else {
+        symbol->event = ManchesterEventReset;
+        symbol->bit_valid = false;
+        front_end->state = level ? ManchesterStateStart1 : ManchesterStateMid1;
+        return symbol;
+    }
+    TPMSManchesterStep step = tpms_manchester_steps[front_end->state][symbol->event / 2];
+    front_end->state = step.state;
+    symbol->bit_valid = step.bit_valid;
+    symbol->bit = step.bit;
+    return symbol;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <lib/subghz/blocks/const.h>
+#include <lib/toolbox/manchester_decoder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Result of one pulse through the Manchester stage */
+typedef struct {
+    ManchesterEvent event;
+    bool bit_valid; // a bit was decoded
+    bool bit;
+} TPMSManchesterSymbol;
+
+/** Pulse classifier and Manchester stage shared by decoders with the same timing. Visible
+ * here so the shared pulse is taken without a call. */
+typedef struct {
+    uint16_t te_short;
+    uint16_t te_long;
+    uint16_t te_delta;
+    uint8_t users;
+
+    // Last pulse and how many users are still to take its symbol
+    bool level;
+    uint32_t duration;
+    uint8_t pending;
+
+    ManchesterState state;
+    TPMSManchesterSymbol symbol;
+} TPMSManchesterFrontEnd;
+
+/**
+ * Classify a pulse into a Manchester event, long is checked first.
+ * @param timing Protocol timing, te_short is a half bit
+ * @param level Signal level true-high false-low
+ * @param duration Duration of this level in, us
+ * @return ManchesterEvent, ManchesterEventReset if the duration fits neither half nor full bit
+ */
+ManchesterEvent
+    tpms_manchester_event(const SubGhzBlockConst* timing, bool level, uint32_t duration);
+
+/**
+ * Advance Manchester II state machine, high to low transition is bit 1.
+ * @param state Pointer to the decoder ManchesterState, updated in place
+ * @param event Event from tpms_manchester_event
+ * @param bit Output bit
+ * @return true if a bit was decoded
+ */
+bool tpms_manchester_advance(ManchesterState* state, ManchesterEvent event, bool* bit);
+
+/**
+ * Get the front end shared by all decoders with this timing, one per decoder instance.
+ * @param timing Protocol timing
+ * @return TPMSManchesterFrontEnd* pointer to the shared front end
+ */
+TPMSManchesterFrontEnd* tpms_manchester_front_end_acquire(const SubGhzBlockConst* timing);
+
+/**
+ * Give back a front end taken with tpms_manchester_front_end_acquire.
+ * @param front_end Pointer to a TPMSManchesterFrontEnd instance
+ */
+void tpms_manchester_front_end_release(TPMSManchesterFrontEnd* front_end);
+
+/**
+ * Classify a new pulse and advance the Manchester stage, use tpms_manchester_front_end_feed.
+ * @param front_end Pointer to a TPMSManchesterFrontEnd instance
+ * @param level Signal level true-high false-low
+ * @param duration Duration of this level in, us
+ * @return const TPMSManchesterSymbol* symbol of this pulse
+ */
+const TPMSManchesterSymbol* tpms_manchester_front_end_update(
+    TPMSManchesterFrontEnd* front_end,
+    bool level,
+    uint32_t duration);
+
+/**
+ * Run a pulse through the shared classifier and Manchester stage. The receiver feeds a pulse
+ * to every decoder in turn and every user must pass every pulse here: the first one does the
+ * work, the others get the same symbol. After a reset the stage starts from
+ * ManchesterStateStart1 if the pulse was high, a start pulse followed by a short space, or
+ * ManchesterStateMid1 if it was low, silence followed by the high half of a bit.
+ * @param front_end Pointer to a TPMSManchesterFrontEnd instance
+ * @param level Signal level true-high false-low
+ * @param duration Duration of this level in, us
+ * @return const TPMSManchesterSymbol* symbol of this pulse
+ */
+static inline const TPMSManchesterSymbol* tpms_manchester_front_end_feed(
+    TPMSManchesterFrontEnd* front_end,
+    bool level,
+    uint32_t duration) {
+    // Levels alternate, a pulse that matches the last one is the same pulse
+    if(front_end->pending && front_end->level == level && front_end->duration == duration) {
+        front_end->pending--;
+        return &front_end->symbol;
+    }
+    return tpms_manchester_front_end_update(front_end, level, duration);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,402 @@
+#include "vdo.h"
+
+#define TAG "VDO"
+
+// https://github.com/merbanan/rtl_433/blob/master/src/devices/tpms_citroen.c
+// https://github.com/merbanan/rtl_433/blob/master/src/devices/tpms_renault.c
+
+/**
+ * VDO (Continental) sensors of PSA, Renault and Ford
+
+OEM:
+Citroen, Peugeot 9673860880
+Renault 40700-JD01
+Ford 9L3T-1A180-AF
+
+* Frequency: 315MHz, 433.92MHz
+* Modulation: FSK
+* PCM 52us, data is Manchester, first half is the bit value
+
+All share the preamble and sync, so one decoder classifies pulses and tracks Manchester once
+for every family. The families have one frame length each, PSA 80 bits, Renault 72 and Ford 64,
+and the longest layout whose checksum validates wins. Readings are reported under the VDO
+protocol name, the family is only shown in the text of the reading.
+
+Hyundai/Kia VDO sensors use the same timing but are not decoded yet. Their layout is to come
+from a reference decoder with captured frames, and it must be told apart from Ford by frame
+length or sync, not by which checksum happens to validate. It is then one more layout below.
+
+Frame:
+- Preamble of alternating PCM bits, sync 0xAAA9 in raw PCM bits
+- Sync 0x5556 is the same with inverted FSK, data halves are inverted too
+- 64, 72 or 80 bit of data
+
+Examples PSA:
+028a3f2c1b01a5485a34
+028a3f2c1b02a6495a35
+007c11e5d031b0425ac1
+
+Data layout PSA:
+ * | Byte 0    | Byte 1-4  | Byte 5    | Byte 6    | Byte 7    | Byte 8    | Byte 9    |
+ * | --------- | --------- | --------- | --------- | --------- | --------- | --------- |
+ * | SSSS SSSS | IIII ...  | FFFF RRRR | PPPP PPPP | TTTT TTTT | BBBB BBBB | CCCC CCCC |
+ *
+
+- S: state, not covered by checksum
+- I: 32 bit ID
+- F: flags
+- R: repeat counter
+- P: 8 bit Pressure (multiplyed by 1.364 = kPa)
+- T: 8 bit Temperature (deg. C offset by 50)
+- B: probably battery, not decoded
+- C: 8 bit Checksum (XOR of bytes 1-9 is 0)
+
+Bytes 1-8 are kept as 64 bit data.
+
+Examples Renault:
+292c343d2c1b0040d7
+292d353d2c1b004021
+2533201a0f3c0040ff
+
+Data layout Renault:
+ * | Byte 0    | Byte 1    | Byte 2    | Byte 3-5  | Byte 6-7  | Byte 8    |
+ * | --------- | --------- | --------- | --------- | --------- | --------- |
+ * | FFFF FFPP | PPPP PPPP | TTTT TTTT | IIII ...  | ????      | CCCC CCCC |
+ *
+
+- F: 6 bit flags
+- P: 10 bit Pressure (multiplyed by 0.75 = kPa)
+- T: 8 bit Temperature (deg. C offset by 30)
+- I: 24 bit ID, little endian
+- C: 8 bit Checksum (CRC8, Poly 0x7, Init 0x0) of bytes 0-7
+
+Bytes 0-7 are kept as 64 bit data.
+
+Examples Ford:
+a2c4e6f28c4a0014
+a2c4e6f28d4b0016
+1f2e3d4c9a3820c8
+
+Data layout Ford:
+ * | Byte 0-3  | Byte 4    | Byte 5    | Byte 6    | Byte 7    |
+ * | --------- | --------- | --------- | --------- | --------- |
+ * | IIII ...  | PPPP PPPP | TTTT TTTT | FFPF FFFF | CCCC CCCC |
+ *
+
+- I: 32 bit ID
+- P: 9 bit Pressure, high bit is 0x20 of byte 6 (multiplyed by 0.25 = PSI)
+- T: 8 bit Temperature (deg. C offset by 56)
+- F: flags
+- C: 8 bit Checksum (sum of bytes 0-6)
+
+Bytes 0-7 are kept as 64 bit data.
+*/
+
+#define SYNC 0xAAA9
+#define SYNC_INVERTED 0x5556
+
+#define FRAME_BITS_LEN_MAX 80
+
+static const SubGhzBlockConst tpms_protocol_vdo_const = {
+    .te_short = 52,
+    .te_long = 104,
+    .te_delta = 20,
+    .min_count_bit_for_found = 64,
+};
+
+struct TPMSProtocolDecoderVDO {
+    SubGhzProtocolDecoderBase base;
+
+    SubGhzBlockDecoder decoder;
+    TPMSBlockGeneric generic;
+
+    uint16_t sync_shift;
+    bool inverted;
+    uint8_t half_count;
+    bool half_first;
+    uint8_t frame[FRAME_BITS_LEN_MAX / 8];
+    const char* family;
+};
+
+struct TPMSProtocolEncoderVDO {
+    SubGhzProtocolEncoderBase base;
+
+    SubGhzProtocolBlockEncoder encoder;
+    TPMSBlockGeneric generic;
+};
+
+typedef struct {
+    const char* family;
+    uint8_t frame_bits;
+    uint8_t data_byte; // first frame byte kept in generic data
+    bool (*check)(const uint8_t* frame);
+    void (*analyze)(TPMSBlockGeneric* instance);
+} VDOLayout;
+
+typedef enum {
+    VDODecoderStepReset = 0,
+    VDODecoderStepDecoderData,
+} VDODecoderStep;
+
+const SubGhzProtocolDecoder tpms_protocol_vdo_decoder = {
+    .alloc = tpms_protocol_decoder_vdo_alloc,
+    .free = tpms_protocol_decoder_vdo_free,
+
+    .feed = tpms_protocol_decoder_vdo_feed,
+    .reset = tpms_protocol_decoder_vdo_reset,
+
+    .get_hash_data = tpms_protocol_decoder_vdo_get_hash_data,
+    .serialize = tpms_protocol_decoder_vdo_serialize,
+    .deserialize = tpms_protocol_decoder_vdo_deserialize,
+    .get_string = tpms_protocol_decoder_vdo_get_string,
+};
+
+const SubGhzProtocolEncoder tpms_protocol_vdo_encoder = {
+    .alloc = NULL,
+    .free = NULL,
+
+    .deserialize = NULL,
+    .stop = NULL,
+    .yield = NULL,
+};
+
+const SubGhzProtocol tpms_protocol_vdo = {
+    .name = TPMS_PROTOCOL_VDO_NAME,
+    .type = SubGhzProtocolTypeStatic,
+    .flag = SubGhzProtocolFlag_433 | SubGhzProtocolFlag_315 | SubGhzProtocolFlag_FM |
+            SubGhzProtocolFlag_Decodable,
+
+    .decoder = &tpms_protocol_vdo_decoder,
+    .encoder = &tpms_protocol_vdo_encoder,
+};
+
+void* tpms_protocol_decoder_vdo_alloc(SubGhzEnvironment* environment) {
+    UNUSED(environment);
+    TPMSProtocolDecoderVDO* instance = malloc(sizeof(TPMSProtocolDecoderVDO));
+    instance->base.protocol = &tpms_protocol_vdo;
+    instance->generic.protocol_name = instance->base.protocol->name;
+    instance->family = NULL;
+    return instance;
+}
+
+void tpms_protocol_decoder_vdo_free(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+    free(instance);
+}
+
+void tpms_protocol_decoder_vdo_reset(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+    instance->decoder.parser_step = VDODecoderStepReset;
+    instance->sync_shift = 0;
+}
+
+static bool tpms_protocol_vdo_check_psa(const uint8_t* frame) {
+    return subghz_protocol_blocks_xor_bytes(&frame[1], 9) == 0;
+}
+
+static bool tpms_protocol_vdo_check_renault(const uint8_t* frame) {
+    return subghz_protocol_blocks_crc8(frame, 8, 0x7, 0) == frame[8];
+}
+
+static bool tpms_protocol_vdo_check_ford(const uint8_t* frame) {
+    return subghz_protocol_blocks_add_bytes(frame, 7) == frame[7];
+}
+
+/**
+ * Analysis of received PSA data
+ * @param instance Pointer to a TPMSBlockGeneric* instance
+ */
+static void tpms_protocol_vdo_analyze_psa(TPMSBlockGeneric* instance) {
+    instance->id = instance->data >> 32;
+
+    instance->battery_low = TPMS_NO_BATT;
+
+    instance->temperature = ((instance->data >> 8) & 0xFF) - 50;
+    instance->pressure = ((instance->data >> 16) & 0xFF) * 1.364 * 0.01;
+}
+
+/**
+ * Analysis of received Renault data
+ * @param instance Pointer to a TPMSBlockGeneric* instance
+ */
+static void tpms_protocol_vdo_analyze_renault(TPMSBlockGeneric* instance) {
+    instance->id = ((instance->data >> 16) & 0xFF) << 16 | ((instance->data >> 24) & 0xFF) << 8 |
+                   ((instance->data >> 32) & 0xFF);
+
+    instance->battery_low = TPMS_NO_BATT;
+
+    instance->temperature = ((instance->data >> 40) & 0xFF) - 30;
+    instance->pressure = ((instance->data >> 48) & 0x3FF) * 0.75 * 0.01;
+}
+
+/**
+ * Analysis of received Ford data
+ * @param instance Pointer to a TPMSBlockGeneric* instance
+ */
+static void tpms_protocol_vdo_analyze_ford(TPMSBlockGeneric* instance) {
+    instance->id = instance->data >> 32;
+
+    instance->battery_low = TPMS_NO_BATT;
+
+    uint16_t pressure = ((instance->data >> 5) & 0x100) | ((instance->data >> 24) & 0xFF);
+    instance->temperature = ((instance->data >> 16) & 0xFF) - 56;
+    instance->pressure = pressure * 0.25 * 0.069;
+}
+
+// Longest first, a shorter frame never reaches the length of a longer one
+static const VDOLayout tpms_protocol_vdo_layouts[] = {
+    {"PSA", 80, 1, tpms_protocol_vdo_check_psa, tpms_protocol_vdo_analyze_psa},
+    {"Renault", 72, 0, tpms_protocol_vdo_check_renault, tpms_protocol_vdo_analyze_renault},
+    {"Ford", 64, 0, tpms_protocol_vdo_check_ford, tpms_protocol_vdo_analyze_ford},
+};
+
+static void tpms_protocol_vdo_frame_end(TPMSProtocolDecoderVDO* instance) {
+    instance->decoder.parser_step = VDODecoderStepReset;
+
+    const VDOLayout* layout = NULL;
+    for(size_t i = 0; i < COUNT_OF(tpms_protocol_vdo_layouts); i++) {
+        if(instance->decoder.decode_count_bit >= tpms_protocol_vdo_layouts[i].frame_bits &&
+           tpms_protocol_vdo_layouts[i].check(instance->frame)) {
+            layout = &tpms_protocol_vdo_layouts[i];
+            break;
+        }
+    }
+    if(!layout) {
+        if(instance->decoder.decode_count_bit >= 64) {
+            FURI_LOG_D(TAG, "Checksum mismatch");
+        }
+        return;
+    }
+
+    instance->family = layout->family;
+    instance->generic.data = 0;
+    for(uint8_t i = layout->data_byte; i < layout->data_byte + 8; i++) {
+        instance->generic.data = instance->generic.data << 8 | instance->frame[i];
+    }
+    FURI_LOG_D(TAG, "%s %016llx", instance->family, instance->generic.data);
+    instance->generic.data_count_bit = tpms_protocol_vdo_const.min_count_bit_for_found;
+    layout->analyze(&instance->generic);
+    if(instance->base.callback) instance->base.callback(&instance->base, instance->base.context);
+}
+
+static void tpms_protocol_vdo_add_half(TPMSProtocolDecoderVDO* instance, bool half) {
+    if(!(instance->half_count++ & 1)) {
+        instance->half_first = half;
+        return;
+    }
+    if(half == instance->half_first) {
+        // No transition in the middle of the bit, frame is over
+        tpms_protocol_vdo_frame_end(instance);
+        return;
+    }
+
+    uint16_t count = instance->decoder.decode_count_bit;
+    bool bit = instance->half_first ^ instance->inverted;
+    instance->frame[count / 8] |= bit << (7 - count % 8);
+    instance->decoder.decode_count_bit++;
+
+    if(instance->decoder.decode_count_bit == FRAME_BITS_LEN_MAX) {
+        tpms_protocol_vdo_frame_end(instance);
+    }
+}
+
+void tpms_protocol_decoder_vdo_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+
+    // Number of PCM bits in this pulse
+    uint32_t bits = (duration + tpms_protocol_vdo_const.te_short / 2) /
+                    tpms_protocol_vdo_const.te_short;
+    if(bits == 0 ||
+       (bits < 16 && DURATION_DIFF(duration, bits * tpms_protocol_vdo_const.te_short) >
+                         tpms_protocol_vdo_const.te_delta)) {
+        if(instance->decoder.parser_step == VDODecoderStepDecoderData) {
+            tpms_protocol_vdo_frame_end(instance);
+        }
+        instance->sync_shift = 0;
+        return;
+    }
+
+    switch(instance->decoder.parser_step) {
+    case VDODecoderStepReset: {
+        // Both syncs end with a single bit, so they can only complete on the first bit of a pulse
+        uint16_t shift = instance->sync_shift << 1 | level;
+        if(shift == SYNC || shift == SYNC_INVERTED) {
+            instance->decoder.parser_step = VDODecoderStepDecoderData;
+            instance->decoder.decode_count_bit = 0;
+            instance->inverted = (shift == SYNC_INVERTED);
+            instance->half_count = 0;
+            memset(instance->frame, 0, sizeof(instance->frame));
+            instance->sync_shift = 0;
+            // Rest of the pulse is the first half of data
+            for(bits--; bits && instance->decoder.parser_step == VDODecoderStepDecoderData;
+                bits--) {
+                tpms_protocol_vdo_add_half(instance, level);
+            }
+            break;
+        }
+        if(bits >= 16) {
+            instance->sync_shift = level ? UINT16_MAX : 0;
+        } else {
+            instance->sync_shift = instance->sync_shift << bits | (level ? (1 << bits) - 1 : 0);
+        }
+        break;
+    }
+
+    case VDODecoderStepDecoderData:
+        // A longer run ends the frame at its third half
+        for(; bits && instance->decoder.parser_step == VDODecoderStepDecoderData; bits--) {
+            tpms_protocol_vdo_add_half(instance, level);
+        }
+        if(instance->decoder.parser_step == VDODecoderStepReset && bits) {
+            instance->sync_shift = level ? UINT16_MAX : 0;
+        }
+        break;
+    }
+}
+
+uint8_t tpms_protocol_decoder_vdo_get_hash_data(void* context) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+    SubGhzBlockDecoder decoder = {
+        .decode_data = instance->generic.data,
+        .decode_count_bit = instance->generic.data_count_bit,
+    };
+    return subghz_protocol_blocks_get_hash_data(&decoder, (decoder.decode_count_bit / 8) + 1);
+}
+
+SubGhzProtocolStatus tpms_protocol_decoder_vdo_serialize(
+    void* context,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+    return tpms_block_generic_serialize(&instance->generic, flipper_format, preset);
+}
+
+SubGhzProtocolStatus
+    tpms_protocol_decoder_vdo_deserialize(void* context, FlipperFormat* flipper_format) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+    // The family is not saved
+    instance->family = NULL;
+    return tpms_block_generic_deserialize_check_count_bit(
+        &instance->generic, flipper_format, tpms_protocol_vdo_const.min_count_bit_for_found);
+}
+
+void tpms_protocol_decoder_vdo_get_string(void* context, FuriString* output) {
+    furi_assert(context);
+    TPMSProtocolDecoderVDO* instance = context;
+    furi_string_printf(output, "%s", instance->generic.protocol_name);
+    if(instance->family) furi_string_cat_printf(output, " %s", instance->family);
+    furi_string_cat_printf(
+        output,
+        "\r\n"
+        "Id:0x%08lX\r\n"
+        "Temp:%2.0f C Bar:%2.1f",
+        instance->generic.id,
+        (double)instance->generic.temperature,
+        (double)instance->generic.pressure);
+}
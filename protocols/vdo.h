@@ -0,0 +1,80 @@
+#pragma once
+
+#include <lib/subghz/protocols/base.h>
+
+#include <lib/subghz/blocks/const.h>
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/encoder.h>
+#include "tpms_generic.h"
+#include <lib/subghz/blocks/math.h>
+
+#define TPMS_PROTOCOL_VDO_NAME "VDO"
+
+typedef struct TPMSProtocolDecoderVDO TPMSProtocolDecoderVDO;
+typedef struct TPMSProtocolEncoderVDO TPMSProtocolEncoderVDO;
+
+extern const SubGhzProtocolDecoder tpms_protocol_vdo_decoder;
+extern const SubGhzProtocolEncoder tpms_protocol_vdo_encoder;
+extern const SubGhzProtocol tpms_protocol_vdo;
+
+/**
+ * Allocate TPMSProtocolDecoderVDO.
+ * @param environment Pointer to a SubGhzEnvironment instance
+ * @return TPMSProtocolDecoderVDO* pointer to a TPMSProtocolDecoderVDO instance
+ */
+void* tpms_protocol_decoder_vdo_alloc(SubGhzEnvironment* environment);
+
+/**
+ * Free TPMSProtocolDecoderVDO.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ */
+void tpms_protocol_decoder_vdo_free(void* context);
+
+/**
+ * Reset decoder TPMSProtocolDecoderVDO.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ */
+void tpms_protocol_decoder_vdo_reset(void* context);
+
+/**
+ * Parse a raw sequence of levels and durations received from the air.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ * @param level Signal level true-high false-low
+ * @param duration Duration of this level in, us
+ */
+void tpms_protocol_decoder_vdo_feed(void* context, bool level, uint32_t duration);
+
+/**
+ * Getting the hash sum of the last randomly received parcel.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ * @return hash Hash sum
+ */
+uint8_t tpms_protocol_decoder_vdo_get_hash_data(void* context);
+
+/**
+ * Serialize data TPMSProtocolDecoderVDO.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param preset The modulation on which the signal was received, SubGhzRadioPreset
+ * @return status
+ */
+SubGhzProtocolStatus tpms_protocol_decoder_vdo_serialize(
+    void* context,
+    FlipperFormat* flipper_format,
+    SubGhzRadioPreset* preset);
+
+/**
+ * Deserialize data TPMSProtocolDecoderVDO.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @return status
+ */
+SubGhzProtocolStatus
+    tpms_protocol_decoder_vdo_deserialize(void* context, FlipperFormat* flipper_format);
+
+/**
+ * Getting a textual representation of the received data.
+ * @param context Pointer to a TPMSProtocolDecoderVDO instance
+ * @param output Resulting text
+ */
+void tpms_protocol_decoder_vdo_get_string(void* context, FuriString* output);
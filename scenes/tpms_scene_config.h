@@ -4,3 +4,5 @@ ADD_SCENE(tpms, receiver, Receiver)
 ADD_SCENE(tpms, relearn_config, Relearn)
 ADD_SCENE(tpms, receiver_config, ReceiverConfig)
 ADD_SCENE(tpms, receiver_info, ReceiverInfo)
+ADD_SCENE(tpms, receiver_search, ReceiverSearch)
+ADD_SCENE(tpms, log_viewer, LogViewer)
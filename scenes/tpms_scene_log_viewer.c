@@ -0,0 +1,98 @@
+#include "../tpms_app_i.h"
+
+static void tpms_scene_log_viewer_callback(TPMSCustomEvent event, void* context) {
+    furi_assert(context);
+    TPMSApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, event);
+}
+
+// Only the rows on screen are read, whatever the size of the log
+static void tpms_scene_log_viewer_update(TPMSApp* app) {
+    TPMSSessionLogRecord records[TPMS_LOG_VIEWER_ROWS];
+    uint8_t count = tpms_log_reader_read(app->log_reader, records, TPMS_LOG_VIEWER_ROWS);
+
+    uint16_t segment = 0;
+    uint16_t segments = 0;
+    uint32_t row = 0;
+    uint32_t rows = 0;
+    tpms_log_reader_get_position(app->log_reader, &segment, &segments, &row, &rows);
+    char position[24] = "";
+    if(count) {
+        snprintf(
+            position,
+            sizeof(position),
+            "%u/%u %lu/%lu",
+            segment + 1,
+            segments,
+            row + 1,
+            rows);
+    }
+
+    tpms_view_log_viewer_set_page(
+        app->tpms_log_viewer,
+        position,
+        records,
+        count,
+        tpms_log_reader_get_filter(app->log_reader, NULL));
+}
+
+void tpms_scene_log_viewer_on_enter(void* context) {
+    TPMSApp* app = context;
+
+    tpms_log_reader_open(app->log_reader);
+    tpms_view_log_viewer_set_callback(app->tpms_log_viewer, tpms_scene_log_viewer_callback, app);
+    tpms_scene_log_viewer_update(app);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, TPMSViewLogViewer);
+}
+
+bool tpms_scene_log_viewer_on_event(void* context, SceneManagerEvent event) {
+    TPMSApp* app = context;
+    TPMSLogReader* reader = app->log_reader;
+    bool consumed = false;
+
+    if(event.type == SceneManagerEventTypeCustom) {
+        consumed = true;
+        switch(event.event) {
+        case TPMSCustomEventViewLogUp:
+            tpms_log_reader_move(reader, -1);
+            break;
+        case TPMSCustomEventViewLogDown:
+            tpms_log_reader_move(reader, 1);
+            break;
+        case TPMSCustomEventViewLogPageUp:
+            tpms_log_reader_move(reader, -TPMS_LOG_VIEWER_ROWS);
+            break;
+        case TPMSCustomEventViewLogPageDown:
+            tpms_log_reader_move(reader, TPMS_LOG_VIEWER_ROWS);
+            break;
+        case TPMSCustomEventViewLogFirst:
+            tpms_log_reader_first(reader);
+            break;
+        case TPMSCustomEventViewLogLast:
+            tpms_log_reader_last(reader, TPMS_LOG_VIEWER_ROWS);
+            break;
+        case TPMSCustomEventViewLogFilter:
+            // Toggles between all rows and the rows of the sensor on top
+            if(tpms_log_reader_get_filter(reader, NULL)) {
+                tpms_log_reader_set_filter(reader, false, 0);
+            } else {
+                TPMSSessionLogRecord record;
+                if(tpms_log_reader_read(reader, &record, 1)) {
+                    tpms_log_reader_set_filter(reader, true, record.id);
+                }
+            }
+            break;
+        default:
+            consumed = false;
+            break;
+        }
+        if(consumed) tpms_scene_log_viewer_update(app);
+    }
+
+    return consumed;
+}
+
+void tpms_scene_log_viewer_on_exit(void* context) {
+    UNUSED(context);
+}
@@ -64,6 +64,59 @@ static void tpms_scene_receiver_update_statusbar(void* context) {
     furi_string_free(history_stat_str);
 }
 
+static void tpms_scene_receiver_sensor_state_callback(
+    uint16_t idx,
+    TPMSSensorState state,
+    void* context) {
+    TPMSApp* app = context;
+    tpms_view_receiver_set_item_state(app->tpms_receiver, idx, state);
+    if(state == TPMSSensorStateGone) {
+        // Vehicle left: the sensor was not heard from for TPMS_HISTORY_GONE_S
+        notification_message(app->notifications, &sequence_blink_red_10);
+    }
+}
+
+static void tpms_scene_receiver_item_changed_callback(uint16_t idx, void* context) {
+    TPMSApp* app = context;
+    FuriString* str_buff = furi_string_alloc();
+    FuriString* protocol = furi_string_alloc();
+    float pressure = 0;
+    float temperature = 0;
+    uint32_t last_seen =
+        tpms_history_get_reading(app->txrx->history, idx, &pressure, &temperature);
+    tpms_history_get_text_item_menu(app->txrx->history, str_buff, idx);
+    TPMSBaselineMark mark = tpms_baseline_check(
+        app->txrx->baseline, tpms_history_get_id(app->txrx->history, idx), pressure);
+    furi_string_replace_at(str_buff, 0, 0, tpms_baseline_get_mark(mark));
+    tpms_history_get_protocol_name(app->txrx->history, idx, protocol);
+    tpms_sort_update(
+        app->txrx->sort,
+        idx,
+        tpms_history_get_id(app->txrx->history, idx),
+        last_seen,
+        tpms_history_get_rssi(app->txrx->history, idx),
+        pressure,
+        furi_string_get_cstr(protocol));
+    tpms_view_receiver_set_item(
+        app->tpms_receiver,
+        idx,
+        furi_string_get_cstr(str_buff),
+        tpms_history_get_type_protocol(app->txrx->history, idx),
+        pressure,
+        temperature,
+        last_seen);
+    furi_string_free(protocol);
+    furi_string_free(str_buff);
+}
+
+static void tpms_scene_receiver_update_rows(TPMSApp* app) {
+    tpms_history_flush_dirty(
+        app->txrx->history, tpms_scene_receiver_item_changed_callback, app);
+    uint16_t size = 0;
+    const uint16_t* order = tpms_sort_get_index(app->txrx->sort, &size);
+    tpms_view_receiver_set_order(app->tpms_receiver, order, size);
+}
+
 void tpms_scene_receiver_callback(TPMSCustomEvent event, void* context) {
     furi_assert(context);
     TPMSApp* app = context;
@@ -76,21 +129,15 @@ static void tpms_scene_receiver_add_to_history_callback(
     void* context) {
     furi_assert(context);
     TPMSApp* app = context;
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
-    if(tpms_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
-       TPMSHistoryStateAddKeyNewDada) {
-        furi_string_reset(str_buff);
-
-        tpms_history_get_text_item_menu(
-            app->txrx->history, str_buff, tpms_history_get_item(app->txrx->history) - 1);
-        tpms_view_receiver_add_item_to_menu(
-            app->tpms_receiver,
-            furi_string_get_cstr(str_buff),
-            tpms_history_get_type_protocol(
-                app->txrx->history, tpms_history_get_item(app->txrx->history) - 1));
 
+    tpms_burst_library_mark_decoded(app->txrx->burst_library);
+    // Recorded before history, which stops growing at TPMS_HISTORY_MAX
+    tpms_record_frame(app, decoder_base);
+    TPMSHistoryStateAddKey state =
+        tpms_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset);
+    tpms_record_reading(app, state);
+    // Rows follow on the next tick, from the records the history marked dirty
+    if(state == TPMSHistoryStateAddKeyNewDada || state == TPMSHistoryStateAddKeyReplaced) {
         tpms_scene_receiver_update_statusbar(app);
         notification_message(app->notifications, &sequence_blink_green_10);
         if(app->lock != TPMSLockOn) {
@@ -100,37 +147,28 @@ static void tpms_scene_receiver_add_to_history_callback(
         }
     }
     subghz_receiver_reset(receiver);
-    furi_string_free(str_buff);
     app->txrx->rx_key_state = TPMSRxKeyStateAddKey;
 }
 
 void tpms_scene_receiver_on_enter(void* context) {
     TPMSApp* app = context;
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(app->txrx->rx_key_state == TPMSRxKeyStateIDLE) {
         tpms_preset_init(
             app, "AM650", subghz_setting_get_default_frequency(app->setting), NULL, 0);
         tpms_history_reset(app->txrx->history);
+        tpms_sort_reset(app->txrx->sort);
+        tpms_view_receiver_reset(app->tpms_receiver);
         app->txrx->rx_key_state = TPMSRxKeyStateStart;
     }
 
     tpms_view_receiver_set_lock(app->tpms_receiver, app->lock);
 
-    //Load history to receiver
-    tpms_view_receiver_exit(app->tpms_receiver);
-    for(uint8_t i = 0; i < tpms_history_get_item(app->txrx->history); i++) {
-        furi_string_reset(str_buff);
-        tpms_history_get_text_item_menu(app->txrx->history, str_buff, i);
-        tpms_view_receiver_add_item_to_menu(
-            app->tpms_receiver,
-            furi_string_get_cstr(str_buff),
-            tpms_history_get_type_protocol(app->txrx->history, i));
+    // The view kept its rows, only those changed in other scenes are brought up to date
+    tpms_scene_receiver_update_rows(app);
+    if(tpms_history_get_item(app->txrx->history)) {
         app->txrx->rx_key_state = TPMSRxKeyStateAddKey;
     }
-    furi_string_free(str_buff);
     tpms_scene_receiver_update_statusbar(app);
 
     tpms_view_receiver_set_callback(app->tpms_receiver, tpms_scene_receiver_callback, app);
@@ -197,6 +235,18 @@ bool tpms_scene_receiver_on_event(void* context, SceneManagerEvent event) {
             app->lock = TPMSLockOff;
             consumed = true;
             break;
+        case TPMSCustomEventViewReceiverSearch:
+            app->txrx->idx_menu_chosen = tpms_view_receiver_get_idx_menu(app->tpms_receiver);
+            scene_manager_next_scene(app->scene_manager, TPMSSceneReceiverSearch);
+            consumed = true;
+            break;
+        case TPMSCustomEventViewReceiverSort:
+            tpms_sort_next(app->txrx->sort);
+            tpms_scene_receiver_update_rows(app);
+            tpms_view_receiver_show_sort(
+                app->tpms_receiver, tpms_sort_get_name(tpms_sort_get_active(app->txrx->sort)));
+            consumed = true;
+            break;
         default:
             break;
         }
@@ -205,6 +255,8 @@ bool tpms_scene_receiver_on_event(void* context, SceneManagerEvent event) {
             tpms_hopper_update(app);
             tpms_scene_receiver_update_statusbar(app);
         }
+        tpms_scene_receiver_update_rows(app);
+        tpms_history_tick(app->txrx->history, tpms_scene_receiver_sensor_state_callback, app);
         // Get current RSSI
         float rssi = furi_hal_subghz_get_rssi();
         tpms_view_receiver_set_rssi(app->tpms_receiver, rssi);
@@ -4,6 +4,10 @@ enum TPMSSettingIndex {
     TPMSSettingIndexFrequency,
     TPMSSettingIndexHopping,
     TPMSSettingIndexModulation,
+    TPMSSettingIndexSaveUnknown,
+    TPMSSettingIndexTrafficCount,
+    TPMSSettingIndexLogReadings,
+    TPMSSettingIndexAlerts,
     TPMSSettingIndexLock,
 };
 
@@ -17,6 +21,30 @@ const uint32_t hopping_value[HOPPING_COUNT] = {
     TPMSHopperStateRunnig,
 };
 
+#define SAVE_UNKNOWN_COUNT 2
+const char* const save_unknown_text[SAVE_UNKNOWN_COUNT] = {
+    "OFF",
+    "ON",
+};
+
+#define TRAFFIC_COUNT_COUNT 2
+const char* const traffic_count_text[TRAFFIC_COUNT_COUNT] = {
+    "OFF",
+    "ON",
+};
+
+#define LOG_READINGS_COUNT 2
+const char* const log_readings_text[LOG_READINGS_COUNT] = {
+    "OFF",
+    "ON",
+};
+
+#define ALERTS_COUNT 2
+const char* const alerts_text[ALERTS_COUNT] = {
+    "OFF",
+    "ON",
+};
+
 uint8_t tpms_scene_receiver_config_next_frequency(const uint32_t value, void* context) {
     furi_assert(context);
     TPMSApp* app = context;
@@ -136,6 +164,38 @@ static void tpms_scene_receiver_config_set_hopping_running(VariableItem* item) {
     app->txrx->hopper_state = hopping_value[index];
 }
 
+static void tpms_scene_receiver_config_set_save_unknown(VariableItem* item) {
+    TPMSApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, save_unknown_text[index]);
+    tpms_burst_library_set_enabled(app->txrx->burst_library, index == 1);
+}
+
+static void tpms_scene_receiver_config_set_traffic_count(VariableItem* item) {
+    TPMSApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, traffic_count_text[index]);
+    tpms_traffic_set_enabled(app->txrx->traffic, index == 1);
+}
+
+static void tpms_scene_receiver_config_set_log_readings(VariableItem* item) {
+    TPMSApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, log_readings_text[index]);
+    tpms_session_log_set_enabled(app->txrx->session_log, index == 1);
+}
+
+static void tpms_scene_receiver_config_set_alerts(VariableItem* item) {
+    TPMSApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, alerts_text[index]);
+    tpms_alert_set_enabled(app->txrx->alert, index == 1);
+}
+
 static void tpms_scene_receiver_config_var_list_enter_callback(void* context, uint32_t index) {
     furi_assert(context);
     TPMSApp* app = context;
@@ -190,6 +250,46 @@ void tpms_scene_receiver_config_on_enter(void* context) {
     variable_item_set_current_value_text(
         item, subghz_setting_get_preset_name(app->setting, value_index));
 
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Save Unknown:",
+        SAVE_UNKNOWN_COUNT,
+        tpms_scene_receiver_config_set_save_unknown,
+        app);
+    value_index = tpms_burst_library_is_enabled(app->txrx->burst_library) ? 1 : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, save_unknown_text[value_index]);
+
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Traffic Count:",
+        TRAFFIC_COUNT_COUNT,
+        tpms_scene_receiver_config_set_traffic_count,
+        app);
+    value_index = tpms_traffic_is_enabled(app->txrx->traffic) ? 1 : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, traffic_count_text[value_index]);
+
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Log Readings:",
+        LOG_READINGS_COUNT,
+        tpms_scene_receiver_config_set_log_readings,
+        app);
+    value_index = tpms_session_log_is_enabled(app->txrx->session_log) ? 1 : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, log_readings_text[value_index]);
+
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Alerts:",
+        ALERTS_COUNT,
+        tpms_scene_receiver_config_set_alerts,
+        app);
+    value_index = tpms_alert_is_enabled(app->txrx->alert) ? 1 : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, alerts_text[value_index]);
+
     variable_item_list_add(app->variable_item_list, "Lock Keyboard", 1, NULL, NULL);
     variable_item_list_set_enter_callback(
         app->variable_item_list, tpms_scene_receiver_config_var_list_enter_callback, app);
@@ -7,6 +7,31 @@ void tpms_scene_receiver_info_callback(TPMSCustomEvent event, void* context) {
     view_dispatcher_send_custom_event(app->view_dispatcher, event);
 }
 
+static void tpms_scene_receiver_info_update(TPMSApp* app) {
+    uint16_t idx = app->txrx->idx_menu_chosen;
+    // Copies, the worker thread rewrites the history item when the sensor is heard again
+    FlipperFormat* fff = flipper_format_string_alloc();
+    if(tpms_history_get_raw_data(app->txrx->history, idx, fff)) {
+        tpms_view_receiver_info_update(app->tpms_receiver_info, fff);
+    }
+    flipper_format_free(fff);
+    FuriString* protocol = furi_string_alloc();
+    tpms_history_get_protocol_name(app->txrx->history, idx, protocol);
+    tpms_view_receiver_info_set_sightings(
+        app->tpms_receiver_info,
+        tpms_traffic_get_sightings(
+            app->txrx->traffic,
+            furi_string_get_cstr(protocol),
+            tpms_history_get_id(app->txrx->history, idx)));
+    furi_string_free(protocol);
+    float rate = 0;
+    tpms_leak_get_rate(app->txrx->leak, idx, &rate);
+    tpms_view_receiver_info_set_leak(
+        app->tpms_receiver_info, rate, tpms_leak_is_alert(app->txrx->leak, idx));
+    tpms_view_receiver_info_set_alerts(
+        app->tpms_receiver_info, tpms_alert_get_active(app->txrx->alert, idx));
+}
+
 static void tpms_scene_receiver_info_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -14,11 +39,14 @@ static void tpms_scene_receiver_info_add_to_history_callback(
     furi_assert(context);
     TPMSApp* app = context;
 
-    if(tpms_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
-       TPMSHistoryStateAddKeyUpdateData) {
-        tpms_view_receiver_info_update(
-            app->tpms_receiver_info,
-            tpms_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen));
+    tpms_burst_library_mark_decoded(app->txrx->burst_library);
+    // Recorded before history, which stops growing at TPMS_HISTORY_MAX
+    tpms_record_frame(app, decoder_base);
+    TPMSHistoryStateAddKey state =
+        tpms_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset);
+    tpms_record_reading(app, state);
+    if(state == TPMSHistoryStateAddKeyUpdateData) {
+        tpms_scene_receiver_info_update(app);
         subghz_receiver_reset(receiver);
 
         notification_message(app->notifications, &sequence_blink_green_10);
@@ -31,9 +59,7 @@ void tpms_scene_receiver_info_on_enter(void* context) {
 
     subghz_receiver_set_rx_callback(
         app->txrx->receiver, tpms_scene_receiver_info_add_to_history_callback, app);
-    tpms_view_receiver_info_update(
-        app->tpms_receiver_info,
-        tpms_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen));
+    tpms_scene_receiver_info_update(app);
     view_dispatcher_switch_to_view(app->view_dispatcher, TPMSViewReceiverInfo);
 }
 
@@ -0,0 +1,64 @@
+#include "../tpms_app_i.h"
+#include <ctype.h>
+
+static void tpms_scene_receiver_search_text_input_callback(void* context) {
+    furi_assert(context);
+    TPMSApp* app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, TPMSCustomEventSceneSearch);
+}
+
+static bool tpms_scene_receiver_search_validator(
+    const char* text,
+    FuriString* error,
+    void* context) {
+    UNUSED(context);
+    for(const char* c = text; *c; c++) {
+        if(!isxdigit((unsigned char)*c)) {
+            furi_string_set_str(error, "Hex digits\nonly");
+            return false;
+        }
+    }
+    return true;
+}
+
+void tpms_scene_receiver_search_on_enter(void* context) {
+    TPMSApp* app = context;
+
+    text_input_set_header_text(app->text_input, "Sensor ID starts with");
+    text_input_set_result_callback(
+        app->text_input,
+        tpms_scene_receiver_search_text_input_callback,
+        app,
+        app->search_prefix,
+        sizeof(app->search_prefix),
+        false);
+    text_input_set_validator(app->text_input, tpms_scene_receiver_search_validator, app);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, TPMSViewTextInput);
+}
+
+bool tpms_scene_receiver_search_on_event(void* context, SceneManagerEvent event) {
+    TPMSApp* app = context;
+    bool consumed = false;
+    if(event.type == SceneManagerEventTypeCustom &&
+       event.event == TPMSCustomEventSceneSearch) {
+        for(char* c = app->search_prefix; *c; c++) {
+            *c = toupper((unsigned char)*c);
+        }
+        // Binary search on the ID order. Sensors heard while typing join it back in the list
+        uint16_t idx = 0;
+        if(tpms_sort_find_id(app->txrx->sort, app->search_prefix, &idx)) {
+            app->txrx->idx_menu_chosen = idx;
+        } else {
+            notification_message(app->notifications, &sequence_error);
+        }
+        scene_manager_previous_scene(app->scene_manager);
+        consumed = true;
+    }
+    return consumed;
+}
+
+void tpms_scene_receiver_search_on_exit(void* context) {
+    TPMSApp* app = context;
+    text_input_reset(app->text_input);
+}
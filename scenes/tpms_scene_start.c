@@ -1,7 +1,10 @@
 #include "../tpms_app_i.h"
+#include <dialogs/dialogs.h>
 
 typedef enum {
     SubmenuIndexTPMSReceiver,
+    SubmenuIndexTPMSBaseline,
+    SubmenuIndexTPMSLogViewer,
     SubmenuIndexTPMSRelearn,
     SubmenuIndexTPMSAbout,
 } SubmenuIndex;
@@ -11,6 +14,27 @@ void tpms_scene_start_submenu_callback(void* context, uint32_t index) {
     view_dispatcher_send_custom_event(app->view_dispatcher, index);
 }
 
+// Pick a session log to diff the next read against, leaving the browser drops the baseline
+static bool tpms_scene_start_load_baseline(TPMSApp* app) {
+    DialogsApp* dialogs = furi_record_open(RECORD_DIALOGS);
+    FuriString* path = furi_string_alloc_set(TPMS_SESSION_LOG_FOLDER);
+    DialogsFileBrowserOptions browser_options;
+    dialog_file_browser_set_basic_options(&browser_options, ".csv", NULL);
+    browser_options.base_path = TPMS_SESSION_LOG_FOLDER;
+
+    bool loaded = false;
+    if(dialog_file_browser_show(dialogs, path, path, &browser_options)) {
+        loaded = tpms_baseline_load(app->txrx->baseline, furi_string_get_cstr(path));
+        if(!loaded) notification_message(app->notifications, &sequence_error);
+    } else {
+        tpms_baseline_clear(app->txrx->baseline);
+    }
+
+    furi_string_free(path);
+    furi_record_close(RECORD_DIALOGS);
+    return loaded;
+}
+
 void tpms_scene_start_on_enter(void* context) {
     UNUSED(context);
     TPMSApp* app = context;
@@ -18,6 +42,14 @@ void tpms_scene_start_on_enter(void* context) {
 
     submenu_add_item(
         submenu, "Read TPMS", SubmenuIndexTPMSReceiver, tpms_scene_start_submenu_callback, app);
+    submenu_add_item(
+        submenu,
+        "Compare to Log",
+        SubmenuIndexTPMSBaseline,
+        tpms_scene_start_submenu_callback,
+        app);
+    submenu_add_item(
+        submenu, "Browse Logs", SubmenuIndexTPMSLogViewer, tpms_scene_start_submenu_callback, app);
     submenu_add_item(
         submenu, "Relearn", SubmenuIndexTPMSRelearn, tpms_scene_start_submenu_callback, app);
     // Help
@@ -46,6 +78,14 @@ bool tpms_scene_start_on_event(void* context, SceneManagerEvent event) {
         } else if(event.event == SubmenuIndexTPMSReceiver) {
             scene_manager_next_scene(app->scene_manager, TPMSSceneReceiver);
             consumed = true;
+        } else if(event.event == SubmenuIndexTPMSBaseline) {
+            if(tpms_scene_start_load_baseline(app)) {
+                scene_manager_next_scene(app->scene_manager, TPMSSceneReceiver);
+            }
+            consumed = true;
+        } else if(event.event == SubmenuIndexTPMSLogViewer) {
+            scene_manager_next_scene(app->scene_manager, TPMSSceneLogViewer);
+            consumed = true;
         } else if(event.event == SubmenuIndexTPMSRelearn) {
             scene_manager_next_scene(app->scene_manager, TPMSSceneRelearn);
             consumed = true;
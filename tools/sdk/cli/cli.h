@@ -0,0 +1,37 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The CLI service is played by the tool that needs it, it implements these calls */
+
+#define RECORD_CLI "cli"
+
+typedef struct Cli Cli;
+
+typedef enum {
+    CliCommandFlagDefault = 0,
+    CliCommandFlagParallelSafe = (1 << 0),
+    CliCommandFlagInsomniaSafe = (1 << 1),
+} CliCommandFlag;
+
+typedef void (*CliCallback)(Cli* cli, FuriString* args, void* context);
+
+void cli_add_command(
+    Cli* cli,
+    const char* name,
+    CliCommandFlag flags,
+    CliCallback callback,
+    void* context);
+
+void cli_delete_command(Cli* cli, const char* name);
+
+/** Ctrl+C was typed, the command should return */
+bool cli_cmd_interrupt_received(Cli* cli);
+
+#ifdef __cplusplus
+}
+#endif
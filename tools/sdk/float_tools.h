@@ -0,0 +1,5 @@
+#pragma once
+
+#include <stdbool.h>
+
+bool float_is_equal(float a, float b);
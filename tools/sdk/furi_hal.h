@@ -0,0 +1,47 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** RSSI reported to the decoders, -60 dBm unless a tool sets furi_hal_subghz_rssi */
+extern float furi_hal_subghz_rssi;
+
+float furi_hal_subghz_get_rssi(void);
+
+uint32_t furi_hal_rtc_get_timestamp(void);
+
+typedef struct {
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+    uint8_t weekday;
+} DateTime;
+
+/** Local time of the host */
+void furi_hal_rtc_get_datetime(DateTime* datetime);
+
+uint32_t datetime_datetime_to_timestamp(DateTime* datetime);
+
+typedef enum {
+    FuriHalRtcLocaleUnitsMetric = 0,
+    FuriHalRtcLocaleUnitsImperial = 1,
+} FuriHalRtcLocaleUnits;
+
+/** Metric unless a tool sets furi_hal_rtc_locale_units */
+extern FuriHalRtcLocaleUnits furi_hal_rtc_locale_units;
+
+FuriHalRtcLocaleUnits furi_hal_rtc_get_locale_units(void);
+
+// 125 kHz relearn carrier, nothing is sent on the host
+void furi_hal_rfid_tim_read_start(float freq, float duty_cycle);
+void furi_hal_rfid_tim_read_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,319 @@
+/* Host canvas, elements and view for the tools that render app views. Drawing goes to a 1 bit
+ * framebuffer with the firmware geometry, so the cost of a frame scales with what a view draws.
+ * Text metrics are stand-ins, see gui/canvas_i.h. */
+
+#include <gui/canvas_i.h>
+#include <gui/elements.h>
+#include <gui/view_i.h>
+
+struct Canvas {
+    uint8_t buffer[CANVAS_HEIGHT][CANVAS_WIDTH / 8];
+    Color color;
+    Font font;
+};
+
+Canvas* canvas_init(void) {
+    Canvas* canvas = calloc(1, sizeof(Canvas));
+    canvas->color = ColorBlack;
+    canvas->font = FontSecondary;
+    return canvas;
+}
+
+void canvas_free(Canvas* canvas) {
+    free(canvas);
+}
+
+const uint8_t* canvas_get_buffer(Canvas* canvas) {
+    return &canvas->buffer[0][0];
+}
+
+void canvas_clear(Canvas* canvas) {
+    memset(canvas->buffer, 0, sizeof(canvas->buffer));
+}
+
+void canvas_set_color(Canvas* canvas, Color color) {
+    canvas->color = color;
+}
+
+void canvas_set_font(Canvas* canvas, Font font) {
+    canvas->font = font;
+}
+
+void canvas_draw_dot(Canvas* canvas, int32_t x, int32_t y) {
+    if(x < 0 || y < 0 || x >= CANVAS_WIDTH || y >= CANVAS_HEIGHT) return;
+    uint8_t* byte = &canvas->buffer[y][x / 8];
+    uint8_t bit = 1 << (x % 8);
+    if(canvas->color == ColorBlack) {
+        *byte |= bit;
+    } else if(canvas->color == ColorWhite) {
+        *byte &= ~bit;
+    } else {
+        *byte ^= bit;
+    }
+}
+
+void canvas_draw_box(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    for(size_t j = 0; j < height; j++) {
+        for(size_t i = 0; i < width; i++) {
+            canvas_draw_dot(canvas, x + i, y + j);
+        }
+    }
+}
+
+void canvas_draw_frame(Canvas* canvas, int32_t x, int32_t y, size_t width, size_t height) {
+    if(!width || !height) return;
+    canvas_draw_line(canvas, x, y, x + width - 1, y);
+    canvas_draw_line(canvas, x, y + height - 1, x + width - 1, y + height - 1);
+    canvas_draw_line(canvas, x, y + 1, x, y + height - 2);
+    canvas_draw_line(canvas, x + width - 1, y + 1, x + width - 1, y + height - 2);
+}
+
+void canvas_draw_line(Canvas* canvas, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    int32_t dx = abs(x2 - x1);
+    int32_t dy = -abs(y2 - y1);
+    int32_t sx = x1 < x2 ? 1 : -1;
+    int32_t sy = y1 < y2 ? 1 : -1;
+    int32_t error = dx + dy;
+    while(true) {
+        canvas_draw_dot(canvas, x1, y1);
+        if(x1 == x2 && y1 == y2) break;
+        int32_t e2 = 2 * error;
+        if(e2 >= dy) {
+            error += dy;
+            x1 += sx;
+        }
+        if(e2 <= dx) {
+            error += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void canvas_draw_circle(Canvas* canvas, int32_t x, int32_t y, size_t radius) {
+    int32_t dx = radius;
+    int32_t dy = 0;
+    int32_t error = 1 - dx;
+    while(dx >= dy) {
+        canvas_draw_dot(canvas, x + dx, y + dy);
+        canvas_draw_dot(canvas, x - dx, y + dy);
+        canvas_draw_dot(canvas, x + dx, y - dy);
+        canvas_draw_dot(canvas, x - dx, y - dy);
+        canvas_draw_dot(canvas, x + dy, y + dx);
+        canvas_draw_dot(canvas, x - dy, y + dx);
+        canvas_draw_dot(canvas, x + dy, y - dx);
+        canvas_draw_dot(canvas, x - dy, y - dx);
+        dy++;
+        if(error < 0) {
+            error += 2 * dy + 1;
+        } else {
+            dx--;
+            error += 2 * (dy - dx) + 1;
+        }
+    }
+}
+
+void canvas_draw_icon(Canvas* canvas, int32_t x, int32_t y, const Icon* icon) {
+    canvas_draw_frame(canvas, x, y, icon->width, icon->height);
+}
+
+// Cap height of the firmware fonts
+static uint8_t canvas_font_height(Font font) {
+    switch(font) {
+    case FontPrimary:
+        return 8;
+    case FontBigNumbers:
+        return 14;
+    default:
+        return 7;
+    }
+}
+
+static uint8_t canvas_glyph_width(Font font, char c) {
+    bool narrow = strchr(" .,:;!'|il1", c) != NULL;
+    switch(font) {
+    case FontPrimary:
+        return narrow ? 3 : 6;
+    case FontBigNumbers:
+        return narrow ? 4 : 11;
+    default:
+        return narrow ? 2 : 5;
+    }
+}
+
+uint16_t canvas_string_width(Canvas* canvas, const char* str) {
+    uint16_t width = 0;
+    for(; *str; str++) {
+        width += canvas_glyph_width(canvas->font, *str);
+    }
+    return width;
+}
+
+// y is the baseline
+void canvas_draw_str(Canvas* canvas, int32_t x, int32_t y, const char* str) {
+    uint8_t height = canvas_font_height(canvas->font);
+    for(; *str; str++) {
+        uint8_t width = canvas_glyph_width(canvas->font, *str);
+        if(*str != ' ') canvas_draw_frame(canvas, x, y - height + 1, width - 1, height);
+        x += width;
+    }
+}
+
+void canvas_draw_str_aligned(
+    Canvas* canvas,
+    int32_t x,
+    int32_t y,
+    Align horizontal,
+    Align vertical,
+    const char* str) {
+    uint16_t width = canvas_string_width(canvas, str);
+    uint8_t height = canvas_font_height(canvas->font);
+    if(horizontal == AlignRight) {
+        x -= width;
+    } else if(horizontal == AlignCenter) {
+        x -= width / 2;
+    }
+    if(vertical == AlignTop) {
+        y += height;
+    } else if(vertical == AlignCenter) {
+        y += height / 2;
+    }
+    canvas_draw_str(canvas, x, y, str);
+}
+
+static void elements_button(Canvas* canvas, int32_t x, const char* str) {
+    uint16_t width = canvas_string_width(canvas, str) + 10;
+    if(x < 0) x = CANVAS_WIDTH - width;
+    canvas_draw_box(canvas, x, CANVAS_HEIGHT - 10, width, 10);
+    canvas_set_color(canvas, ColorWhite);
+    canvas_draw_str(canvas, x + 8, CANVAS_HEIGHT - 2, str);
+    canvas_set_color(canvas, ColorBlack);
+}
+
+void elements_button_left(Canvas* canvas, const char* str) {
+    elements_button(canvas, 0, str);
+}
+
+void elements_button_right(Canvas* canvas, const char* str) {
+    elements_button(canvas, -1, str);
+}
+
+void elements_button_center(Canvas* canvas, const char* str) {
+    elements_button(canvas, (CANVAS_WIDTH - canvas_string_width(canvas, str) - 10) / 2, str);
+}
+
+void elements_scrollbar_pos(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t height,
+    uint16_t pos,
+    uint16_t total) {
+    // Dotted track and a block, as the firmware draws them
+    for(uint8_t i = y; i < y + height; i += 2) {
+        canvas_draw_dot(canvas, x - 2, i);
+    }
+    if(total) {
+        uint8_t block = MAX(height / total, 1);
+        canvas_draw_box(canvas, x - 3, y + (height - block) * pos / MAX(total - 1, 1), 3, block);
+    }
+}
+
+void elements_bold_rounded_frame(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t width,
+    uint8_t height) {
+    canvas_draw_frame(canvas, x, y, width, height);
+    canvas_draw_frame(canvas, x + 1, y + 1, width - 2, height - 2);
+}
+
+void elements_multiline_text(Canvas* canvas, uint8_t x, uint8_t y, const char* text) {
+    uint8_t height = canvas_font_height(canvas->font) + 2;
+    char line[CANVAS_WIDTH];
+    while(*text) {
+        size_t len = strcspn(text, "\n");
+        strlcpy(line, text, MIN(len + 1, sizeof(line)));
+        canvas_draw_str(canvas, x, y, line);
+        text += len;
+        if(*text) text++;
+        y += height;
+    }
+}
+
+void elements_string_fit_width(Canvas* canvas, FuriString* string, uint8_t width) {
+    char fitted[CANVAS_WIDTH];
+    strlcpy(fitted, furi_string_get_cstr(string), sizeof(fitted));
+    if(canvas_string_width(canvas, fitted) <= width) return;
+    width -= canvas_string_width(canvas, "...");
+    size_t len = strlen(fitted);
+    do {
+        fitted[--len] = '\0';
+    } while(len && canvas_string_width(canvas, fitted) > width);
+    strlcat(fitted, "...", sizeof(fitted));
+    furi_string_set_str(string, fitted);
+}
+
+struct View {
+    ViewDrawCallback draw_callback;
+    ViewInputCallback input_callback;
+    ViewCallback enter_callback;
+    ViewCallback exit_callback;
+    void* context;
+    void* model;
+    uint32_t updates;
+};
+
+View* view_alloc(void) {
+    return calloc(1, sizeof(View));
+}
+
+void view_free(View* view) {
+    free(view->model);
+    free(view);
+}
+
+void view_allocate_model(View* view, ViewModelType type, size_t size) {
+    UNUSED(type);
+    view->model = calloc(1, size);
+}
+
+void view_set_context(View* view, void* context) {
+    view->context = context;
+}
+
+void view_set_draw_callback(View* view, ViewDrawCallback callback) {
+    view->draw_callback = callback;
+}
+
+void view_set_input_callback(View* view, ViewInputCallback callback) {
+    view->input_callback = callback;
+}
+
+void view_set_enter_callback(View* view, ViewCallback callback) {
+    view->enter_callback = callback;
+}
+
+void view_set_exit_callback(View* view, ViewCallback callback) {
+    view->exit_callback = callback;
+}
+
+void* view_get_model(View* view) {
+    return view->model;
+}
+
+void view_commit_model(View* view, bool update) {
+    if(update) view->updates++;
+}
+
+void view_draw(View* view, Canvas* canvas) {
+    if(view->draw_callback) view->draw_callback(canvas, view->model);
+}
+
+bool view_input(View* view, InputEvent* event) {
+    return view->input_callback ? view->input_callback(event, view->context) : false;
+}
+
+uint32_t view_get_update_count(View* view) {
+    return view->updates;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gui/canvas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CANVAS_WIDTH 128
+#define CANVAS_HEIGHT 64
+
+/* The host canvas draws into a 1 bit framebuffer, a byte per 8 pixels of a row. Fonts are
+ * stand-ins with the height of the firmware ones and a fixed advance per glyph class, glyphs
+ * are drawn as their box outline. */
+
+Canvas* canvas_init(void);
+
+void canvas_free(Canvas* canvas);
+
+/** Framebuffer, CANVAS_HEIGHT rows of CANVAS_WIDTH / 8 bytes */
+const uint8_t* canvas_get_buffer(Canvas* canvas);
+
+#ifdef __cplusplus
+}
+#endif
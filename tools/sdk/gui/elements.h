@@ -0,0 +1,30 @@
+#pragma once
+
+#include <gui/canvas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void elements_button_left(Canvas* canvas, const char* str);
+void elements_button_right(Canvas* canvas, const char* str);
+void elements_button_center(Canvas* canvas, const char* str);
+void elements_scrollbar_pos(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t height,
+    uint16_t pos,
+    uint16_t total);
+void elements_bold_rounded_frame(
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    uint8_t width,
+    uint8_t height);
+void elements_multiline_text(Canvas* canvas, uint8_t x, uint8_t y, const char* text);
+void elements_string_fit_width(Canvas* canvas, FuriString* string, uint8_t width);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <furi.h>
+#include <gui/canvas.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RECORD_GUI "gui"
+
+typedef struct Gui Gui;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Icons are blank on the host, only their size is drawn */
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+} Icon;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <gui/view.h>
+
+// Declared for the app headers, not implemented on the host
+typedef struct TextInput TextInput;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <furi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declared for the app headers, not implemented on the host
+typedef enum {
+    SceneManagerEventTypeCustom,
+    SceneManagerEventTypeBack,
+    SceneManagerEventTypeTick,
+} SceneManagerEventType;
+
+typedef struct {
+    SceneManagerEventType type;
+    uint32_t event;
+} SceneManagerEvent;
+
+typedef struct {
+    void (*const* on_enter_handlers)(void* context);
+    bool (*const* on_event_handlers)(void* context, SceneManagerEvent event);
+    void (*const* on_exit_handlers)(void* context);
+    uint32_t scene_num;
+} SceneManagerHandlers;
+
+typedef struct SceneManager SceneManager;
+
+#ifdef __cplusplus
+}
+#endif
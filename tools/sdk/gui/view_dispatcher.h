@@ -0,0 +1,17 @@
+#pragma once
+
+#include <gui/gui.h>
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Declared for the app headers, not implemented on the host
+typedef struct ViewDispatcher ViewDispatcher;
+
+void view_dispatcher_send_custom_event(ViewDispatcher* view_dispatcher, uint32_t event);
+
+#ifdef __cplusplus
+}
+#endif
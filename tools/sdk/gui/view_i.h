@@ -0,0 +1,20 @@
+#pragma once
+
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Run the draw callback on the model, as the GUI thread does */
+void view_draw(View* view, Canvas* canvas);
+
+/** Run the input callback */
+bool view_input(View* view, InputEvent* event);
+
+/** Redraws asked for with view_commit_model since the view was allocated */
+uint32_t view_get_update_count(View* view);
+
+#ifdef __cplusplus
+}
+#endif
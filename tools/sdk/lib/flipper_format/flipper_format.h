@@ -0,0 +1,11 @@
+#pragma once
+
+#include <furi.h>
+
+/* Opaque on the host, no Flipper files are read or written. Tools that hand a FlipperFormat
+ * to the app define the calls it makes on it. */
+typedef struct FlipperFormat FlipperFormat;
+
+bool flipper_format_rewind(FlipperFormat* flipper_format);
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data);
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    size_t size_upload;
+    uint32_t* upload;
+} SubGhzProtocolBlockEncoder;
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DURATION_DIFF(x, y) (((x) < (y)) ? ((y) - (x)) : ((x) - (y)))
+
+uint8_t subghz_protocol_blocks_crc8(
+    uint8_t const message[],
+    size_t size,
+    uint8_t polynomial,
+    uint8_t init);
+
+uint8_t subghz_protocol_blocks_add_bytes(uint8_t const message[], size_t size);
+
+uint8_t subghz_protocol_blocks_xor_bytes(uint8_t const message[], size_t size);
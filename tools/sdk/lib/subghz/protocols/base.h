@@ -0,0 +1,18 @@
+#pragma once
+
+#include <lib/subghz/types.h>
+
+typedef struct SubGhzProtocolDecoderBase SubGhzProtocolDecoderBase;
+
+typedef void (
+    *SubGhzProtocolDecoderBaseRxCallback)(SubGhzProtocolDecoderBase* instance, void* context);
+
+struct SubGhzProtocolDecoderBase {
+    const SubGhzProtocol* protocol;
+    SubGhzProtocolDecoderBaseRxCallback callback;
+    void* context;
+};
+
+typedef struct {
+    const SubGhzProtocol* protocol;
+} SubGhzProtocolEncoderBase;
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <lib/subghz/protocols/base.h>
+#include <lib/subghz/registry.h>
+
+// Declared for the app headers, not implemented on the host
+typedef struct SubGhzReceiver SubGhzReceiver;
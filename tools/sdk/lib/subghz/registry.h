@@ -0,0 +1,9 @@
+#pragma once
+
+#include <lib/subghz/types.h>
+
+// Declared for the app headers, not implemented on the host
+typedef struct {
+    const SubGhzProtocol** items;
+    const size_t size;
+} SubGhzProtocolRegistry;
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <furi.h>
+
+// Declared for the app headers, not implemented on the host
+typedef struct SubGhzWorker SubGhzWorker;
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <lib/subghz/protocols/base.h>
+
+// Declared for the app headers, not implemented on the host
+typedef struct SubGhzTransmitter SubGhzTransmitter;
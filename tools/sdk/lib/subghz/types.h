@@ -0,0 +1,73 @@
+#pragma once
+
+#include <furi.h>
+#include <lib/flipper_format/flipper_format.h>
+
+typedef struct {
+    FuriString* name;
+    uint32_t frequency;
+    uint8_t* data;
+    size_t data_size;
+} SubGhzRadioPreset;
+
+typedef enum {
+    SubGhzProtocolStatusOk = 0,
+    SubGhzProtocolStatusError = -1,
+    SubGhzProtocolStatusErrorParserOthers = -10,
+    SubGhzProtocolStatusErrorValueBitCount = -11,
+} SubGhzProtocolStatus;
+
+typedef struct SubGhzEnvironment SubGhzEnvironment;
+
+typedef enum {
+    SubGhzProtocolTypeUnknown = 0,
+    SubGhzProtocolTypeStatic,
+    SubGhzProtocolTypeDynamic,
+} SubGhzProtocolType;
+
+typedef enum {
+    SubGhzProtocolFlag_RAW = (1 << 0),
+    SubGhzProtocolFlag_Decodable = (1 << 1),
+    SubGhzProtocolFlag_315 = (1 << 2),
+    SubGhzProtocolFlag_433 = (1 << 3),
+    SubGhzProtocolFlag_868 = (1 << 4),
+    SubGhzProtocolFlag_AM = (1 << 5),
+    SubGhzProtocolFlag_FM = (1 << 6),
+} SubGhzProtocolFlag;
+
+typedef void* (*SubGhzAlloc)(SubGhzEnvironment* environment);
+typedef void (*SubGhzFree)(void* context);
+typedef void (*SubGhzDecoderFeed)(void* decoder, bool level, uint32_t duration);
+typedef void (*SubGhzDecoderReset)(void* decoder);
+typedef uint8_t (*SubGhzGetHashData)(void* context);
+typedef SubGhzProtocolStatus (
+    *SubGhzSerialize)(void* context, FlipperFormat* flipper_format, SubGhzRadioPreset* preset);
+typedef SubGhzProtocolStatus (*SubGhzDeserialize)(void* context, FlipperFormat* flipper_format);
+typedef void (*SubGhzGetString)(void* decoder, FuriString* output);
+
+typedef struct {
+    SubGhzAlloc alloc;
+    SubGhzFree free;
+    SubGhzDecoderFeed feed;
+    SubGhzDecoderReset reset;
+    SubGhzGetHashData get_hash_data;
+    SubGhzSerialize serialize;
+    SubGhzDeserialize deserialize;
+    SubGhzGetString get_string;
+} SubGhzProtocolDecoder;
+
+typedef struct {
+    void* alloc;
+    void* free;
+    void* deserialize;
+    void* stop;
+    void* yield;
+} SubGhzProtocolEncoder;
+
+typedef struct {
+    const char* name;
+    SubGhzProtocolType type;
+    SubGhzProtocolFlag flag;
+    const SubGhzProtocolEncoder* encoder;
+    const SubGhzProtocolDecoder* decoder;
+} SubGhzProtocol;
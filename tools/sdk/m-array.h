@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Host stand-in for the part of M*LIB's m-array the app uses: POD elements, grown by
+ * push_raw, no element constructors or destructors. */
+
+#define M_POD_OPLIST ()
+#define ARRAY_OPLIST(name, oplist) ()
+
+#define ARRAY_DEF(name, type, oplist)                                                   \
+    typedef struct {                                                                    \
+        size_t size;                                                                    \
+        size_t alloc;                                                                   \
+        type* ptr;                                                                      \
+    } name##_s;                                                                         \
+    typedef name##_s name##_t[1];                                                       \
+                                                                                        \
+    static inline void name##_init(name##_t array) {                                    \
+        array->size = 0;                                                                \
+        array->alloc = 0;                                                               \
+        array->ptr = NULL;                                                              \
+    }                                                                                   \
+    static inline void name##_clear(name##_t array) {                                   \
+        free(array->ptr);                                                               \
+        name##_init(array);                                                             \
+    }                                                                                   \
+    static inline void name##_reset(name##_t array) {                                   \
+        array->size = 0;                                                                \
+    }                                                                                   \
+    static inline type* name##_push_raw(name##_t array) {                               \
+        if(array->size == array->alloc) {                                               \
+            array->alloc = array->alloc ? array->alloc * 2 : 16;                        \
+            array->ptr = realloc(array->ptr, array->alloc * sizeof(type));              \
+        }                                                                               \
+        return &array->ptr[array->size++];                                              \
+    }                                                                                   \
+    static inline type* name##_get(name##_t array, size_t i) {                          \
+        return &array->ptr[i];                                                          \
+    }                                                                                   \
+    static inline size_t name##_size(name##_t array) {                                  \
+        return array->size;                                                             \
+    }
+
+#define M_EACH(item, array, type) \
+    (__typeof__((array)->ptr) item = (array)->ptr; item < (array)->ptr + (array)->size; item++)
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <furi.h>
+
+// Declared for the app headers, not implemented on the host
+#define RECORD_NOTIFICATION "notification"
+
+typedef struct NotificationApp NotificationApp;
@@ -0,0 +1,471 @@
+/* Host implementation of the firmware calls declared in tools/sdk. Behaviour follows the
+ * firmware where the app depends on it: the Manchester state machine, the block math and the
+ * 1 kHz tick. */
+
+#include <furi.h>
+#include <furi_hal.h>
+#include <locale/locale.h>
+#include <lib/toolbox/manchester_decoder.h>
+#include <lib/subghz/blocks/decoder.h>
+#include <lib/subghz/blocks/math.h>
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <time.h>
+
+FuriLogLevel furi_log_level = FuriLogLevelError;
+float furi_hal_subghz_rssi = -60.0f;
+FuriHalRtcLocaleUnits furi_hal_rtc_locale_units = FuriHalRtcLocaleUnitsMetric;
+
+void furi_log_print_format(FuriLogLevel level, const char* tag, const char* format, ...) {
+    if(level > furi_log_level) return;
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%s] ", tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    string->capacity = 32;
+    string->data = calloc(1, string->capacity);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size < string->capacity) return;
+    while(string->capacity <= size) string->capacity *= 2;
+    string->data = realloc(string->data, string->capacity);
+}
+
+static int furi_string_vcat_printf(FuriString* string, const char* format, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if(len < 0) return len;
+    furi_string_reserve(string, string->size + len);
+    vsnprintf(string->data + string->size, len + 1, format, args);
+    string->size += len;
+    return len;
+}
+
+int furi_string_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    furi_string_reset(string);
+    int len = furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return len;
+}
+
+int furi_string_cat_printf(FuriString* string, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int len = furi_string_vcat_printf(string, format, args);
+    va_end(args);
+    return len;
+}
+
+void furi_string_set_str(FuriString* string, const char* cstr) {
+    furi_string_printf(string, "%s", cstr);
+}
+
+void furi_string_cat_str(FuriString* string, const char* cstr) {
+    furi_string_cat_printf(string, "%s", cstr);
+}
+
+uint32_t furi_get_tick(void) {
+    static struct timespec start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(!start.tv_sec && !start.tv_nsec) start = now;
+    return (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    struct timespec delay = {milliseconds / 1000, (milliseconds % 1000) * 1000000L};
+    nanosleep(&delay, NULL);
+}
+
+#define RECORDS_MAX 8
+
+static struct {
+    const char* name;
+    void* data;
+} records[RECORDS_MAX];
+
+void furi_record_create(const char* name, void* data) {
+    for(size_t i = 0; i < RECORDS_MAX; i++) {
+        if(!records[i].name || !strcmp(records[i].name, name)) {
+            records[i].name = name;
+            records[i].data = data;
+            return;
+        }
+    }
+    furi_crash("Too many records");
+}
+
+void* furi_record_open(const char* name) {
+    for(size_t i = 0; i < RECORDS_MAX && records[i].name; i++) {
+        if(!strcmp(records[i].name, name)) return records[i].data;
+    }
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+struct FuriStreamBuffer {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    uint8_t* data;
+    size_t size;
+    size_t trigger_level;
+    size_t head; // next byte read
+    size_t count;
+};
+
+FuriStreamBuffer* furi_stream_buffer_alloc(size_t size, size_t trigger_level) {
+    FuriStreamBuffer* stream_buffer = calloc(1, sizeof(FuriStreamBuffer));
+    pthread_mutex_init(&stream_buffer->mutex, NULL);
+    pthread_cond_init(&stream_buffer->changed, NULL);
+    stream_buffer->data = malloc(size);
+    stream_buffer->size = size;
+    stream_buffer->trigger_level = trigger_level ? trigger_level : 1;
+    return stream_buffer;
+}
+
+void furi_stream_buffer_free(FuriStreamBuffer* stream_buffer) {
+    pthread_cond_destroy(&stream_buffer->changed);
+    pthread_mutex_destroy(&stream_buffer->mutex);
+    free(stream_buffer->data);
+    free(stream_buffer);
+}
+
+// Waits for the condition to change, false once the timeout in ticks has passed
+static bool furi_stream_buffer_wait(
+    FuriStreamBuffer* stream_buffer,
+    const struct timespec* deadline,
+    uint32_t timeout) {
+    if(!timeout) return false;
+    if(timeout == FuriWaitForever) {
+        pthread_cond_wait(&stream_buffer->changed, &stream_buffer->mutex);
+        return true;
+    }
+    return !pthread_cond_timedwait(&stream_buffer->changed, &stream_buffer->mutex, deadline);
+}
+
+static struct timespec furi_stream_buffer_deadline(uint32_t timeout) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    if(timeout != FuriWaitForever) {
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (timeout % 1000) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+    return deadline;
+}
+
+size_t furi_stream_buffer_send(
+    FuriStreamBuffer* stream_buffer,
+    const void* data,
+    size_t length,
+    uint32_t timeout) {
+    struct timespec deadline = furi_stream_buffer_deadline(timeout);
+    pthread_mutex_lock(&stream_buffer->mutex);
+    while(stream_buffer->count == stream_buffer->size &&
+          furi_stream_buffer_wait(stream_buffer, &deadline, timeout)) {
+    }
+    size_t sent = MIN(length, stream_buffer->size - stream_buffer->count);
+    for(size_t i = 0; i < sent; i++) {
+        size_t tail = (stream_buffer->head + stream_buffer->count) % stream_buffer->size;
+        stream_buffer->data[tail] = ((const uint8_t*)data)[i];
+        stream_buffer->count++;
+    }
+    pthread_cond_broadcast(&stream_buffer->changed);
+    pthread_mutex_unlock(&stream_buffer->mutex);
+    return sent;
+}
+
+size_t furi_stream_buffer_receive(
+    FuriStreamBuffer* stream_buffer,
+    void* data,
+    size_t length,
+    uint32_t timeout) {
+    struct timespec deadline = furi_stream_buffer_deadline(timeout);
+    pthread_mutex_lock(&stream_buffer->mutex);
+    while(stream_buffer->count < MIN(length, stream_buffer->trigger_level) &&
+          furi_stream_buffer_wait(stream_buffer, &deadline, timeout)) {
+    }
+    size_t received = MIN(length, stream_buffer->count);
+    for(size_t i = 0; i < received; i++) {
+        ((uint8_t*)data)[i] = stream_buffer->data[stream_buffer->head];
+        stream_buffer->head = (stream_buffer->head + 1) % stream_buffer->size;
+        stream_buffer->count--;
+    }
+    pthread_cond_broadcast(&stream_buffer->changed);
+    pthread_mutex_unlock(&stream_buffer->mutex);
+    return received;
+}
+
+size_t furi_stream_buffer_spaces_available(FuriStreamBuffer* stream_buffer) {
+    pthread_mutex_lock(&stream_buffer->mutex);
+    size_t spaces = stream_buffer->size - stream_buffer->count;
+    pthread_mutex_unlock(&stream_buffer->mutex);
+    return spaces;
+}
+
+void furi_stream_buffer_reset(FuriStreamBuffer* stream_buffer) {
+    pthread_mutex_lock(&stream_buffer->mutex);
+    stream_buffer->head = 0;
+    stream_buffer->count = 0;
+    pthread_cond_broadcast(&stream_buffer->changed);
+    pthread_mutex_unlock(&stream_buffer->mutex);
+}
+
+#ifdef TPMS_SDK_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t length = strlen(src);
+    if(size) {
+        size_t copied = MIN(length, size - 1);
+        memcpy(dst, src, copied);
+        dst[copied] = '\0';
+    }
+    return length;
+}
+
+size_t strlcat(char* dst, const char* src, size_t size) {
+    size_t length = strnlen(dst, size);
+    if(length == size) return size + strlen(src);
+    return length + strlcpy(dst + length, src, size - length);
+}
+#endif
+
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex* instance = malloc(sizeof(FuriMutex));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    if(type == FuriMutexTypeRecursive) {
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    }
+    pthread_mutex_init(&instance->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return instance;
+}
+
+void furi_mutex_free(FuriMutex* instance) {
+    pthread_mutex_destroy(&instance->mutex);
+    free(instance);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* instance, uint32_t timeout) {
+    if(timeout == FuriWaitForever) {
+        return pthread_mutex_lock(&instance->mutex) ? FuriStatusError : FuriStatusOk;
+    }
+    return pthread_mutex_trylock(&instance->mutex) ? FuriStatusErrorTimeout : FuriStatusOk;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* instance) {
+    return pthread_mutex_unlock(&instance->mutex) ? FuriStatusError : FuriStatusOk;
+}
+
+struct FuriTimer {
+    FuriTimerCallback func;
+    void* context;
+    bool running;
+};
+
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    UNUSED(type);
+    FuriTimer* instance = calloc(1, sizeof(FuriTimer));
+    instance->func = func;
+    instance->context = context;
+    return instance;
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
+    UNUSED(ticks);
+    instance->running = true;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer* instance) {
+    instance->running = false;
+    return FuriStatusOk;
+}
+
+float furi_hal_subghz_get_rssi(void) {
+    return furi_hal_subghz_rssi;
+}
+
+uint32_t furi_hal_rtc_get_timestamp(void) {
+    return time(NULL);
+}
+
+void furi_hal_rtc_get_datetime(DateTime* datetime) {
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    datetime->hour = local.tm_hour;
+    datetime->minute = local.tm_min;
+    datetime->second = local.tm_sec;
+    datetime->day = local.tm_mday;
+    datetime->month = local.tm_mon + 1;
+    datetime->year = local.tm_year + 1900;
+    datetime->weekday = local.tm_wday ? local.tm_wday : 7;
+}
+
+// The firmware counts the RTC fields as UTC
+uint32_t datetime_datetime_to_timestamp(DateTime* datetime) {
+    struct tm utc = {
+        .tm_sec = datetime->second,
+        .tm_min = datetime->minute,
+        .tm_hour = datetime->hour,
+        .tm_mday = datetime->day,
+        .tm_mon = datetime->month - 1,
+        .tm_year = datetime->year - 1900,
+    };
+    return timegm(&utc);
+}
+
+FuriHalRtcLocaleUnits furi_hal_rtc_get_locale_units(void) {
+    return furi_hal_rtc_locale_units;
+}
+
+void furi_hal_rfid_tim_read_start(float freq, float duty_cycle) {
+    UNUSED(freq);
+    UNUSED(duty_cycle);
+}
+
+void furi_hal_rfid_tim_read_stop(void) {
+}
+
+float locale_fahrenheit_to_celsius(float temp_f) {
+    return (temp_f - 32.0f) / 1.8f;
+}
+
+float locale_celsius_to_fahrenheit(float temp_c) {
+    return temp_c * 1.8f + 32.0f;
+}
+
+// Same table as the firmware toolbox
+static const uint8_t manchester_transitions[] = {0b00000001, 0b10010001, 0b10011011, 0b11111011};
+
+bool manchester_advance(
+    ManchesterState state,
+    ManchesterEvent event,
+    ManchesterState* next_state,
+    bool* data) {
+    bool result = false;
+    ManchesterState new_state;
+
+    if(event == ManchesterEventReset) {
+        new_state = ManchesterStateMid1;
+    } else {
+        new_state = (manchester_transitions[state] >> event) & 0x3;
+        if(new_state == state) {
+            new_state = ManchesterStateMid1;
+        } else if(new_state == ManchesterStateMid0) {
+            if(data) *data = false;
+            result = true;
+        } else if(new_state == ManchesterStateMid1) {
+            if(data) *data = true;
+            result = true;
+        }
+    }
+
+    *next_state = new_state;
+    return result;
+}
+
+uint8_t subghz_protocol_blocks_crc8(
+    uint8_t const message[],
+    size_t size,
+    uint8_t polynomial,
+    uint8_t init) {
+    uint8_t remainder = init;
+    for(size_t byte = 0; byte < size; ++byte) {
+        remainder ^= message[byte];
+        for(uint8_t bit = 0; bit < 8; ++bit) {
+            if(remainder & 0x80) {
+                remainder = (remainder << 1) ^ polynomial;
+            } else {
+                remainder = (remainder << 1);
+            }
+        }
+    }
+    return remainder;
+}
+
+uint8_t subghz_protocol_blocks_add_bytes(uint8_t const message[], size_t size) {
+    uint32_t result = 0;
+    for(size_t i = 0; i < size; ++i) {
+        result += message[i];
+    }
+    return (uint8_t)result;
+}
+
+uint8_t subghz_protocol_blocks_xor_bytes(uint8_t const message[], size_t size) {
+    uint8_t result = 0;
+    for(size_t i = 0; i < size; ++i) {
+        result ^= message[i];
+    }
+    return result;
+}
+
+void subghz_protocol_blocks_add_bit(SubGhzBlockDecoder* decoder, uint8_t bit) {
+    decoder->decode_data = decoder->decode_data << 1 | bit;
+    decoder->decode_count_bit++;
+}
+
+uint8_t subghz_protocol_blocks_get_hash_data(SubGhzBlockDecoder* decoder, size_t len) {
+    uint8_t hash = 0;
+    uint8_t* p = (uint8_t*)&decoder->decode_data;
+    for(size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+    }
+    return hash;
+}
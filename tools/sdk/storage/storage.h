@@ -0,0 +1,10 @@
+#pragma once
+
+#include <furi.h>
+
+// Declared for the app headers, not implemented on the host
+#define RECORD_STORAGE "storage"
+#define EXT_PATH(path) "/ext/" path
+
+typedef struct Storage Storage;
+typedef struct File File;
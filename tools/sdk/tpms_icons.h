@@ -0,0 +1,17 @@
+#pragma once
+
+#include <gui/icon.h>
+
+/* Generated from images/ by the firmware build. On the host only the sizes are kept, the tool
+ * that draws defines them */
+
+extern const Icon I_Fishing_123x52;
+extern const Icon I_Lock_7x8;
+extern const Icon I_Pin_back_arrow_10x8;
+extern const Icon I_Press_7x16;
+extern const Icon I_Quest_7x8;
+extern const Icon I_Scanning_123x52;
+extern const Icon I_Therm_7x16;
+extern const Icon I_Timer_11x11;
+extern const Icon I_Unlock_7x8;
+extern const Icon I_WarningDolphin_45x42;
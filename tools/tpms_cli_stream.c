@@ -0,0 +1,307 @@
+/* Host test of the `tpms` CLI command in helpers/tpms_cli.c. The tool plays the CLI service:
+ * the command runs on its own thread with its stdin and stdout on a pseudo-terminal, the test
+ * reads the lines from the other end and types Ctrl+C there, while it feeds frames the way the
+ * worker thread does.
+ *
+ * Build: cc -O2 -pthread -I sdk -I .. -o tpms_cli_stream tpms_cli_stream.c sdk/sdk.c \
+ *            ../helpers/tpms_cli.c
+ */
+
+#define _GNU_SOURCE
+#include <helpers/tpms_cli.h>
+#include <cli/cli.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define LINE_LEN 128
+#define TIMEOUT_MS 1000
+
+#define HEADER "tick,protocol,id,pressure,temperature,rssi,frequency"
+
+struct Cli {
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+    CliCallback callback;
+    void* context;
+    bool running;
+    // Holds the command at its next interrupt check, as if its thread was not scheduled
+    bool hold;
+    bool held;
+};
+
+static Cli cli = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .changed = PTHREAD_COND_INITIALIZER,
+};
+static pthread_t command_thread;
+static int master = -1;
+static FILE* report;
+static int failures;
+
+void cli_add_command(
+    Cli* instance,
+    const char* name,
+    CliCommandFlag flags,
+    CliCallback callback,
+    void* context) {
+    UNUSED(flags);
+    furi_assert(instance == &cli);
+    furi_assert(!strcmp(name, TPMS_CLI_COMMAND));
+    pthread_mutex_lock(&cli.mutex);
+    cli.callback = callback;
+    cli.context = context;
+    pthread_mutex_unlock(&cli.mutex);
+}
+
+void cli_delete_command(Cli* instance, const char* name) {
+    furi_assert(instance == &cli);
+    furi_assert(!strcmp(name, TPMS_CLI_COMMAND));
+    pthread_mutex_lock(&cli.mutex);
+    cli.callback = NULL;
+    pthread_mutex_unlock(&cli.mutex);
+}
+
+bool cli_cmd_interrupt_received(Cli* instance) {
+    pthread_mutex_lock(&instance->mutex);
+    while(instance->hold) {
+        instance->held = true;
+        pthread_cond_broadcast(&instance->changed);
+        pthread_cond_wait(&instance->changed, &instance->mutex);
+    }
+    instance->held = false;
+    pthread_mutex_unlock(&instance->mutex);
+
+    // Ctrl+C is ETX on a raw terminal
+    struct pollfd input = {.fd = STDIN_FILENO, .events = POLLIN};
+    char c;
+    while(poll(&input, 1, 0) > 0 && read(STDIN_FILENO, &c, 1) == 1) {
+        if(c == 0x03) return true;
+    }
+    return false;
+}
+
+static void* command_run(void* context) {
+    UNUSED(context);
+    FuriString* args = furi_string_alloc();
+    cli.callback(&cli, args, cli.context);
+    furi_string_free(args);
+    fflush(stdout);
+    pthread_mutex_lock(&cli.mutex);
+    cli.running = false;
+    pthread_cond_broadcast(&cli.changed);
+    pthread_mutex_unlock(&cli.mutex);
+    return NULL;
+}
+
+// Typed `tpms` at the prompt
+static void command_start(void) {
+    cli.running = true;
+    pthread_create(&command_thread, NULL, command_run, NULL);
+}
+
+// False if the command is still running after the timeout
+static bool command_join(void) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += TIMEOUT_MS / 1000;
+    pthread_mutex_lock(&cli.mutex);
+    while(cli.running && !pthread_cond_timedwait(&cli.changed, &cli.mutex, &deadline)) {
+    }
+    bool stopped = !cli.running;
+    pthread_mutex_unlock(&cli.mutex);
+    if(stopped) pthread_join(command_thread, NULL);
+    return stopped;
+}
+
+static void command_hold(bool hold) {
+    pthread_mutex_lock(&cli.mutex);
+    cli.hold = hold;
+    pthread_cond_broadcast(&cli.changed);
+    while(hold && !cli.held) {
+        pthread_cond_wait(&cli.changed, &cli.mutex);
+    }
+    pthread_mutex_unlock(&cli.mutex);
+}
+
+static bool terminal_open(void) {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if(master < 0 || grantpt(master) || unlockpt(master)) return false;
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if(slave < 0) return false;
+    // Raw, so the command's \r\n and Ctrl+C pass as they are
+    struct termios mode;
+    tcgetattr(slave, &mode);
+    cfmakeraw(&mode);
+    tcsetattr(slave, TCSANOW, &mode);
+
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    setvbuf(report, NULL, _IOLBF, 0);
+    dup2(slave, STDIN_FILENO);
+    dup2(slave, STDOUT_FILENO);
+    close(slave);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+// One line from the terminal without its \r\n. False on timeout
+static bool terminal_line(char* line) {
+    size_t len = 0;
+    struct pollfd output = {.fd = master, .events = POLLIN};
+    while(poll(&output, 1, TIMEOUT_MS) > 0) {
+        char c;
+        if(read(master, &c, 1) != 1) break;
+        if(c == '\n') {
+            if(len && line[len - 1] == '\r') len--;
+            line[len] = '\0';
+            return true;
+        }
+        if(len < LINE_LEN - 1) line[len++] = c;
+    }
+    line[len] = '\0';
+    return false;
+}
+
+// True if nothing arrives for a while
+static bool terminal_quiet(void) {
+    struct pollfd output = {.fd = master, .events = POLLIN};
+    return poll(&output, 1, 200) == 0;
+}
+
+static void terminal_type(char c) {
+    furi_check(write(master, &c, 1) == 1);
+}
+
+static void feed(TPMSCli* instance, uint32_t id, float pressure) {
+    TPMSBlockGeneric generic = {
+        .id = id,
+        .pressure = pressure,
+        .temperature = 25,
+        .rssi = -60.5f,
+    };
+    tpms_cli_feed(instance, "Schrader GG4", &generic, 433920000);
+}
+
+static void expect_line(const char* test, const char* expected) {
+    char line[LINE_LEN];
+    if(!terminal_line(line)) {
+        fprintf(report, "FAIL %s: no line, expected \"%s\"\n", test, expected);
+        failures++;
+    } else if(strcmp(line, expected)) {
+        fprintf(report, "FAIL %s: \"%s\", expected \"%s\"\n", test, line, expected);
+        failures++;
+    }
+}
+
+// A reading row, the tick column is not compared
+static void expect_reading(const char* test, uint32_t id, float pressure) {
+    char line[LINE_LEN];
+    char expected[LINE_LEN];
+    snprintf(
+        expected,
+        sizeof(expected),
+        "Schrader GG4,%08X,%.2f,25.0,-60.5,433920000",
+        id,
+        (double)pressure);
+    const char* columns = NULL;
+    if(terminal_line(line)) {
+        columns = strchr(line, ',');
+    }
+    if(!columns || strcmp(columns + 1, expected)) {
+        fprintf(report, "FAIL %s: \"%s\", expected \"<tick>,%s\"\n", test, line, expected);
+        failures++;
+    }
+}
+
+static void expect(const char* test, bool ok, const char* what) {
+    if(!ok) {
+        fprintf(report, "FAIL %s: %s\n", test, what);
+        failures++;
+    }
+}
+
+/* Frames are only streamed while the command runs, in the order they came, and Ctrl+C ends
+ * the command. A frame from before the command is not shown. */
+static void test_stream(TPMSCli* instance) {
+    const char* test = "stream";
+    feed(instance, 0xDEAD, 1.0f);
+    command_start();
+    expect_line(test, HEADER);
+    feed(instance, 0x00878456, 2.2f);
+    feed(instance, 0x00A1B2C3, 2.25f);
+    feed(instance, 0x00878456, 2.21f);
+    expect_reading(test, 0x00878456, 2.2f);
+    expect_reading(test, 0x00A1B2C3, 2.25f);
+    expect_reading(test, 0x00878456, 2.21f);
+    terminal_type(0x03);
+    expect(test, command_join(), "still running after Ctrl+C");
+}
+
+/* The worker never waits for the terminal: with the command held, the buffer takes
+ * TPMS_CLI_BUFFER_RECORDS frames and the rest are counted. Once the command runs again it
+ * prints what was buffered, in order, and reports the count. */
+static void test_overflow(TPMSCli* instance) {
+    const char* test = "overflow";
+    const uint32_t frames = TPMS_CLI_BUFFER_RECORDS + 8;
+    command_start();
+    expect_line(test, HEADER);
+    command_hold(true);
+    for(uint32_t i = 0; i < frames; i++) {
+        feed(instance, i, 2.0f);
+    }
+    expect(test, terminal_quiet(), "output while held");
+    command_hold(false);
+    char dropped[LINE_LEN];
+    snprintf(dropped, sizeof(dropped), "# %u dropped", frames - TPMS_CLI_BUFFER_RECORDS);
+    expect_reading(test, 0, 2.0f);
+    expect_line(test, dropped);
+    for(uint32_t i = 1; i < TPMS_CLI_BUFFER_RECORDS; i++) {
+        expect_reading(test, i, 2.0f);
+    }
+    expect(test, terminal_quiet(), "more rows than buffered");
+
+    // A new run starts with an empty buffer and no drops
+    terminal_type(0x03);
+    expect(test, command_join(), "still running after Ctrl+C");
+    command_start();
+    expect_line(test, HEADER);
+    feed(instance, 0x00878456, 2.2f);
+    expect_reading(test, 0x00878456, 2.2f);
+    expect(test, terminal_quiet(), "drops reported again");
+}
+
+static void test_free_timeout(int signal) {
+    UNUSED(signal);
+    static const char message[] = "FAIL free: tpms_cli_free did not return\nFAILED\n";
+    furi_check(write(fileno(report), message, sizeof(message) - 1) > 0);
+    _exit(1);
+}
+
+// Closing the app while the command streams ends the command before the instance goes
+static void test_free(TPMSCli* instance) {
+    const char* test = "free";
+    signal(SIGALRM, test_free_timeout);
+    alarm(TIMEOUT_MS / 1000 + 1);
+    tpms_cli_free(instance);
+    alarm(0);
+    expect(test, command_join(), "still running after free");
+    expect(test, cli.callback == NULL, "command still registered");
+}
+
+int main(void) {
+    if(!terminal_open()) {
+        perror("pseudo-terminal");
+        return 2;
+    }
+    furi_record_create(RECORD_CLI, &cli);
+    TPMSCli* instance = tpms_cli_alloc();
+    test_stream(instance);
+    test_overflow(instance);
+    test_free(instance);
+    fprintf(report, "%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
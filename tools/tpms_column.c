@@ -0,0 +1,552 @@
+#include "tpms_column.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TPMS_COLUMN_THREADS_MAX 64
+#define TPMS_COLUMN_ALIGN 8
+#define TPMS_COLUMN_MISSING_U8 0xFF
+#define TPMS_COLUMN_MISSING_U16 0xFFFF
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t protocol_count;
+    uint8_t reserved;
+    uint32_t block_rows;
+    uint32_t block_count;
+    uint64_t row_count;
+    uint64_t directory_offset;
+} TPMSColumnHeader;
+
+/** Block starts with the offset of each column from the block start, then column data */
+typedef struct {
+    uint32_t column_offset[TPMSColumnCount];
+} TPMSColumnBlockHeader;
+
+/* Encoding ------------------------------------------------------------------------------- */
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} Buffer;
+
+static void buffer_reserve(Buffer* buffer, size_t extra) {
+    if(buffer->size + extra <= buffer->capacity) return;
+    while(buffer->size + extra > buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+    }
+    buffer->data = realloc(buffer->data, buffer->capacity);
+    if(!buffer->data) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+}
+
+static void buffer_put(Buffer* buffer, const void* data, size_t size) {
+    buffer_reserve(buffer, size);
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static void buffer_put_varint(Buffer* buffer, uint64_t value) {
+    buffer_reserve(buffer, 10);
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer->data[buffer->size++] = byte | (value ? 0x80 : 0);
+    } while(value);
+}
+
+static void buffer_align(Buffer* buffer) {
+    static const uint8_t zero[TPMS_COLUMN_ALIGN] = {0};
+    size_t padding = (TPMS_COLUMN_ALIGN - buffer->size % TPMS_COLUMN_ALIGN) % TPMS_COLUMN_ALIGN;
+    buffer_put(buffer, zero, padding);
+}
+
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static void encode_time(Buffer* buffer, const TPMSLogRow* rows, size_t count, int64_t base) {
+    int64_t previous = base;
+    for(size_t i = 0; i < count; i++) {
+        buffer_put_varint(buffer, zigzag(rows[i].time_ms - previous));
+        previous = rows[i].time_ms;
+    }
+}
+
+/** u16 dictionary size, u32 dictionary, then u8 or u16 codes depending on dictionary size */
+static void encode_dictionary(Buffer* buffer, const uint32_t* values, size_t count) {
+    size_t capacity = 16;
+    while(capacity < count * 2) capacity <<= 1;
+    int32_t* slots = malloc(capacity * sizeof(int32_t));
+    uint32_t* dictionary = malloc(count * sizeof(uint32_t));
+    uint16_t* codes = malloc(count * sizeof(uint16_t));
+    memset(slots, -1, capacity * sizeof(int32_t));
+
+    uint16_t dictionary_count = 0;
+    for(size_t i = 0; i < count; i++) {
+        size_t slot = (values[i] * 0x9E3779B1u) & (capacity - 1);
+        while(slots[slot] >= 0 && dictionary[slots[slot]] != values[i]) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if(slots[slot] < 0) {
+            slots[slot] = dictionary_count;
+            dictionary[dictionary_count++] = values[i];
+        }
+        codes[i] = slots[slot];
+    }
+
+    buffer_put(buffer, &dictionary_count, sizeof(dictionary_count));
+    buffer_put(buffer, dictionary, dictionary_count * sizeof(uint32_t));
+    if(dictionary_count <= 0x100) {
+        buffer_reserve(buffer, count);
+        for(size_t i = 0; i < count; i++) buffer->data[buffer->size++] = codes[i];
+    } else {
+        buffer_put(buffer, codes, count * sizeof(uint16_t));
+    }
+
+    free(codes);
+    free(dictionary);
+    free(slots);
+}
+
+/** Frame of reference: values minus the block minimum, one byte wide when the range allows.
+ *  The block minimum is in the directory, so only the width is stored here */
+static void encode_offset(
+    Buffer* buffer,
+    const int16_t* values,
+    size_t count,
+    int16_t min,
+    int16_t max) {
+    uint8_t width = (min == TPMS_LOG_NO_VALUE || max - min < TPMS_COLUMN_MISSING_U8) ? 1 : 2;
+    buffer_put(buffer, &width, sizeof(width));
+    buffer_reserve(buffer, count * width);
+    for(size_t i = 0; i < count; i++) {
+        if(width == 1) {
+            buffer->data[buffer->size++] =
+                values[i] == TPMS_LOG_NO_VALUE ? TPMS_COLUMN_MISSING_U8 : values[i] - min;
+        } else {
+            uint16_t code =
+                values[i] == TPMS_LOG_NO_VALUE ? TPMS_COLUMN_MISSING_U16 : values[i] - min;
+            memcpy(buffer->data + buffer->size, &code, sizeof(code));
+            buffer->size += sizeof(code);
+        }
+    }
+}
+
+static void update_range(int16_t value, int16_t* min, int16_t* max) {
+    if(value == TPMS_LOG_NO_VALUE) return;
+    if(*min == TPMS_LOG_NO_VALUE || value < *min) *min = value;
+    if(*max == TPMS_LOG_NO_VALUE || value > *max) *max = value;
+}
+
+static uint8_t row_status(const TPMSLogRow* row) {
+    uint8_t status = 0;
+    if(row->battery_low == 1) status |= TPMS_COLUMN_STATUS_BATTERY_LOW;
+    if(row->battery_low == 0xFF) status |= TPMS_COLUMN_STATUS_NO_BATTERY;
+    if(row->flags & TPMS_LOG_FLAG_ALARM) status |= TPMS_COLUMN_STATUS_ALARM;
+    return status;
+}
+
+static void encode_block(
+    Buffer* buffer,
+    TPMSColumnBlockInfo* info,
+    const TPMSLogRow* rows,
+    size_t count) {
+    *info = (TPMSColumnBlockInfo){
+        .rows = count,
+        .time_min_ms = rows[0].time_ms,
+        .time_max_ms = rows[count - 1].time_ms,
+        .id_min = UINT32_MAX,
+        .pressure_min_cbar = TPMS_LOG_NO_VALUE,
+        .pressure_max_cbar = TPMS_LOG_NO_VALUE,
+        .temperature_min_dc = TPMS_LOG_NO_VALUE,
+        .temperature_max_dc = TPMS_LOG_NO_VALUE,
+        .rssi_min = INT8_MAX,
+        .rssi_max = INT8_MIN,
+    };
+
+    uint32_t* u32 = malloc(count * sizeof(uint32_t));
+    int16_t* pressure = malloc(count * sizeof(int16_t));
+    int16_t* temperature = malloc(count * sizeof(int16_t));
+    for(size_t i = 0; i < count; i++) {
+        const TPMSLogRow* row = &rows[i];
+        if(row->id < info->id_min) info->id_min = row->id;
+        if(row->id > info->id_max) info->id_max = row->id;
+        if(row->time_ms < info->time_min_ms) info->time_min_ms = row->time_ms;
+        if(row->time_ms > info->time_max_ms) info->time_max_ms = row->time_ms;
+        info->protocol_mask |= 1ULL << row->protocol;
+        update_range(row->pressure_cbar, &info->pressure_min_cbar, &info->pressure_max_cbar);
+        update_range(row->temperature_dc, &info->temperature_min_dc, &info->temperature_max_dc);
+        if(row->rssi < info->rssi_min) info->rssi_min = row->rssi;
+        if(row->rssi > info->rssi_max) info->rssi_max = row->rssi;
+        info->status_any |= row_status(row);
+        pressure[i] = row->pressure_cbar;
+        temperature[i] = row->temperature_dc;
+    }
+
+    TPMSColumnBlockHeader header = {0};
+    size_t start = buffer->size;
+    buffer_put(buffer, &header, sizeof(header));
+#define COLUMN_BEGIN(column) header.column_offset[column] = buffer->size - start
+
+    COLUMN_BEGIN(TPMSColumnTime);
+    encode_time(buffer, rows, count, info->time_min_ms);
+
+    COLUMN_BEGIN(TPMSColumnId);
+    for(size_t i = 0; i < count; i++) u32[i] = rows[i].id;
+    encode_dictionary(buffer, u32, count);
+
+    COLUMN_BEGIN(TPMSColumnProtocol);
+    buffer_reserve(buffer, count);
+    for(size_t i = 0; i < count; i++) buffer->data[buffer->size++] = rows[i].protocol;
+
+    COLUMN_BEGIN(TPMSColumnPressure);
+    encode_offset(buffer, pressure, count, info->pressure_min_cbar, info->pressure_max_cbar);
+
+    COLUMN_BEGIN(TPMSColumnTemperature);
+    encode_offset(
+        buffer, temperature, count, info->temperature_min_dc, info->temperature_max_dc);
+
+    COLUMN_BEGIN(TPMSColumnRssi);
+    buffer_reserve(buffer, count);
+    for(size_t i = 0; i < count; i++) buffer->data[buffer->size++] = rows[i].rssi;
+
+    COLUMN_BEGIN(TPMSColumnStatus);
+    buffer_reserve(buffer, count);
+    for(size_t i = 0; i < count; i++) buffer->data[buffer->size++] = row_status(&rows[i]);
+
+    COLUMN_BEGIN(TPMSColumnFrequency);
+    for(size_t i = 0; i < count; i++) u32[i] = rows[i].frequency;
+    encode_dictionary(buffer, u32, count);
+#undef COLUMN_BEGIN
+
+    buffer_align(buffer);
+    memcpy(buffer->data + start, &header, sizeof(header));
+    info->size = buffer->size - start;
+
+    free(temperature);
+    free(pressure);
+    free(u32);
+}
+
+/* Writer --------------------------------------------------------------------------------- */
+
+typedef struct {
+    const TPMSLog* log;
+    size_t block_rows;
+    uint32_t block_count;
+    atomic_uint next_block;
+    Buffer* buffers;
+    TPMSColumnBlockInfo* infos;
+} Encoder;
+
+static void* encoder_worker(void* context) {
+    Encoder* encoder = context;
+    uint32_t index;
+    while((index = atomic_fetch_add(&encoder->next_block, 1)) < encoder->block_count) {
+        size_t begin = index * encoder->block_rows;
+        size_t end = begin + encoder->block_rows;
+        if(end > encoder->log->count) end = encoder->log->count;
+        encode_block(
+            &encoder->buffers[index],
+            &encoder->infos[index],
+            &encoder->log->rows[begin],
+            end - begin);
+    }
+    return NULL;
+}
+
+static int compare_row(const void* a, const void* b) {
+    const TPMSLogRow* x = a;
+    const TPMSLogRow* y = b;
+    if(x->time_ms != y->time_ms) return (x->time_ms > y->time_ms) - (x->time_ms < y->time_ms);
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+bool tpms_column_write(const char* path, TPMSLog* log, size_t block_rows, unsigned threads) {
+    if(block_rows == 0) block_rows = TPMS_COLUMN_BLOCK_ROWS;
+    if(block_rows > TPMS_COLUMN_BLOCK_ROWS_MAX) block_rows = TPMS_COLUMN_BLOCK_ROWS_MAX;
+    if(threads == 0) threads = tpms_log_cpu_count();
+    if(threads > TPMS_COLUMN_THREADS_MAX) threads = TPMS_COLUMN_THREADS_MAX;
+
+    // Time order makes block time ranges disjoint, which is what most queries prune on
+    qsort(log->rows, log->count, sizeof(TPMSLogRow), compare_row);
+
+    Encoder encoder = {
+        .log = log,
+        .block_rows = block_rows,
+        .block_count = (log->count + block_rows - 1) / block_rows,
+    };
+    encoder.buffers = calloc(encoder.block_count + 1, sizeof(Buffer));
+    encoder.infos = calloc(encoder.block_count + 1, sizeof(TPMSColumnBlockInfo));
+
+    pthread_t ids[TPMS_COLUMN_THREADS_MAX];
+    for(unsigned t = 1; t < threads; t++) {
+        pthread_create(&ids[t], NULL, encoder_worker, &encoder);
+    }
+    encoder_worker(&encoder);
+    for(unsigned t = 1; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+
+    FILE* out = fopen(path, "wb");
+    if(!out) {
+        perror(path);
+        return false;
+    }
+
+    TPMSColumnHeader header = {
+        .magic = TPMS_COLUMN_MAGIC,
+        .version = TPMS_COLUMN_VERSION,
+        .protocol_count = log->protocol_count,
+        .block_rows = block_rows,
+        .block_count = encoder.block_count,
+        .row_count = log->count,
+    };
+    bool res = fwrite(&header, sizeof(header), 1, out) == 1;
+    if(log->protocol_count) {
+        res &= fwrite(log->protocols, TPMS_LOG_PROTOCOL_LEN, log->protocol_count, out) ==
+               log->protocol_count;
+    }
+
+    // Header and dictionary are multiples of 16 bytes, blocks keep the alignment
+    uint64_t offset = sizeof(header) + (uint64_t)log->protocol_count * TPMS_LOG_PROTOCOL_LEN;
+    for(uint32_t i = 0; i < encoder.block_count && res; i++) {
+        encoder.infos[i].offset = offset;
+        res = fwrite(encoder.buffers[i].data, 1, encoder.buffers[i].size, out) ==
+              encoder.buffers[i].size;
+        offset += encoder.buffers[i].size;
+        free(encoder.buffers[i].data);
+    }
+
+    header.directory_offset = offset;
+    if(res && encoder.block_count) {
+        res = fwrite(encoder.infos, sizeof(TPMSColumnBlockInfo), encoder.block_count, out) ==
+              encoder.block_count;
+    }
+    res = res && fseek(out, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, out) == 1;
+    res = (fclose(out) == 0) && res;
+    if(!res) fprintf(stderr, "%s: write failed\n", path);
+
+    free(encoder.infos);
+    free(encoder.buffers);
+    return res;
+}
+
+/* Reader --------------------------------------------------------------------------------- */
+
+bool tpms_column_open(TPMSColumnFile* file, const char* path) {
+    memset(file, 0, sizeof(TPMSColumnFile));
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(TPMSColumnHeader)) {
+        fprintf(stderr, "%s: not a columnar log\n", path);
+        close(fd);
+        return false;
+    }
+    file->size = st.st_size;
+    file->data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(file->data == MAP_FAILED) {
+        perror(path);
+        file->data = NULL;
+        return false;
+    }
+
+    TPMSColumnHeader header;
+    memcpy(&header, file->data, sizeof(header));
+    size_t dictionary_end = sizeof(header) + header.protocol_count * TPMS_LOG_PROTOCOL_LEN;
+    if(header.magic != TPMS_COLUMN_MAGIC || header.version != TPMS_COLUMN_VERSION ||
+       header.protocol_count > TPMS_LOG_PROTOCOLS_MAX || dictionary_end > file->size ||
+       header.directory_offset % TPMS_COLUMN_ALIGN ||
+       header.directory_offset > file->size ||
+       (file->size - header.directory_offset) / sizeof(TPMSColumnBlockInfo) <
+           header.block_count) {
+        fprintf(stderr, "%s: not a columnar log\n", path);
+        tpms_column_close(file);
+        return false;
+    }
+
+    file->row_count = header.row_count;
+    file->block_count = header.block_count;
+    file->protocol_count = header.protocol_count;
+    for(uint8_t i = 0; i < header.protocol_count; i++) {
+        memcpy(
+            file->protocols[i],
+            file->data + sizeof(header) + i * TPMS_LOG_PROTOCOL_LEN,
+            TPMS_LOG_PROTOCOL_LEN);
+        file->protocols[i][TPMS_LOG_PROTOCOL_LEN - 1] = '\0';
+    }
+    file->blocks = (const TPMSColumnBlockInfo*)(file->data + header.directory_offset);
+    return true;
+}
+
+void tpms_column_close(TPMSColumnFile* file) {
+    if(file->data) munmap((void*)file->data, file->size);
+    file->data = NULL;
+}
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} Cursor;
+
+static bool cursor_read(Cursor* cursor, void* out, size_t size) {
+    if((size_t)(cursor->end - cursor->p) < size) return false;
+    memcpy(out, cursor->p, size);
+    cursor->p += size;
+    return true;
+}
+
+static bool decode_time(Cursor* cursor, int64_t* out, size_t count, int64_t base) {
+    int64_t value = base;
+    for(size_t i = 0; i < count; i++) {
+        uint64_t raw = 0;
+        for(unsigned shift = 0;; shift += 7) {
+            if(cursor->p == cursor->end || shift > 63) return false;
+            uint8_t byte = *cursor->p++;
+            raw |= (uint64_t)(byte & 0x7F) << shift;
+            if(!(byte & 0x80)) break;
+        }
+        value += unzigzag(raw);
+        out[i] = value;
+    }
+    return true;
+}
+
+static bool decode_dictionary(Cursor* cursor, uint32_t* out, size_t count) {
+    uint16_t dictionary_count;
+    if(!cursor_read(cursor, &dictionary_count, sizeof(dictionary_count))) return false;
+    const uint8_t* dictionary = cursor->p;
+    if((size_t)(cursor->end - cursor->p) < dictionary_count * sizeof(uint32_t)) return false;
+    cursor->p += dictionary_count * sizeof(uint32_t);
+
+    size_t width = dictionary_count <= 0x100 ? 1 : 2;
+    if((size_t)(cursor->end - cursor->p) < count * width) return false;
+    for(size_t i = 0; i < count; i++) {
+        uint16_t code = cursor->p[i * width];
+        if(width == 2) memcpy(&code, cursor->p + i * width, sizeof(code));
+        if(code >= dictionary_count) return false;
+        memcpy(&out[i], dictionary + code * sizeof(uint32_t), sizeof(uint32_t));
+    }
+    cursor->p += count * width;
+    return true;
+}
+
+static bool decode_offset(Cursor* cursor, int16_t* out, size_t count, int16_t min) {
+    uint8_t width;
+    if(!cursor_read(cursor, &width, sizeof(width)) || (width != 1 && width != 2)) return false;
+    if((size_t)(cursor->end - cursor->p) < count * width) return false;
+    for(size_t i = 0; i < count; i++) {
+        if(width == 1) {
+            uint8_t code = cursor->p[i];
+            out[i] = code == TPMS_COLUMN_MISSING_U8 ? TPMS_LOG_NO_VALUE : min + code;
+        } else {
+            uint16_t code;
+            memcpy(&code, cursor->p + i * 2, sizeof(code));
+            out[i] = code == TPMS_COLUMN_MISSING_U16 ? TPMS_LOG_NO_VALUE : min + code;
+        }
+    }
+    cursor->p += count * width;
+    return true;
+}
+
+static bool decode_bytes(Cursor* cursor, void* out, size_t count) {
+    return cursor_read(cursor, out, count);
+}
+
+bool tpms_column_read_block(
+    const TPMSColumnFile* file,
+    uint32_t index,
+    uint32_t columns,
+    TPMSColumnBlock* block) {
+    memset(block, 0, sizeof(TPMSColumnBlock));
+    if(index >= file->block_count) return false;
+    const TPMSColumnBlockInfo* info = &file->blocks[index];
+    if(info->offset > file->size || info->size > file->size - info->offset ||
+       info->size < sizeof(TPMSColumnBlockHeader) || info->rows > TPMS_COLUMN_BLOCK_ROWS_MAX) {
+        return false;
+    }
+
+    const uint8_t* start = file->data + info->offset;
+    TPMSColumnBlockHeader header;
+    memcpy(&header, start, sizeof(header));
+    size_t count = info->rows;
+    block->rows = count;
+
+    bool res = true;
+    for(unsigned column = 0; column < TPMSColumnCount && res; column++) {
+        if(!(columns & TPMS_COLUMN_MASK(column))) continue;
+        if(header.column_offset[column] > info->size) return false;
+        Cursor cursor = {start + header.column_offset[column], start + info->size};
+
+        switch(column) {
+        case TPMSColumnTime:
+            block->time_ms = malloc(count * sizeof(int64_t));
+            res = decode_time(&cursor, block->time_ms, count, info->time_min_ms);
+            break;
+        case TPMSColumnId:
+            block->id = malloc(count * sizeof(uint32_t));
+            res = decode_dictionary(&cursor, block->id, count);
+            break;
+        case TPMSColumnProtocol:
+            block->protocol = malloc(count);
+            res = decode_bytes(&cursor, block->protocol, count);
+            break;
+        case TPMSColumnPressure:
+            block->pressure_cbar = malloc(count * sizeof(int16_t));
+            res = decode_offset(&cursor, block->pressure_cbar, count, info->pressure_min_cbar);
+            break;
+        case TPMSColumnTemperature:
+            block->temperature_dc = malloc(count * sizeof(int16_t));
+            res = decode_offset(
+                &cursor, block->temperature_dc, count, info->temperature_min_dc);
+            break;
+        case TPMSColumnRssi:
+            block->rssi = malloc(count);
+            res = decode_bytes(&cursor, block->rssi, count);
+            break;
+        case TPMSColumnStatus:
+            block->status = malloc(count);
+            res = decode_bytes(&cursor, block->status, count);
+            break;
+        case TPMSColumnFrequency:
+            block->frequency = malloc(count * sizeof(uint32_t));
+            res = decode_dictionary(&cursor, block->frequency, count);
+            break;
+        }
+    }
+    if(!res) tpms_column_block_free(block);
+    return res;
+}
+
+void tpms_column_block_free(TPMSColumnBlock* block) {
+    free(block->time_ms);
+    free(block->id);
+    free(block->protocol);
+    free(block->pressure_cbar);
+    free(block->temperature_dc);
+    free(block->rssi);
+    free(block->status);
+    free(block->frequency);
+    memset(block, 0, sizeof(TPMSColumnBlock));
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/* Columnar session log format, for scans that touch a few columns of many rows.
+ *
+ * Rows are sorted by time and cut into blocks. Each block stores every column on its own:
+ * time as delta varints, id and frequency dictionary encoded, pressure and temperature as
+ * offsets from the block minimum. A directory at the end of the file keeps per block min/max
+ * of each column, so a query reads only blocks whose range can match. */
+
+#include "tpms_log.h"
+
+#define TPMS_COLUMN_MAGIC 0x4C435054 // "TPCL"
+#define TPMS_COLUMN_VERSION 1
+#define TPMS_COLUMN_BLOCK_ROWS 16384
+#define TPMS_COLUMN_BLOCK_ROWS_MAX 65535
+
+typedef enum {
+    TPMSColumnTime,
+    TPMSColumnId,
+    TPMSColumnProtocol,
+    TPMSColumnPressure,
+    TPMSColumnTemperature,
+    TPMSColumnRssi,
+    TPMSColumnStatus,
+    TPMSColumnFrequency,
+    TPMSColumnCount,
+} TPMSColumn;
+
+#define TPMS_COLUMN_MASK(column) (1u << (column))
+#define TPMS_COLUMN_MASK_ALL ((1u << TPMSColumnCount) - 1)
+
+// Status column bits
+#define TPMS_COLUMN_STATUS_BATTERY_LOW 0x01
+#define TPMS_COLUMN_STATUS_NO_BATTERY 0x02
+#define TPMS_COLUMN_STATUS_ALARM 0x04
+
+/** Per block statistics, kept in the file directory */
+typedef struct {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t rows;
+    int64_t time_min_ms;
+    int64_t time_max_ms;
+    uint32_t id_min;
+    uint32_t id_max;
+    uint64_t protocol_mask; // bit n set when protocol n occurs
+    int16_t pressure_min_cbar; // TPMS_LOG_NO_VALUE when the block has no pressure
+    int16_t pressure_max_cbar;
+    int16_t temperature_min_dc;
+    int16_t temperature_max_dc;
+    int8_t rssi_min;
+    int8_t rssi_max;
+    uint8_t status_any; // OR of the status column
+    uint8_t reserved[5];
+} TPMSColumnBlockInfo;
+
+/** Decoded block. Arrays of columns not asked for are NULL */
+typedef struct {
+    size_t rows;
+    int64_t* time_ms;
+    uint32_t* id;
+    uint8_t* protocol;
+    int16_t* pressure_cbar;
+    int16_t* temperature_dc;
+    int8_t* rssi;
+    uint8_t* status;
+    uint32_t* frequency;
+} TPMSColumnBlock;
+
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    uint64_t row_count;
+    uint32_t block_count;
+    uint8_t protocol_count;
+    char protocols[TPMS_LOG_PROTOCOLS_MAX][TPMS_LOG_PROTOCOL_LEN];
+    const TPMSColumnBlockInfo* blocks;
+} TPMSColumnFile;
+
+/** Write a log in columnar form. Rows are sorted by time first, blocks encode in parallel
+ *
+ * @param path          - output file
+ * @param log           - rows to write, reordered in place
+ * @param block_rows    - rows per block, up to TPMS_COLUMN_BLOCK_ROWS_MAX
+ * @param threads       - encoder threads, 0 picks the number of CPUs
+ * @return bool         - file written
+ */
+bool tpms_column_write(const char* path, TPMSLog* log, size_t block_rows, unsigned threads);
+
+/** Map a columnar file
+ *
+ * @param file  - TPMSColumnFile to fill
+ * @param path  - file path
+ * @return bool - file is valid
+ */
+bool tpms_column_open(TPMSColumnFile* file, const char* path);
+
+/** Unmap a columnar file
+ *
+ * @param file - TPMSColumnFile instance
+ */
+void tpms_column_close(TPMSColumnFile* file);
+
+/** Decode columns of one block
+ *
+ * @param file      - TPMSColumnFile instance
+ * @param index     - block index
+ * @param columns   - TPMS_COLUMN_MASK of the columns to decode
+ * @param block     - decoded block, freed with tpms_column_block_free
+ * @return bool     - block is valid
+ */
+bool tpms_column_read_block(
+    const TPMSColumnFile* file,
+    uint32_t index,
+    uint32_t columns,
+    TPMSColumnBlock* block);
+
+/** Free arrays of a decoded block
+ *
+ * @param block - TPMSColumnBlock instance
+ */
+void tpms_column_block_free(TPMSColumnBlock* block);
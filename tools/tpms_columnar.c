@@ -0,0 +1,319 @@
+/* Converts session logs to the columnar format and queries it.
+ *
+ * A query checks each block's min/max in the file directory first and decodes only blocks
+ * that can hold a match, and of those only the columns the filter needs. Columns printed
+ * are decoded for blocks that have at least one matching row.
+ *
+ * Build: cc -O2 -pthread -o tpms_columnar tpms_columnar.c tpms_column.c tpms_log.c
+ */
+
+#include "tpms_column.h"
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TPMS_COLUMNAR_FILES_MAX 256
+
+typedef struct {
+    int64_t since_ms;
+    int64_t until_ms;
+    int16_t pressure_below_cbar;
+    int16_t pressure_above_cbar;
+    bool id_set;
+    uint32_t id;
+    int protocol; // index into the file dictionary, -1 for any
+    bool count_only;
+} Query;
+
+static void usage(const char* name) {
+    fprintf(
+        stderr,
+        "Usage: %s convert [-b ROWS] [-j THREADS] OUT LOG [LOG ...]\n"
+        "       %s info FILE\n"
+        "       %s query [options] FILE\n"
+        "  -s TIME     rows at or after TIME\n"
+        "  -u TIME     rows before TIME\n"
+        "              TIME is unix seconds, or a count of d, h or m before now (7d)\n"
+        "  -p BAR      pressure below BAR\n"
+        "  -P BAR      pressure above BAR\n"
+        "  -i ID       sensor ID, hex\n"
+        "  -r NAME     protocol\n"
+        "  -c          print the number of matching rows only\n",
+        name,
+        name,
+        name);
+}
+
+static int64_t parse_time_ms(const char* text) {
+    char* end;
+    double value = strtod(text, &end);
+    int64_t unit = 0;
+    switch(*end) {
+    case '\0':
+        return value * 1000;
+    case 'd':
+        unit = 86400;
+        break;
+    case 'h':
+        unit = 3600;
+        break;
+    case 'm':
+        unit = 60;
+        break;
+    default:
+        fprintf(stderr, "Bad time: %s\n", text);
+        exit(2);
+    }
+    return ((int64_t)time(NULL) - (int64_t)(value * unit)) * 1000;
+}
+
+static int command_convert(int argc, char** argv) {
+    size_t block_rows = TPMS_COLUMN_BLOCK_ROWS;
+    unsigned threads = 0;
+    int opt;
+    while((opt = getopt(argc, argv, "b:j:")) != -1) {
+        switch(opt) {
+        case 'b':
+            block_rows = atoi(optarg);
+            break;
+        case 'j':
+            threads = atoi(optarg);
+            break;
+        default:
+            return 2;
+        }
+    }
+    if(argc - optind < 2 || argc - optind - 1 > TPMS_COLUMNAR_FILES_MAX) return 2;
+    const char* out = argv[optind];
+
+    TPMSLog log;
+    if(!tpms_log_load(&log, (const char* const*)&argv[optind + 1], argc - optind - 1, threads)) {
+        return 1;
+    }
+    bool res = tpms_column_write(out, &log, block_rows, threads);
+    if(res) {
+        fprintf(
+            stderr,
+            "%zu rows%s\n",
+            log.count,
+            log.skipped ? " (some lines skipped)" : "");
+    }
+    tpms_log_free(&log);
+    return res ? 0 : 1;
+}
+
+static int command_info(int argc, char** argv) {
+    if(argc - optind != 1) return 2;
+    TPMSColumnFile file;
+    if(!tpms_column_open(&file, argv[optind])) return 1;
+
+    printf(
+        "%" PRIu64 " rows, %u blocks, %zu bytes\n", file.row_count, file.block_count, file.size);
+    printf("protocols:");
+    for(uint8_t i = 0; i < file.protocol_count; i++) printf(" %s", file.protocols[i]);
+    printf("\nblock,rows,bytes,time_min,time_max,id_min,id_max,pressure_min,pressure_max\n");
+    for(uint32_t i = 0; i < file.block_count; i++) {
+        const TPMSColumnBlockInfo* info = &file.blocks[i];
+        printf(
+            "%u,%u,%u,%.3f,%.3f,%08" PRIX32 ",%08" PRIX32 ",%.2f,%.2f\n",
+            i,
+            info->rows,
+            info->size,
+            info->time_min_ms / 1000.0,
+            info->time_max_ms / 1000.0,
+            info->id_min,
+            info->id_max,
+            info->pressure_min_cbar / 100.0,
+            info->pressure_max_cbar / 100.0);
+    }
+    tpms_column_close(&file);
+    return 0;
+}
+
+static bool query_block_may_match(const Query* query, const TPMSColumnBlockInfo* info) {
+    if(info->time_max_ms < query->since_ms || info->time_min_ms >= query->until_ms) {
+        return false;
+    }
+    if(query->id_set && (query->id < info->id_min || query->id > info->id_max)) return false;
+    if(query->protocol >= 0 && !(info->protocol_mask & (1ULL << query->protocol))) {
+        return false;
+    }
+    if(query->pressure_below_cbar != INT16_MAX || query->pressure_above_cbar != INT16_MIN) {
+        if(info->pressure_min_cbar == TPMS_LOG_NO_VALUE) return false;
+        if(info->pressure_min_cbar >= query->pressure_below_cbar) return false;
+        if(info->pressure_max_cbar <= query->pressure_above_cbar) return false;
+    }
+    return true;
+}
+
+static uint32_t query_filter_columns(const Query* query) {
+    uint32_t columns = TPMS_COLUMN_MASK(TPMSColumnTime);
+    if(query->id_set) columns |= TPMS_COLUMN_MASK(TPMSColumnId);
+    if(query->protocol >= 0) columns |= TPMS_COLUMN_MASK(TPMSColumnProtocol);
+    if(query->pressure_below_cbar != INT16_MAX || query->pressure_above_cbar != INT16_MIN) {
+        columns |= TPMS_COLUMN_MASK(TPMSColumnPressure);
+    }
+    return columns;
+}
+
+static bool query_row_matches(const Query* query, const TPMSColumnBlock* block, size_t i) {
+    if(block->time_ms[i] < query->since_ms || block->time_ms[i] >= query->until_ms) return false;
+    if(query->id_set && block->id[i] != query->id) return false;
+    if(query->protocol >= 0 && block->protocol[i] != query->protocol) return false;
+    if(block->pressure_cbar) {
+        int16_t pressure = block->pressure_cbar[i];
+        if(pressure == TPMS_LOG_NO_VALUE || pressure >= query->pressure_below_cbar ||
+           pressure <= query->pressure_above_cbar) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_value(int16_t value, double scale, const char* format) {
+    if(value != TPMS_LOG_NO_VALUE) printf(format, value / scale);
+}
+
+static void print_row(const TPMSColumnFile* file, const TPMSColumnBlock* block, size_t i) {
+    printf(
+        "%" PRId64 ".%03d,%s,%08" PRIX32 ",",
+        block->time_ms[i] / 1000,
+        (int)(block->time_ms[i] % 1000),
+        block->protocol[i] < file->protocol_count ? file->protocols[block->protocol[i]] : "",
+        block->id[i]);
+    print_value(block->pressure_cbar[i], 100.0, "%.2f");
+    printf(",");
+    print_value(block->temperature_dc[i], 10.0, "%.1f");
+    uint8_t status = block->status[i];
+    printf(
+        ",%s,%u,%d,%" PRIu32 "\n",
+        (status & TPMS_COLUMN_STATUS_NO_BATTERY)  ? "" :
+        (status & TPMS_COLUMN_STATUS_BATTERY_LOW) ? "1" :
+                                                    "0",
+        (status & TPMS_COLUMN_STATUS_ALARM) ? 1 : 0,
+        block->rssi[i],
+        block->frequency[i]);
+}
+
+static int command_query(int argc, char** argv) {
+    Query query = {
+        .since_ms = INT64_MIN,
+        .until_ms = INT64_MAX,
+        .pressure_below_cbar = INT16_MAX,
+        .pressure_above_cbar = INT16_MIN,
+        .protocol = -1,
+    };
+    const char* protocol = NULL;
+    int opt;
+    while((opt = getopt(argc, argv, "s:u:p:P:i:r:c")) != -1) {
+        switch(opt) {
+        case 's':
+            query.since_ms = parse_time_ms(optarg);
+            break;
+        case 'u':
+            query.until_ms = parse_time_ms(optarg);
+            break;
+        case 'p':
+            query.pressure_below_cbar = atof(optarg) * 100 + 0.5;
+            break;
+        case 'P':
+            query.pressure_above_cbar = atof(optarg) * 100 + 0.5;
+            break;
+        case 'i':
+            query.id_set = true;
+            query.id = strtoul(optarg, NULL, 16);
+            break;
+        case 'r':
+            protocol = optarg;
+            break;
+        case 'c':
+            query.count_only = true;
+            break;
+        default:
+            return 2;
+        }
+    }
+    if(argc - optind != 1) return 2;
+
+    TPMSColumnFile file;
+    if(!tpms_column_open(&file, argv[optind])) return 1;
+    if(protocol) {
+        // A protocol the file never saw matches nothing, index 64 is outside every mask
+        query.protocol = TPMS_LOG_PROTOCOLS_MAX;
+        for(uint8_t i = 0; i < file.protocol_count; i++) {
+            if(!strcmp(file.protocols[i], protocol)) query.protocol = i;
+        }
+    }
+
+    uint32_t filter_columns = query_filter_columns(&query);
+    uint32_t blocks_read = 0;
+    uint64_t matches = 0;
+    bool res = true;
+    uint8_t* selected = malloc(TPMS_COLUMN_BLOCK_ROWS_MAX);
+    if(!query.count_only) {
+        printf("time,protocol,id,pressure,temperature,battery,alarm,rssi,frequency\n");
+    }
+
+    for(uint32_t b = 0; b < file.block_count && res; b++) {
+        if(query.protocol == TPMS_LOG_PROTOCOLS_MAX) break;
+        if(!query_block_may_match(&query, &file.blocks[b])) continue;
+
+        TPMSColumnBlock block;
+        if(!tpms_column_read_block(&file, b, filter_columns, &block)) {
+            res = false;
+            break;
+        }
+        blocks_read++;
+        size_t selected_count = 0;
+        for(size_t i = 0; i < block.rows; i++) {
+            selected[i] = query_row_matches(&query, &block, i);
+            selected_count += selected[i];
+        }
+        matches += selected_count;
+        tpms_column_block_free(&block);
+        if(query.count_only || !selected_count) continue;
+
+        if(!tpms_column_read_block(&file, b, TPMS_COLUMN_MASK_ALL, &block)) {
+            res = false;
+            break;
+        }
+        for(size_t i = 0; i < block.rows; i++) {
+            if(selected[i]) print_row(&file, &block, i);
+        }
+        tpms_column_block_free(&block);
+    }
+
+    if(query.count_only) printf("%" PRIu64 "\n", matches);
+    if(!res) fprintf(stderr, "%s: corrupt block\n", argv[optind]);
+    fprintf(
+        stderr,
+        "%" PRIu64 " rows matched, %u of %u blocks read\n",
+        matches,
+        blocks_read,
+        file.block_count);
+    free(selected);
+    tpms_column_close(&file);
+    return res ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    int res = 2;
+    optind = 2;
+    if(!strcmp(argv[1], "convert")) {
+        res = command_convert(argc, argv);
+    } else if(!strcmp(argv[1], "info")) {
+        res = command_info(argc, argv);
+    } else if(!strcmp(argv[1], "query")) {
+        res = command_query(argc, argv);
+    }
+    if(res == 2) usage(argv[0]);
+    return res;
+}
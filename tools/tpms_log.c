@@ -0,0 +1,373 @@
+#include "tpms_log.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TPMS_LOG_THREADS_MAX 64
+// Smaller files are not worth splitting
+#define TPMS_LOG_CHUNK_MIN (1 << 20)
+
+typedef enum {
+    TPMSLogColumnTime,
+    TPMSLogColumnProtocol,
+    TPMSLogColumnId,
+    TPMSLogColumnPressure,
+    TPMSLogColumnTemperature,
+    TPMSLogColumnBattery,
+    TPMSLogColumnAlarm,
+    TPMSLogColumnRssi,
+    TPMSLogColumnFrequency,
+    TPMSLogColumnCount,
+} TPMSLogColumn;
+
+static const char* const tpms_log_column_names[TPMSLogColumnCount] = {
+    "time",
+    "protocol",
+    "id",
+    "pressure",
+    "temperature",
+    "battery",
+    "alarm",
+    "rssi",
+    "frequency",
+};
+
+#define TPMS_LOG_FIELDS_MAX 32
+
+typedef struct {
+    // Field index of each known column, -1 when the log has no such column
+    int8_t field[TPMSLogColumnCount];
+} TPMSLogLayout;
+
+typedef struct {
+    const char* begin;
+    const char* end;
+    const TPMSLogLayout* layout;
+
+    TPMSLogRow* rows;
+    size_t count;
+    size_t capacity;
+    size_t skipped;
+
+    uint8_t protocol_count;
+    char protocols[TPMS_LOG_PROTOCOLS_MAX][TPMS_LOG_PROTOCOL_LEN];
+} TPMSLogChunk;
+
+/** Decimal with optional sign and fraction, scaled by 10^decimals. Digits past that are cut */
+static bool tpms_log_parse_fixed(const char* p, const char* end, int decimals, int64_t* value) {
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+    if(p == end) return false;
+
+    int64_t result = 0;
+    bool digits = false;
+    for(; p < end && *p >= '0' && *p <= '9'; p++) {
+        result = result * 10 + (*p - '0');
+        digits = true;
+    }
+    int scale = decimals;
+    if(p < end && *p == '.') {
+        for(p++; p < end && *p >= '0' && *p <= '9'; p++) {
+            if(scale > 0) {
+                result = result * 10 + (*p - '0');
+                scale--;
+            }
+            digits = true;
+        }
+    }
+    if(!digits || p != end) return false;
+    for(; scale > 0; scale--) result *= 10;
+
+    *value = negative ? -result : result;
+    return true;
+}
+
+static bool tpms_log_parse_hex(const char* p, const char* end, uint32_t* value) {
+    if(end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) p += 2;
+    if(p == end || end - p > 8) return false;
+
+    uint32_t result = 0;
+    for(; p < end; p++) {
+        uint8_t nibble;
+        if(*p >= '0' && *p <= '9') {
+            nibble = *p - '0';
+        } else if(*p >= 'a' && *p <= 'f') {
+            nibble = *p - 'a' + 10;
+        } else if(*p >= 'A' && *p <= 'F') {
+            nibble = *p - 'A' + 10;
+        } else {
+            return false;
+        }
+        result = result << 4 | nibble;
+    }
+    *value = result;
+    return true;
+}
+
+static int tpms_log_protocol_index(
+    char (*protocols)[TPMS_LOG_PROTOCOL_LEN],
+    uint8_t* count,
+    const char* name,
+    size_t len) {
+    if(len >= TPMS_LOG_PROTOCOL_LEN) len = TPMS_LOG_PROTOCOL_LEN - 1;
+    for(uint8_t i = 0; i < *count; i++) {
+        if(!strncmp(protocols[i], name, len) && protocols[i][len] == '\0') return i;
+    }
+    if(*count == TPMS_LOG_PROTOCOLS_MAX) return -1;
+    memcpy(protocols[*count], name, len);
+    protocols[*count][len] = '\0';
+    return (*count)++;
+}
+
+static bool tpms_log_parse_row(TPMSLogChunk* chunk, const char* line, const char* end) {
+    const char* field_begin[TPMS_LOG_FIELDS_MAX];
+    const char* field_end[TPMS_LOG_FIELDS_MAX];
+    size_t fields = 0;
+
+    if(end > line && end[-1] == '\r') end--;
+    const char* p = line;
+    while(fields < TPMS_LOG_FIELDS_MAX) {
+        const char* comma = memchr(p, ',', end - p);
+        field_begin[fields] = p;
+        field_end[fields] = comma ? comma : end;
+        fields++;
+        if(!comma) break;
+        p = comma + 1;
+    }
+
+    const int8_t* field = chunk->layout->field;
+#define FIELD_OK(column) (field[column] >= 0 && (size_t)field[column] < fields)
+#define FIELD(column) field_begin[field[column]], field_end[field[column]]
+
+    if(!FIELD_OK(TPMSLogColumnTime) || !FIELD_OK(TPMSLogColumnProtocol) ||
+       !FIELD_OK(TPMSLogColumnId)) {
+        return false;
+    }
+
+    TPMSLogRow row = {
+        .pressure_cbar = TPMS_LOG_NO_VALUE,
+        .temperature_dc = TPMS_LOG_NO_VALUE,
+    };
+    int64_t value;
+    if(!tpms_log_parse_fixed(FIELD(TPMSLogColumnTime), 3, &row.time_ms)) return false;
+    if(!tpms_log_parse_hex(FIELD(TPMSLogColumnId), &row.id)) return false;
+
+    // The app pads the protocol to a fixed width with spaces
+    const char* name = field_begin[field[TPMSLogColumnProtocol]];
+    const char* name_end = field_end[field[TPMSLogColumnProtocol]];
+    while(name_end > name && name_end[-1] == ' ') name_end--;
+    int protocol = tpms_log_protocol_index(
+        chunk->protocols, &chunk->protocol_count, name, name_end - name);
+    if(protocol < 0) return false;
+    row.protocol = protocol;
+
+    if(FIELD_OK(TPMSLogColumnPressure) &&
+       tpms_log_parse_fixed(FIELD(TPMSLogColumnPressure), 2, &value)) {
+        row.pressure_cbar = value;
+    }
+    if(FIELD_OK(TPMSLogColumnTemperature) &&
+       tpms_log_parse_fixed(FIELD(TPMSLogColumnTemperature), 1, &value)) {
+        row.temperature_dc = value;
+    }
+    if(FIELD_OK(TPMSLogColumnBattery) &&
+       tpms_log_parse_fixed(FIELD(TPMSLogColumnBattery), 0, &value)) {
+        row.battery_low = value;
+    }
+    if(FIELD_OK(TPMSLogColumnAlarm) &&
+       tpms_log_parse_fixed(FIELD(TPMSLogColumnAlarm), 0, &value) && value) {
+        row.flags |= TPMS_LOG_FLAG_ALARM;
+    }
+    if(FIELD_OK(TPMSLogColumnRssi) && tpms_log_parse_fixed(FIELD(TPMSLogColumnRssi), 0, &value)) {
+        row.rssi = value;
+    }
+    if(FIELD_OK(TPMSLogColumnFrequency) &&
+       tpms_log_parse_fixed(FIELD(TPMSLogColumnFrequency), 0, &value)) {
+        row.frequency = value;
+    }
+#undef FIELD
+#undef FIELD_OK
+
+    if(chunk->count == chunk->capacity) {
+        chunk->capacity = chunk->capacity ? chunk->capacity * 2 : 4096;
+        chunk->rows = realloc(chunk->rows, chunk->capacity * sizeof(TPMSLogRow));
+        if(!chunk->rows) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    chunk->rows[chunk->count++] = row;
+    return true;
+}
+
+static void* tpms_log_parse_chunk(void* context) {
+    TPMSLogChunk* chunk = context;
+    const char* p = chunk->begin;
+    while(p < chunk->end) {
+        const char* newline = memchr(p, '\n', chunk->end - p);
+        const char* line_end = newline ? newline : chunk->end;
+        if(line_end > p && !tpms_log_parse_row(chunk, p, line_end)) chunk->skipped++;
+        p = line_end + 1;
+    }
+    return NULL;
+}
+
+static bool tpms_log_parse_header(const char* p, const char* end, TPMSLogLayout* layout) {
+    memset(layout->field, -1, sizeof(layout->field));
+    if(end > p && end[-1] == '\r') end--;
+
+    for(int8_t index = 0; p <= end && index < TPMS_LOG_FIELDS_MAX; index++) {
+        const char* comma = memchr(p, ',', end - p);
+        const char* name_end = comma ? comma : end;
+        for(size_t column = 0; column < TPMSLogColumnCount; column++) {
+            size_t len = strlen(tpms_log_column_names[column]);
+            if((size_t)(name_end - p) == len && !memcmp(p, tpms_log_column_names[column], len)) {
+                layout->field[column] = index;
+            }
+        }
+        if(!comma) break;
+        p = comma + 1;
+    }
+    return layout->field[TPMSLogColumnTime] >= 0 && layout->field[TPMSLogColumnProtocol] >= 0 &&
+           layout->field[TPMSLogColumnId] >= 0;
+}
+
+static bool tpms_log_load_file(TPMSLog* log, const char* path, unsigned threads) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) < 0) {
+        perror(path);
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    if(size == 0) {
+        close(fd);
+        return true;
+    }
+
+    const char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    const char* end = data + size;
+    const char* header_end = memchr(data, '\n', size);
+    TPMSLogLayout layout;
+    if(!header_end || !tpms_log_parse_header(data, header_end, &layout)) {
+        fprintf(stderr, "%s: not a session log\n", path);
+        munmap((void*)data, size);
+        return false;
+    }
+
+    // Split the body at line boundaries, one chunk per thread
+    const char* body = header_end + 1;
+    size_t chunk_count = (end - body) / TPMS_LOG_CHUNK_MIN + 1;
+    if(chunk_count > threads) chunk_count = threads;
+    TPMSLogChunk* chunks = calloc(chunk_count, sizeof(TPMSLogChunk));
+    const char* p = body;
+    for(size_t i = 0; i < chunk_count; i++) {
+        const char* split = body + (end - body) * (i + 1) / chunk_count;
+        if(i + 1 < chunk_count) {
+            const char* newline = memchr(split, '\n', end - split);
+            split = newline ? newline + 1 : end;
+        }
+        if(split < p) split = p;
+        chunks[i].begin = p;
+        chunks[i].end = split;
+        chunks[i].layout = &layout;
+        p = split;
+    }
+
+    pthread_t thread_ids[TPMS_LOG_THREADS_MAX];
+    for(size_t i = 1; i < chunk_count; i++) {
+        pthread_create(&thread_ids[i], NULL, tpms_log_parse_chunk, &chunks[i]);
+    }
+    tpms_log_parse_chunk(&chunks[0]);
+    for(size_t i = 1; i < chunk_count; i++) {
+        pthread_join(thread_ids[i], NULL);
+    }
+
+    // Concatenate in file order, mapping chunk protocol indexes to the log dictionary
+    size_t total = log->count;
+    for(size_t i = 0; i < chunk_count; i++) total += chunks[i].count;
+    log->rows = realloc(log->rows, (total ? total : 1) * sizeof(TPMSLogRow));
+    if(!log->rows) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    bool res = true;
+    for(size_t i = 0; i < chunk_count; i++) {
+        TPMSLogChunk* chunk = &chunks[i];
+        uint8_t map[TPMS_LOG_PROTOCOLS_MAX];
+        for(uint8_t j = 0; j < chunk->protocol_count; j++) {
+            int index = tpms_log_protocol_index(
+                log->protocols,
+                &log->protocol_count,
+                chunk->protocols[j],
+                strlen(chunk->protocols[j]));
+            if(index < 0) {
+                fprintf(stderr, "%s: more than %d protocols\n", path, TPMS_LOG_PROTOCOLS_MAX);
+                res = false;
+                index = 0;
+            }
+            map[j] = index;
+        }
+        for(size_t j = 0; j < chunk->count; j++) {
+            TPMSLogRow* row = &log->rows[log->count++];
+            *row = chunk->rows[j];
+            row->protocol = map[row->protocol];
+        }
+        log->skipped += chunk->skipped;
+        free(chunk->rows);
+    }
+
+    free(chunks);
+    munmap((void*)data, size);
+    return res;
+}
+
+bool tpms_log_load(TPMSLog* log, const char* const* paths, size_t count, unsigned threads) {
+    memset(log, 0, sizeof(TPMSLog));
+    if(threads == 0) threads = tpms_log_cpu_count();
+    if(threads > TPMS_LOG_THREADS_MAX) threads = TPMS_LOG_THREADS_MAX;
+
+    bool res = true;
+    for(size_t i = 0; i < count; i++) {
+        if(!tpms_log_load_file(log, paths[i], threads)) res = false;
+    }
+    return res;
+}
+
+void tpms_log_free(TPMSLog* log) {
+    free(log->rows);
+    log->rows = NULL;
+    log->count = 0;
+}
+
+uint64_t tpms_log_sensor_key(const TPMSLog* log, const TPMSLogRow* row) {
+    // FNV-1a of the protocol name, so keys match between logs with different dictionaries
+    uint32_t hash = 2166136261UL;
+    for(const char* p = log->protocols[row->protocol]; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619UL;
+    }
+    return (uint64_t)hash << 32 | row->id;
+}
+
+unsigned tpms_log_cpu_count(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (unsigned)cpus : 1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/* Host side reader of session logs the app writes to apps_data/tpms/log.
+ * Files are memory mapped and parsed by several threads at once. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TPMS_LOG_PROTOCOLS_MAX 64
+#define TPMS_LOG_PROTOCOL_LEN 16
+#define TPMS_LOG_NO_VALUE INT16_MIN
+
+/** One log row. Pressure, temperature and RSSI are fixed point to keep rows small */
+typedef struct {
+    int64_t time_ms; // unix time, ms
+    uint32_t id;
+    uint32_t frequency; // Hz
+    int16_t pressure_cbar; // centibar, TPMS_LOG_NO_VALUE when missing
+    int16_t temperature_dc; // tenths of celsius, TPMS_LOG_NO_VALUE when missing
+    int8_t rssi; // dBm
+    uint8_t protocol; // index into TPMSLog.protocols
+    uint8_t battery_low;
+    uint8_t flags; // TPMS_LOG_FLAG_*
+} TPMSLogRow;
+
+#define TPMS_LOG_FLAG_ALARM 0x01
+
+typedef struct {
+    TPMSLogRow* rows;
+    size_t count;
+    size_t skipped; // lines that did not parse
+    uint8_t protocol_count;
+    char protocols[TPMS_LOG_PROTOCOLS_MAX][TPMS_LOG_PROTOCOL_LEN];
+} TPMSLog;
+
+/** Parse session logs into one table, rows in file order
+ *
+ * @param log       - TPMSLog to fill, freed with tpms_log_free
+ * @param paths     - log files
+ * @param count     - number of files
+ * @param threads   - parser threads, 0 picks the number of CPUs
+ * @return bool     - all files were read
+ */
+bool tpms_log_load(TPMSLog* log, const char* const* paths, size_t count, unsigned threads);
+
+/** Free rows of a TPMSLog
+ *
+ * @param log - TPMSLog instance
+ */
+void tpms_log_free(TPMSLog* log);
+
+/** Key joining rows of the same sensor across logs: protocol and id
+ *
+ * @param log       - TPMSLog the row belongs to
+ * @param row       - row
+ * @return uint64_t - key, equal for the same sensor whatever log it comes from
+ */
+uint64_t tpms_log_sensor_key(const TPMSLog* log, const TPMSLogRow* row);
+
+/** Number of CPUs, for the default thread count
+ *
+ * @return unsigned - CPUs online
+ */
+unsigned tpms_log_cpu_count(void);
@@ -0,0 +1,629 @@
+/* Vehicle re-identification and travel time between two capture sites.
+ *
+ * Sightings of site A and site B are hash-joined on (protocol, id). Every sensor seen at both
+ * sites gives passages matched in time order, and sensors whose passages line up at both
+ * sites within a short window are taken as the wheels of one vehicle.
+ *
+ * Build: cc -O2 -pthread -o tpms_reid tpms_reid.c tpms_log.c
+ */
+
+#include "tpms_log.h"
+
+#include <getopt.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TPMS_REID_FILES_MAX 256
+#define TPMS_REID_PARTITION_BITS 8
+#define TPMS_REID_PARTITIONS (1 << TPMS_REID_PARTITION_BITS)
+#define TPMS_REID_WHEELS_MAX 8
+
+typedef struct {
+    uint64_t key;
+    int64_t time_ms;
+} Sighting;
+
+typedef struct {
+    uint64_t key;
+    int64_t a_ms;
+    int64_t b_ms;
+} Match;
+
+typedef struct {
+    Match* items;
+    size_t count;
+    size_t capacity;
+} MatchArray;
+
+typedef struct {
+    int64_t max_travel_ms;
+    int64_t passage_gap_ms;
+    int64_t vehicle_window_ms;
+    unsigned min_wheels;
+    unsigned threads;
+    int64_t bin_ms;
+    bool verbose;
+} Options;
+
+/** Site sightings, partitioned by key hash so partitions join independently */
+typedef struct {
+    Sighting* items;
+    size_t offset[TPMS_REID_PARTITIONS + 1];
+} Site;
+
+typedef struct {
+    const Options* options;
+    const Site* a;
+    const Site* b;
+    atomic_uint* next_partition;
+    MatchArray matches;
+    size_t sensors_a;
+    size_t sensors_joined;
+} JoinWorker;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static uint64_t mix64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+static void* xmalloc(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if(!p) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void match_push(MatchArray* array, Match match) {
+    if(array->count == array->capacity) {
+        array->capacity = array->capacity ? array->capacity * 2 : 1024;
+        array->items = realloc(array->items, array->capacity * sizeof(Match));
+        if(!array->items) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    array->items[array->count++] = match;
+}
+
+/* Partitioning --------------------------------------------------------------------------- */
+
+typedef struct {
+    const TPMSLog* log;
+    Sighting* out;
+    size_t begin;
+    size_t end;
+    size_t histogram[TPMS_REID_PARTITIONS];
+    size_t cursor[TPMS_REID_PARTITIONS];
+} PartitionWorker;
+
+static unsigned partition_of(uint64_t key) {
+    return mix64(key) >> (64 - TPMS_REID_PARTITION_BITS);
+}
+
+static void* partition_count(void* context) {
+    PartitionWorker* worker = context;
+    for(size_t i = worker->begin; i < worker->end; i++) {
+        uint64_t key = tpms_log_sensor_key(worker->log, &worker->log->rows[i]);
+        worker->histogram[partition_of(key)]++;
+    }
+    return NULL;
+}
+
+static void* partition_scatter(void* context) {
+    PartitionWorker* worker = context;
+    for(size_t i = worker->begin; i < worker->end; i++) {
+        const TPMSLogRow* row = &worker->log->rows[i];
+        uint64_t key = tpms_log_sensor_key(worker->log, row);
+        worker->out[worker->cursor[partition_of(key)]++] = (Sighting){key, row->time_ms};
+    }
+    return NULL;
+}
+
+static void run_threads(unsigned threads, void* (*fn)(void*), void* workers, size_t stride) {
+    pthread_t* ids = xmalloc(threads * sizeof(pthread_t));
+    for(unsigned t = 1; t < threads; t++) {
+        pthread_create(&ids[t], NULL, fn, (char*)workers + t * stride);
+    }
+    fn(workers);
+    for(unsigned t = 1; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    free(ids);
+}
+
+/** Two pass radix partition: per thread histograms, then a stable scatter */
+static void site_partition(Site* site, const TPMSLog* log, unsigned threads) {
+    PartitionWorker* workers = calloc(threads, sizeof(PartitionWorker));
+    for(unsigned t = 0; t < threads; t++) {
+        workers[t].log = log;
+        workers[t].begin = log->count * t / threads;
+        workers[t].end = log->count * (t + 1) / threads;
+    }
+    run_threads(threads, partition_count, workers, sizeof(PartitionWorker));
+
+    size_t offset = 0;
+    for(unsigned p = 0; p < TPMS_REID_PARTITIONS; p++) {
+        site->offset[p] = offset;
+        for(unsigned t = 0; t < threads; t++) {
+            workers[t].cursor[p] = offset;
+            offset += workers[t].histogram[p];
+        }
+    }
+    site->offset[TPMS_REID_PARTITIONS] = offset;
+
+    site->items = xmalloc(log->count * sizeof(Sighting));
+    for(unsigned t = 0; t < threads; t++) workers[t].out = site->items;
+    run_threads(threads, partition_scatter, workers, sizeof(PartitionWorker));
+    free(workers);
+}
+
+/* Join ----------------------------------------------------------------------------------- */
+
+typedef struct {
+    uint64_t key;
+    uint32_t a_head; // chains through next_a, UINT32_MAX ends
+    uint32_t b_head;
+    uint32_t a_count;
+    uint32_t b_count;
+    bool used;
+} Bucket;
+
+static int compare_time(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void join_sensor(
+    JoinWorker* worker,
+    uint64_t key,
+    int64_t* a,
+    size_t a_count,
+    int64_t* b,
+    size_t b_count) {
+    const Options* options = worker->options;
+    qsort(a, a_count, sizeof(int64_t), compare_time);
+    qsort(b, b_count, sizeof(int64_t), compare_time);
+
+    // Collapse sightings closer than the gap into passages, in place. A keeps the last
+    // sighting of each, B the first, so a car parked near a site does not stretch travel time
+    size_t a_passages = 0;
+    for(size_t i = 0; i < a_count; i++) {
+        if(i + 1 < a_count && a[i + 1] - a[i] <= options->passage_gap_ms) continue;
+        a[a_passages++] = a[i];
+    }
+    size_t b_passages = 0;
+    for(size_t i = 0; i < b_count; i++) {
+        if(i && b[i] - b[i - 1] <= options->passage_gap_ms) continue;
+        b[b_passages++] = b[i];
+    }
+
+    // Each B passage takes the latest unused A passage before it, both in time order
+    size_t ia = 0;
+    bool have_last = false;
+    size_t last_a = 0;
+    for(size_t ib = 0; ib < b_passages; ib++) {
+        while(ia + 1 < a_passages && a[ia + 1] <= b[ib]) ia++;
+        if(ia >= a_passages || a[ia] > b[ib]) continue;
+        if(have_last && ia <= last_a) continue;
+        if(b[ib] - a[ia] > options->max_travel_ms) continue;
+        match_push(&worker->matches, (Match){key, a[ia], b[ib]});
+        have_last = true;
+        last_a = ia;
+    }
+}
+
+static void join_partition(JoinWorker* worker, unsigned partition) {
+    const Sighting* a = worker->a->items + worker->a->offset[partition];
+    size_t a_count = worker->a->offset[partition + 1] - worker->a->offset[partition];
+    const Sighting* b = worker->b->items + worker->b->offset[partition];
+    size_t b_count = worker->b->offset[partition + 1] - worker->b->offset[partition];
+    if(!a_count || !b_count) return;
+
+    size_t capacity = 16;
+    while(capacity < a_count * 2) capacity <<= 1;
+    Bucket* table = xmalloc(capacity * sizeof(Bucket));
+    for(size_t i = 0; i < capacity; i++) table[i].used = false;
+    uint32_t* next_a = xmalloc(a_count * sizeof(uint32_t));
+    uint32_t* next_b = xmalloc(b_count * sizeof(uint32_t));
+
+    // Build on A
+    for(size_t i = 0; i < a_count; i++) {
+        size_t slot = mix64(a[i].key) & (capacity - 1);
+        while(table[slot].used && table[slot].key != a[i].key) slot = (slot + 1) & (capacity - 1);
+        Bucket* bucket = &table[slot];
+        if(!bucket->used) {
+            *bucket = (Bucket){a[i].key, UINT32_MAX, UINT32_MAX, 0, 0, true};
+            worker->sensors_a++;
+        }
+        next_a[i] = bucket->a_head;
+        bucket->a_head = i;
+        bucket->a_count++;
+    }
+
+    // Probe with B
+    for(size_t i = 0; i < b_count; i++) {
+        size_t slot = mix64(b[i].key) & (capacity - 1);
+        while(table[slot].used && table[slot].key != b[i].key) slot = (slot + 1) & (capacity - 1);
+        if(!table[slot].used) continue;
+        next_b[i] = table[slot].b_head;
+        table[slot].b_head = i;
+        table[slot].b_count++;
+    }
+
+    int64_t* times = NULL;
+    size_t times_capacity = 0;
+    for(size_t slot = 0; slot < capacity; slot++) {
+        Bucket* bucket = &table[slot];
+        if(!bucket->used || !bucket->b_count) continue;
+        worker->sensors_joined++;
+
+        size_t need = bucket->a_count + bucket->b_count;
+        if(need > times_capacity) {
+            times_capacity = need * 2;
+            free(times);
+            times = xmalloc(times_capacity * sizeof(int64_t));
+        }
+        size_t n = 0;
+        for(uint32_t i = bucket->a_head; i != UINT32_MAX; i = next_a[i]) times[n++] = a[i].time_ms;
+        for(uint32_t i = bucket->b_head; i != UINT32_MAX; i = next_b[i]) times[n++] = b[i].time_ms;
+        join_sensor(
+            worker,
+            bucket->key,
+            times,
+            bucket->a_count,
+            times + bucket->a_count,
+            bucket->b_count);
+    }
+
+    free(times);
+    free(next_b);
+    free(next_a);
+    free(table);
+}
+
+static void* join_worker(void* context) {
+    JoinWorker* worker = context;
+    unsigned partition;
+    while((partition = atomic_fetch_add(worker->next_partition, 1)) < TPMS_REID_PARTITIONS) {
+        join_partition(worker, partition);
+    }
+    return NULL;
+}
+
+/* Vehicles ------------------------------------------------------------------------------- */
+
+typedef struct {
+    int64_t a_first_ms;
+    int64_t b_first_ms;
+    uint64_t keys[TPMS_REID_WHEELS_MAX];
+    int64_t travel_ms[TPMS_REID_WHEELS_MAX];
+    unsigned wheels;
+} Vehicle;
+
+typedef struct {
+    Vehicle* items;
+    size_t count;
+    size_t capacity;
+} VehicleArray;
+
+static int compare_match(const void* a, const void* b) {
+    const Match* x = a;
+    const Match* y = b;
+    // Total order, so the result does not depend on which thread found a match
+    if(x->a_ms != y->a_ms) return (x->a_ms > y->a_ms) - (x->a_ms < y->a_ms);
+    if(x->b_ms != y->b_ms) return (x->b_ms > y->b_ms) - (x->b_ms < y->b_ms);
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+static int64_t vehicle_travel_ms(Vehicle* vehicle) {
+    qsort(vehicle->travel_ms, vehicle->wheels, sizeof(int64_t), compare_time);
+    return vehicle->travel_ms[vehicle->wheels / 2];
+}
+
+static void vehicle_close(VehicleArray* vehicles, const Vehicle* vehicle, unsigned min_wheels) {
+    if(vehicle->wheels < min_wheels) return;
+    if(vehicles->count == vehicles->capacity) {
+        vehicles->capacity = vehicles->capacity ? vehicles->capacity * 2 : 256;
+        vehicles->items = realloc(vehicles->items, vehicles->capacity * sizeof(Vehicle));
+        if(!vehicles->items) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    vehicles->items[vehicles->count++] = *vehicle;
+}
+
+/** Sensors passing both sites within the window of each other ride on the same vehicle */
+static void group_vehicles(MatchArray* matches, const Options* options, VehicleArray* vehicles) {
+    qsort(matches->items, matches->count, sizeof(Match), compare_match);
+
+    Vehicle* open = NULL;
+    size_t open_count = 0;
+    size_t open_capacity = 0;
+
+    for(size_t m = 0; m < matches->count; m++) {
+        const Match* match = &matches->items[m];
+
+        size_t kept = 0;
+        for(size_t i = 0; i < open_count; i++) {
+            if(match->a_ms - open[i].a_first_ms > options->vehicle_window_ms) {
+                vehicle_close(vehicles, &open[i], options->min_wheels);
+            } else {
+                open[kept++] = open[i];
+            }
+        }
+        open_count = kept;
+
+        // Closest open vehicle at both sites, so neighbours in dense traffic stay apart
+        Vehicle* target = NULL;
+        int64_t target_distance = INT64_MAX;
+        for(size_t i = 0; i < open_count; i++) {
+            int64_t a_diff = match->a_ms - open[i].a_first_ms;
+            int64_t b_diff = match->b_ms - open[i].b_first_ms;
+            if(b_diff < 0) b_diff = -b_diff;
+            if(b_diff > options->vehicle_window_ms) continue;
+            if(open[i].wheels == TPMS_REID_WHEELS_MAX) continue;
+            bool duplicate = false;
+            for(unsigned w = 0; w < open[i].wheels; w++) {
+                if(open[i].keys[w] == match->key) duplicate = true;
+            }
+            if(!duplicate && a_diff + b_diff < target_distance) {
+                target = &open[i];
+                target_distance = a_diff + b_diff;
+            }
+        }
+        if(!target) {
+            if(open_count == open_capacity) {
+                open_capacity = open_capacity ? open_capacity * 2 : 64;
+                open = realloc(open, open_capacity * sizeof(Vehicle));
+                if(!open) {
+                    fprintf(stderr, "Out of memory\n");
+                    exit(1);
+                }
+            }
+            target = &open[open_count++];
+            target->a_first_ms = match->a_ms;
+            target->b_first_ms = match->b_ms;
+            target->wheels = 0;
+        }
+        target->keys[target->wheels] = match->key;
+        target->travel_ms[target->wheels] = match->b_ms - match->a_ms;
+        target->wheels++;
+    }
+    for(size_t i = 0; i < open_count; i++) {
+        vehicle_close(vehicles, &open[i], options->min_wheels);
+    }
+    free(open);
+}
+
+/* Report --------------------------------------------------------------------------------- */
+
+static const char* protocol_of(const TPMSLog* log, uint64_t key) {
+    uint32_t hash = key >> 32;
+    for(uint8_t i = 0; i < log->protocol_count; i++) {
+        TPMSLogRow row = {.protocol = i};
+        if(tpms_log_sensor_key(log, &row) >> 32 == hash) return log->protocols[i];
+    }
+    return "?";
+}
+
+static void report(const TPMSLog* log_a, VehicleArray* vehicles, const Options* options) {
+    if(options->verbose) {
+        printf("a_time,b_time,travel_s,wheels,sensors\n");
+        for(size_t i = 0; i < vehicles->count; i++) {
+            Vehicle* vehicle = &vehicles->items[i];
+            int64_t travel_ms = vehicle_travel_ms(vehicle);
+            printf(
+                "%.3f,%.3f,%.1f,%u,",
+                vehicle->a_first_ms / 1e3,
+                vehicle->b_first_ms / 1e3,
+                travel_ms / 1e3,
+                vehicle->wheels);
+            for(unsigned w = 0; w < vehicle->wheels; w++) {
+                printf(
+                    "%s%s:%08X",
+                    w ? " " : "",
+                    protocol_of(log_a, vehicle->keys[w]),
+                    (uint32_t)vehicle->keys[w]);
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+
+    printf("vehicles: %zu (at least %u matched wheels)\n", vehicles->count, options->min_wheels);
+    if(!vehicles->count) return;
+
+    int64_t* travel = xmalloc(vehicles->count * sizeof(int64_t));
+    double sum = 0;
+    for(size_t i = 0; i < vehicles->count; i++) {
+        travel[i] = vehicle_travel_ms(&vehicles->items[i]);
+        sum += travel[i];
+    }
+    qsort(travel, vehicles->count, sizeof(int64_t), compare_time);
+
+    const double quantiles[] = {0.0, 0.10, 0.25, 0.50, 0.75, 0.90, 1.0};
+    const char* const names[] = {"min", "p10", "p25", "median", "p75", "p90", "max"};
+    printf("travel time, s:");
+    for(size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+        size_t index = (size_t)(quantiles[q] * (vehicles->count - 1) + 0.5);
+        printf(" %s %.1f", names[q], travel[index] / 1e3);
+    }
+    printf(" mean %.1f\n", sum / vehicles->count / 1e3);
+
+    printf("\ntravel_s,vehicles\n");
+    int64_t bin = travel[0] / options->bin_ms;
+    size_t count = 0;
+    for(size_t i = 0; i <= vehicles->count; i++) {
+        if(i == vehicles->count || travel[i] / options->bin_ms != bin) {
+            printf("%.0f,%zu\n", bin * options->bin_ms / 1e3, count);
+            if(i == vehicles->count) break;
+            // Empty bins are listed too, so the column plots as is
+            for(bin++; bin < travel[i] / options->bin_ms; bin++) {
+                printf("%.0f,0\n", bin * options->bin_ms / 1e3);
+            }
+            count = 0;
+        }
+        count++;
+    }
+    free(travel);
+}
+
+static void usage(const char* name) {
+    fprintf(
+        stderr,
+        "Usage: %s [options] -a SITE_A_LOG [-a ...] -b SITE_B_LOG [-b ...]\n"
+        "  Site A is upstream, vehicles travel from A to B\n"
+        "  -t SECONDS  longest travel time accepted (3600)\n"
+        "  -g SECONDS  sightings of a sensor closer than this are one passage (60)\n"
+        "  -w SECONDS  wheels of one vehicle pass a site within this window (10)\n"
+        "  -m WHEELS   matched wheels needed to count a vehicle (2)\n"
+        "  -H SECONDS  histogram bin width (60)\n"
+        "  -j THREADS  worker threads (CPUs online)\n"
+        "  -v          list matched vehicles\n",
+        name);
+}
+
+int main(int argc, char** argv) {
+    Options options = {
+        .max_travel_ms = 3600 * 1000,
+        .passage_gap_ms = 60 * 1000,
+        .vehicle_window_ms = 10 * 1000,
+        .min_wheels = 2,
+        .bin_ms = 60 * 1000,
+    };
+    const char* paths_a[TPMS_REID_FILES_MAX];
+    const char* paths_b[TPMS_REID_FILES_MAX];
+    size_t count_a = 0;
+    size_t count_b = 0;
+
+    int opt;
+    while((opt = getopt(argc, argv, "a:b:t:g:w:m:H:j:vh")) != -1) {
+        switch(opt) {
+        case 'a':
+            if(count_a < TPMS_REID_FILES_MAX) paths_a[count_a++] = optarg;
+            break;
+        case 'b':
+            if(count_b < TPMS_REID_FILES_MAX) paths_b[count_b++] = optarg;
+            break;
+        case 't':
+            options.max_travel_ms = atof(optarg) * 1000;
+            break;
+        case 'g':
+            options.passage_gap_ms = atof(optarg) * 1000;
+            break;
+        case 'w':
+            options.vehicle_window_ms = atof(optarg) * 1000;
+            break;
+        case 'm':
+            options.min_wheels = atoi(optarg);
+            break;
+        case 'H':
+            options.bin_ms = atof(optarg) * 1000;
+            break;
+        case 'j':
+            options.threads = atoi(optarg);
+            break;
+        case 'v':
+            options.verbose = true;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if(!count_a || !count_b || options.bin_ms <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if(options.threads == 0) options.threads = tpms_log_cpu_count();
+    if(options.min_wheels < 1) options.min_wheels = 1;
+    if(options.min_wheels > TPMS_REID_WHEELS_MAX) options.min_wheels = TPMS_REID_WHEELS_MAX;
+
+    double start = now_ms();
+    TPMSLog log_a;
+    TPMSLog log_b;
+    if(!tpms_log_load(&log_a, paths_a, count_a, options.threads) ||
+       !tpms_log_load(&log_b, paths_b, count_b, options.threads)) {
+        return 1;
+    }
+    double loaded = now_ms();
+
+    Site site_a;
+    Site site_b;
+    site_partition(&site_a, &log_a, options.threads);
+    site_partition(&site_b, &log_b, options.threads);
+
+    atomic_uint next_partition = 0;
+    JoinWorker* workers = calloc(options.threads, sizeof(JoinWorker));
+    for(unsigned t = 0; t < options.threads; t++) {
+        workers[t].options = &options;
+        workers[t].a = &site_a;
+        workers[t].b = &site_b;
+        workers[t].next_partition = &next_partition;
+    }
+    run_threads(options.threads, join_worker, workers, sizeof(JoinWorker));
+
+    MatchArray matches = {0};
+    size_t sensors_a = 0;
+    size_t sensors_joined = 0;
+    for(unsigned t = 0; t < options.threads; t++) {
+        for(size_t i = 0; i < workers[t].matches.count; i++) {
+            match_push(&matches, workers[t].matches.items[i]);
+        }
+        sensors_a += workers[t].sensors_a;
+        sensors_joined += workers[t].sensors_joined;
+        free(workers[t].matches.items);
+    }
+    free(workers);
+    double joined = now_ms();
+
+    VehicleArray vehicles = {0};
+    group_vehicles(&matches, &options, &vehicles);
+    double grouped = now_ms();
+
+    printf(
+        "site A: %zu rows, %zu sensors%s\n",
+        log_a.count,
+        sensors_a,
+        log_a.skipped ? " (some lines skipped)" : "");
+    printf("site B: %zu rows%s\n", log_b.count, log_b.skipped ? " (some lines skipped)" : "");
+    printf(
+        "sensors seen at both sites: %zu, passages matched: %zu\n",
+        sensors_joined,
+        matches.count);
+    report(&log_a, &vehicles, &options);
+
+    fprintf(
+        stderr,
+        "load %.0f ms, join %.0f ms, group %.0f ms, %u threads\n",
+        loaded - start,
+        joined - loaded,
+        grouped - joined,
+        options.threads);
+
+    free(vehicles.items);
+    free(matches.items);
+    free(site_a.items);
+    free(site_b.items);
+    tpms_log_free(&log_a);
+    tpms_log_free(&log_b);
+    return 0;
+}
@@ -0,0 +1,244 @@
+/* Headless render benchmark of the receiver list (views/tpms_receiver.c) and the reading view
+ * (views/tpms_receiver_info.c). The views draw on the host canvas in sdk/gui.c, a 1 bit
+ * framebuffer, and every frame is timed with its heap allocations counted.
+ *
+ * Build: cc -O2 -pthread -I sdk -I .. -o tpms_render tpms_render.c sdk/sdk.c sdk/gui.c \
+ *            ../views/tpms_receiver.c ../views/tpms_receiver_info.c ../helpers/tpms_snapshot.c \
+ *            ../helpers/tpms_clock.c
+ */
+
+#include <views/tpms_receiver.h>
+#include <views/tpms_receiver_info.h>
+#include <helpers/tpms_alert.h>
+#include <helpers/tpms_clock.h>
+#include <protocols/tpms_generic.h>
+#include <tpms_history.h>
+#include <tpms_icons.h>
+#include <gui/canvas_i.h>
+#include <gui/view_i.h>
+
+#include <time.h>
+
+#define FRAMES 2000
+#define RUNS 5
+
+// Sizes of the images/ files the firmware build turns into icons
+const Icon I_Fishing_123x52 = {123, 52};
+const Icon I_Lock_7x8 = {7, 8};
+const Icon I_Pin_back_arrow_10x8 = {10, 8};
+const Icon I_Press_7x16 = {7, 16};
+const Icon I_Quest_7x8 = {7, 8};
+const Icon I_Scanning_123x52 = {123, 52};
+const Icon I_Therm_7x16 = {7, 16};
+const Icon I_Timer_11x11 = {11, 11};
+const Icon I_Unlock_7x8 = {7, 8};
+const Icon I_WarningDolphin_45x42 = {45, 42};
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+// Heap calls made while counting is on, the tool is single threaded
+static bool counting;
+static uint64_t allocations;
+
+void* malloc(size_t size) {
+    if(counting) allocations++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if(counting) allocations++;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if(counting) allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+/* The reading view takes its reading from a FlipperFormat the history filled. The tool hands
+ * it this one instead of a file */
+static TPMSBlockGeneric fixture = {
+    .id = 0x00A1B2C3,
+    .data_count_bit = 64,
+    .battery_low = 0,
+    .pressure = 2.35f,
+    .temperature = 21.0f,
+    .rssi = -62.0f,
+    .repeat_count = 8,
+    .crc_ok_mask = 0x7F,
+};
+
+// Never dereferenced, the calls on it are defined below
+static FlipperFormat* fff = (FlipperFormat*)&fixture;
+
+bool flipper_format_rewind(FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+    return true;
+}
+
+bool flipper_format_read_string(FlipperFormat* flipper_format, const char* key, FuriString* data) {
+    UNUSED(flipper_format);
+    UNUSED(key);
+    furi_string_set_str(data, "Schrader GG4");
+    return true;
+}
+
+SubGhzProtocolStatus
+    tpms_block_generic_deserialize(TPMSBlockGeneric* instance, FlipperFormat* flipper_format) {
+    UNUSED(flipper_format);
+    *instance = fixture;
+    return SubGhzProtocolStatusOk;
+}
+
+const char* tpms_alert_get_name(TPMSAlertType type) {
+    UNUSED(type);
+    return "LOW";
+}
+
+typedef struct {
+    TPMSReceiver* receiver;
+    TPMSReceiverInfo* info;
+    View* view;
+    Canvas* canvas;
+    uint16_t items;
+    uint32_t frame;
+} Bench;
+
+typedef void (*BenchFrame)(Bench* bench);
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void receiver_callback(TPMSCustomEvent event, void* context) {
+    UNUSED(event);
+    UNUSED(context);
+}
+
+static void set_item(Bench* bench, uint16_t idx, float pressure) {
+    char name[32];
+    snprintf(name, sizeof(name), "Schrader GG4 %08X", 0x00A10000 + idx * 0x1F3);
+    uint32_t now = furi_get_tick() / furi_kernel_get_tick_frequency();
+    tpms_view_receiver_set_item(
+        bench->receiver, idx, name, 0, pressure, 20.0f + idx % 10, now - idx * 7);
+}
+
+// The list of a session with items sensors, a few of them stale or gone
+static void receiver_fill(Bench* bench, uint16_t items) {
+    bench->items = items;
+    tpms_view_receiver_reset(bench->receiver);
+    tpms_view_receiver_add_data_statusbar(bench->receiver, "433.92", "AM650", "12/50", false);
+    for(uint16_t i = 0; i < items; i++) {
+        set_item(bench, i, 2.2f + (i % 5) * 0.05f);
+        if(i % 7 == 3) {
+            tpms_view_receiver_set_item_state(bench->receiver, i, TPMSSensorStateStale);
+        } else if(i % 11 == 5) {
+            tpms_view_receiver_set_item_state(bench->receiver, i, TPMSSensorStateGone);
+        }
+    }
+    tpms_view_receiver_set_idx_menu(bench->receiver, 0);
+}
+
+static void frame_draw(Bench* bench) {
+    view_draw(bench->view, bench->canvas);
+}
+
+// Down to the end of the list, then up again, a row per frame
+static void frame_scroll(Bench* bench) {
+    uint32_t rows = bench->items > 1 ? bench->items - 1 : 1;
+    InputEvent event = {
+        .key = (bench->frame / rows) % 2 ? InputKeyUp : InputKeyDown,
+        .type = InputTypeShort,
+    };
+    view_input(bench->view, &event);
+    view_draw(bench->view, bench->canvas);
+}
+
+// A new reading of the selected sensor, the row on screen changes
+static void frame_update(Bench* bench) {
+    if(bench->items) {
+        set_item(
+            bench,
+            tpms_view_receiver_get_idx_menu(bench->receiver),
+            2.0f + (bench->frame % 50) * 0.01f);
+    }
+    view_draw(bench->view, bench->canvas);
+}
+
+// A new frame of the sensor shown, as the scene hands it over
+static void frame_info_update(Bench* bench) {
+    fixture.pressure = 2.0f + (bench->frame % 50) * 0.01f;
+    tpms_view_receiver_info_update(bench->info, fff);
+    view_draw(bench->view, bench->canvas);
+}
+
+static void frame_info_sightings(Bench* bench) {
+    tpms_view_receiver_info_set_sightings(bench->info, bench->frame);
+    view_draw(bench->view, bench->canvas);
+}
+
+// Best run, so noise from the rest of the system does not count
+static void bench_run(Bench* bench, const char* name, BenchFrame frame) {
+    double best_ns = 0;
+    double allocs = 0;
+    for(size_t run = 0; run < RUNS; run++) {
+        allocations = 0;
+        counting = true;
+        uint64_t start = now_ns();
+        for(bench->frame = 0; bench->frame < FRAMES; bench->frame++) {
+            frame(bench);
+        }
+        uint64_t elapsed = now_ns() - start;
+        counting = false;
+        double ns = (double)elapsed / FRAMES;
+        if(!run || ns < best_ns) best_ns = ns;
+        allocs = (double)allocations / FRAMES;
+    }
+    printf("%-10s %5u %10.0f %10.2f\n", name, bench->items, best_ns, allocs);
+}
+
+static void bench_receiver(Bench* bench) {
+    static const uint16_t sizes[] = {0, 1, 4, 16, 32, TPMS_HISTORY_MAX};
+    bench->receiver = tpms_view_receiver_alloc();
+    tpms_view_receiver_set_callback(bench->receiver, receiver_callback, NULL);
+    bench->view = tpms_view_receiver_get_view(bench->receiver);
+    for(size_t i = 0; i < COUNT_OF(sizes); i++) {
+        receiver_fill(bench, sizes[i]);
+        bench_run(bench, "draw", frame_draw);
+        bench_run(bench, "scroll", frame_scroll);
+        bench_run(bench, "update", frame_update);
+    }
+    tpms_view_receiver_free(bench->receiver);
+}
+
+static void bench_info(Bench* bench) {
+    bench->info = tpms_view_receiver_info_alloc();
+    bench->view = tpms_view_receiver_info_get_view(bench->info);
+    bench->items = 1;
+    fixture.timestamp = tpms_clock_get_timestamp(NULL) - 90;
+    tpms_view_receiver_info_update(bench->info, fff);
+    tpms_view_receiver_info_set_leak(bench->info, 0.05f, true);
+    bench_run(bench, "info", frame_draw);
+    bench_run(bench, "info_upd", frame_info_update);
+    bench_run(bench, "info_seen", frame_info_sightings);
+    tpms_view_receiver_info_free(bench->info);
+}
+
+int main(void) {
+    tpms_clock_anchor();
+    Bench bench = {.canvas = canvas_init()};
+    printf("%-10s %5s %10s %10s\n", "frame", "items", "ns/frame", "allocs");
+    bench_receiver(&bench);
+    bench_info(&bench);
+    canvas_free(bench.canvas);
+    return 0;
+}
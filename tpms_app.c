@@ -7,6 +7,19 @@
 static bool tpms_app_custom_event_callback(void* context, uint32_t event) {
     furi_assert(context);
     TPMSApp* app = context;
+    if(event == TPMSCustomEventBurstCaptured) {
+        // SD access stays out of the worker thread, whichever scene is active
+        tpms_burst_library_save_pending(app->txrx->burst_library, app->txrx->preset);
+        return true;
+    }
+    if(event == TPMSCustomEventTrafficBucket) {
+        tpms_traffic_save_pending(app->txrx->traffic);
+        return true;
+    }
+    if(event == TPMSCustomEventSessionLogPending) {
+        tpms_session_log_save_pending(app->txrx->session_log);
+        return true;
+    }
     return scene_manager_handle_custom_event(app->scene_manager, event);
 }
 
@@ -19,9 +32,26 @@ static bool tpms_app_back_event_callback(void* context) {
 static void tpms_app_tick_event_callback(void* context) {
     furi_assert(context);
     TPMSApp* app = context;
+    // Listed sensors can go missing whichever scene is active
+    tpms_notify_alert(app, tpms_alert_tick(app->txrx->alert, NULL));
     scene_manager_handle_tick_event(app->scene_manager);
 }
 
+static void tpms_app_worker_pair_callback(void* context, bool level, uint32_t duration) {
+    TPMSApp* app = context;
+    subghz_receiver_decode(app->txrx->receiver, level, duration);
+    // After decoders, so a burst they decoded is already marked
+    if(tpms_burst_library_feed(app->txrx->burst_library, level, duration)) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, TPMSCustomEventBurstCaptured);
+    }
+}
+
+static void tpms_app_worker_overrun_callback(void* context) {
+    TPMSApp* app = context;
+    subghz_receiver_reset(app->txrx->receiver);
+    tpms_burst_library_reset(app->txrx->burst_library);
+}
+
 TPMSApp* tpms_app_alloc() {
     TPMSApp* app = malloc(sizeof(TPMSApp));
 
@@ -62,6 +92,11 @@ TPMSApp* tpms_app_alloc() {
     app->widget = widget_alloc();
     view_dispatcher_add_view(app->view_dispatcher, TPMSViewWidget, widget_get_view(app->widget));
 
+    // Text Input
+    app->text_input = text_input_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher, TPMSViewTextInput, text_input_get_view(app->text_input));
+
     // Receiver
     app->tpms_receiver = tpms_view_receiver_alloc();
     view_dispatcher_add_view(
@@ -74,6 +109,14 @@ TPMSApp* tpms_app_alloc() {
         TPMSViewReceiverInfo,
         tpms_view_receiver_info_get_view(app->tpms_receiver_info));
 
+    // Log Viewer
+    app->tpms_log_viewer = tpms_view_log_viewer_alloc();
+    view_dispatcher_add_view(
+        app->view_dispatcher,
+        TPMSViewLogViewer,
+        tpms_view_log_viewer_get_view(app->tpms_log_viewer));
+    app->log_reader = tpms_log_reader_alloc();
+
     //init setting
     app->setting = subghz_setting_alloc();
 
@@ -81,6 +124,8 @@ TPMSApp* tpms_app_alloc() {
     subghz_setting_load(app->setting, EXT_PATH("subghz/assets/setting_user"));
 
     //init Worker & Protocol & History
+    // Readings of this session are timed from here on the tick
+    tpms_clock_anchor();
     app->lock = TPMSLockOff;
     app->txrx = malloc(sizeof(TPMSTxRx));
     app->txrx->preset = malloc(sizeof(SubGhzRadioPreset));
@@ -89,6 +134,16 @@ TPMSApp* tpms_app_alloc() {
 
     app->txrx->hopper_state = TPMSHopperStateOFF;
     app->txrx->history = tpms_history_alloc();
+    app->txrx->burst_library = tpms_burst_library_alloc();
+    app->txrx->traffic = tpms_traffic_alloc();
+    app->txrx->session_log = tpms_session_log_alloc();
+    app->txrx->leak = tpms_leak_alloc(TPMS_HISTORY_MAX);
+    app->txrx->alert = tpms_alert_alloc(TPMS_HISTORY_MAX);
+    app->txrx->cli = tpms_cli_alloc();
+    app->txrx->sort = tpms_sort_alloc(TPMS_HISTORY_MAX);
+    app->txrx->baseline = tpms_baseline_alloc();
+    app->txrx->frame_fff = flipper_format_string_alloc();
+    app->txrx->frame_protocol = furi_string_alloc();
     app->txrx->worker = subghz_worker_alloc();
     app->txrx->environment = subghz_environment_alloc();
     subghz_environment_set_protocol_registry(
@@ -104,11 +159,9 @@ TPMSApp* tpms_app_alloc() {
     subghz_devices_idle(app->txrx->radio_device);
 
     subghz_receiver_set_filter(app->txrx->receiver, SubGhzProtocolFlag_Decodable);
-    subghz_worker_set_overrun_callback(
-        app->txrx->worker, (SubGhzWorkerOverrunCallback)subghz_receiver_reset);
-    subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
-    subghz_worker_set_context(app->txrx->worker, app->txrx->receiver);
+    subghz_worker_set_overrun_callback(app->txrx->worker, tpms_app_worker_overrun_callback);
+    subghz_worker_set_pair_callback(app->txrx->worker, tpms_app_worker_pair_callback);
+    subghz_worker_set_context(app->txrx->worker, app);
 
     furi_hal_power_suppress_charge_enter();
 
@@ -137,6 +190,10 @@ void tpms_app_free(TPMSApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, TPMSViewWidget);
     widget_free(app->widget);
 
+    // Text Input
+    view_dispatcher_remove_view(app->view_dispatcher, TPMSViewTextInput);
+    text_input_free(app->text_input);
+
     // Receiver
     view_dispatcher_remove_view(app->view_dispatcher, TPMSViewReceiver);
     tpms_view_receiver_free(app->tpms_receiver);
@@ -145,13 +202,28 @@ void tpms_app_free(TPMSApp* app) {
     view_dispatcher_remove_view(app->view_dispatcher, TPMSViewReceiverInfo);
     tpms_view_receiver_info_free(app->tpms_receiver_info);
 
+    // Log Viewer
+    view_dispatcher_remove_view(app->view_dispatcher, TPMSViewLogViewer);
+    tpms_view_log_viewer_free(app->tpms_log_viewer);
+    tpms_log_reader_free(app->log_reader);
+
     //setting
     subghz_setting_free(app->setting);
 
     //Worker & Protocol & History
+    tpms_cli_free(app->txrx->cli);
     subghz_receiver_free(app->txrx->receiver);
     subghz_environment_free(app->txrx->environment);
     tpms_history_free(app->txrx->history);
+    tpms_burst_library_free(app->txrx->burst_library);
+    tpms_traffic_free(app->txrx->traffic);
+    tpms_session_log_free(app->txrx->session_log);
+    tpms_leak_free(app->txrx->leak);
+    tpms_alert_free(app->txrx->alert);
+    tpms_sort_free(app->txrx->sort);
+    tpms_baseline_free(app->txrx->baseline);
+    flipper_format_free(app->txrx->frame_fff);
+    furi_string_free(app->txrx->frame_protocol);
     subghz_worker_free(app->txrx->worker);
     furi_string_free(app->txrx->preset->name);
     free(app->txrx->preset);
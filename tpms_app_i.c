@@ -73,6 +73,9 @@ uint32_t tpms_rx(TPMSApp* app, uint32_t frequency) {
     furi_hal_subghz_flush_rx();
     furi_hal_subghz_rx();
 
+    tpms_burst_library_reset(app->txrx->burst_library);
+    tpms_burst_library_set_frequency(app->txrx->burst_library, frequency);
+
     furi_hal_subghz_start_async_rx(subghz_worker_rx_callback, app->txrx->worker);
     subghz_worker_start(app->txrx->worker);
     app->txrx->txrx_state = TPMSTxRxStateRx;
@@ -151,3 +154,162 @@ void tpms_hopper_update(TPMSApp* app) {
         tpms_rx(app, app->txrx->preset->frequency);
     }
 }
+
+void tpms_record_frame(TPMSApp* app, SubGhzProtocolDecoderBase* decoder_base) {
+    furi_assert(app);
+    furi_assert(decoder_base);
+    TPMSTxRx* txrx = app->txrx;
+    txrx->frame_ok = false;
+
+    // Decoded once here for every consumer that needs more than the history keeps
+    if(subghz_protocol_decoder_base_serialize(decoder_base, txrx->frame_fff, txrx->preset) !=
+       SubGhzProtocolStatusOk) {
+        return;
+    }
+    flipper_format_rewind(txrx->frame_fff);
+    if(!flipper_format_read_string(txrx->frame_fff, "Protocol", txrx->frame_protocol)) {
+        FURI_LOG_E(TAG, "Missing Protocol");
+        return;
+    }
+    if(tpms_block_generic_deserialize(&txrx->frame, txrx->frame_fff) != SubGhzProtocolStatusOk) {
+        return;
+    }
+    txrx->frame_ok = true;
+
+    const char* protocol = furi_string_get_cstr(txrx->frame_protocol);
+    if(tpms_traffic_feed(txrx->traffic, protocol, txrx->frame.id)) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, TPMSCustomEventTrafficBucket);
+    }
+    if(tpms_session_log_feed(
+           txrx->session_log, protocol, &txrx->frame, txrx->preset->frequency)) {
+        view_dispatcher_send_custom_event(app->view_dispatcher, TPMSCustomEventSessionLogPending);
+    }
+    tpms_cli_feed(txrx->cli, protocol, &txrx->frame, txrx->preset->frequency);
+}
+
+static const NotificationSequence tpms_sequence_leak = {
+    &message_red_255,
+    &message_vibro_on,
+    &message_delay_100,
+    &message_vibro_off,
+    &message_delay_100,
+    &message_vibro_on,
+    &message_delay_100,
+    &message_vibro_off,
+    &message_delay_250,
+    NULL,
+};
+
+// One sequence per TPMSAlertType, told apart by color, tone and rhythm
+static const NotificationSequence tpms_sequence_alert_drop = {
+    &message_red_255,
+    &message_vibro_on,
+    &message_note_c7,
+    &message_delay_100,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_delay_50,
+    &message_vibro_on,
+    &message_note_c7,
+    &message_delay_100,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_delay_50,
+    &message_vibro_on,
+    &message_note_c7,
+    &message_delay_100,
+    &message_sound_off,
+    &message_vibro_off,
+    NULL,
+};
+
+static const NotificationSequence tpms_sequence_alert_pressure_low = {
+    &message_red_255,
+    &message_vibro_on,
+    &message_note_a5,
+    &message_delay_250,
+    &message_sound_off,
+    &message_vibro_off,
+    &message_delay_100,
+    &message_vibro_on,
+    &message_note_a5,
+    &message_delay_250,
+    &message_sound_off,
+    &message_vibro_off,
+    NULL,
+};
+
+static const NotificationSequence tpms_sequence_alert_temperature_high = {
+    &message_red_255,
+    &message_vibro_on,
+    &message_note_c7,
+    &message_delay_500,
+    &message_sound_off,
+    &message_vibro_off,
+    NULL,
+};
+
+static const NotificationSequence tpms_sequence_alert_pressure_high = {
+    &message_blue_255,
+    &message_vibro_on,
+    &message_note_e6,
+    &message_delay_250,
+    &message_sound_off,
+    &message_vibro_off,
+    NULL,
+};
+
+static const NotificationSequence tpms_sequence_alert_battery_low = {
+    &message_red_255,
+    &message_green_255,
+    &message_note_e6,
+    &message_delay_100,
+    &message_sound_off,
+    NULL,
+};
+
+static const NotificationSequence tpms_sequence_alert_missing = {
+    &message_blue_255,
+    &message_vibro_on,
+    &message_delay_500,
+    &message_vibro_off,
+    NULL,
+};
+
+static const NotificationSequence* const tpms_sequence_alert[TPMSAlertCount] = {
+    [TPMSAlertDrop] = &tpms_sequence_alert_drop,
+    [TPMSAlertPressureLow] = &tpms_sequence_alert_pressure_low,
+    [TPMSAlertTemperatureHigh] = &tpms_sequence_alert_temperature_high,
+    [TPMSAlertPressureHigh] = &tpms_sequence_alert_pressure_high,
+    [TPMSAlertBatteryLow] = &tpms_sequence_alert_battery_low,
+    [TPMSAlertMissing] = &tpms_sequence_alert_missing,
+};
+
+void tpms_notify_alert(TPMSApp* app, uint8_t raised) {
+    furi_assert(app);
+    // The most urgent alert raised plays, sequences would cut each other off
+    if(raised) {
+        notification_message(app->notifications, tpms_sequence_alert[__builtin_ctz(raised)]);
+    }
+}
+
+void tpms_record_reading(TPMSApp* app, TPMSHistoryStateAddKey state) {
+    furi_assert(app);
+    TPMSTxRx* txrx = app->txrx;
+    bool new_sensor = state == TPMSHistoryStateAddKeyNewDada ||
+                      state == TPMSHistoryStateAddKeyReplaced;
+    if(!txrx->frame_ok || (!new_sensor && state != TPMSHistoryStateAddKeyUpdateData)) return;
+
+    // The frame tpms_record_frame decoded, now placed at a history record
+    uint16_t idx = tpms_history_get_last_index(txrx->history);
+    if(tpms_leak_feed(
+           txrx->leak,
+           idx,
+           new_sensor,
+           txrx->frame.timestamp,
+           txrx->frame.pressure,
+           txrx->frame.temperature)) {
+        notification_message(app->notifications, &tpms_sequence_leak);
+    }
+    tpms_notify_alert(app, tpms_alert_feed(txrx->alert, idx, new_sensor, &txrx->frame));
+}
@@ -9,9 +9,11 @@
 #include <gui/modules/submenu.h>
 #include <gui/modules/variable_item_list.h>
 #include <gui/modules/widget.h>
+#include <gui/modules/text_input.h>
 #include <notification/notification_messages.h>
 #include "views/tpms_receiver.h"
 #include "views/tpms_receiver_info.h"
+#include "views/tpms_log_viewer.h"
 #include "tpms_history.h"
 
 #include <lib/subghz/subghz_setting.h>
@@ -21,6 +23,16 @@
 #include <lib/subghz/registry.h>
 
 #include "helpers/radio_device_loader.h"
+#include "helpers/tpms_burst_library.h"
+#include "helpers/tpms_traffic.h"
+#include "helpers/tpms_session_log.h"
+#include "helpers/tpms_leak.h"
+#include "helpers/tpms_alert.h"
+#include "helpers/tpms_cli.h"
+#include "helpers/tpms_sort.h"
+#include "helpers/tpms_baseline.h"
+#include "helpers/tpms_log_reader.h"
+#include "helpers/tpms_clock.h"
 
 typedef struct TPMSApp TPMSApp;
 
@@ -32,6 +44,19 @@ struct TPMSTxRx {
     SubGhzReceiver* receiver;
     SubGhzRadioPreset* preset;
     TPMSHistory* history;
+    TPMSBurstLibrary* burst_library;
+    TPMSTraffic* traffic;
+    TPMSSessionLog* session_log;
+    TPMSLeak* leak;
+    TPMSAlert* alert;
+    TPMSCli* cli;
+    TPMSSort* sort;
+    TPMSBaseline* baseline;
+    // Scratch for tpms_record_frame, worker thread only
+    FlipperFormat* frame_fff;
+    FuriString* frame_protocol;
+    TPMSBlockGeneric frame;
+    bool frame_ok;
     uint16_t idx_menu_chosen;
     TPMSTxRxState txrx_state;
     TPMSHopperState hopper_state;
@@ -51,8 +76,12 @@ struct TPMSApp {
     VariableItemList* variable_item_list;
     Submenu* submenu;
     Widget* widget;
+    TextInput* text_input;
+    char search_prefix[TPMS_SORT_ID_LEN];
     TPMSReceiver* tpms_receiver;
     TPMSReceiverInfo* tpms_receiver_info;
+    TPMSLogViewer* tpms_log_viewer;
+    TPMSLogReader* log_reader;
     TPMSLock lock;
     SubGhzSetting* setting;
     TPMSRelearn relearn;
@@ -73,3 +102,6 @@ void tpms_idle(TPMSApp* app);
 void tpms_rx_end(TPMSApp* app);
 void tpms_sleep(TPMSApp* app);
 void tpms_hopper_update(TPMSApp* app);
+void tpms_record_frame(TPMSApp* app, SubGhzProtocolDecoderBase* decoder_base);
+void tpms_record_reading(TPMSApp* app, TPMSHistoryStateAddKey state);
+void tpms_notify_alert(TPMSApp* app, uint8_t raised);
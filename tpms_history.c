@@ -3,10 +3,10 @@
 #include <lib/toolbox/stream/stream.h>
 #include <lib/subghz/receiver.h>
 #include "protocols/tpms_generic.h"
+#include "helpers/tpms_timer_wheel.h"
 
 #include <furi.h>
 
-#define TPMS_HISTORY_MAX 50
 #define TAG "TPMSHistory"
 
 typedef struct {
@@ -14,6 +14,11 @@ typedef struct {
     FlipperFormat* flipper_string;
     uint8_t type;
     uint32_t id;
+    uint32_t last_seen; // seconds, tpms_history_now
+    float pressure; // bar
+    float temperature; // celsius
+    float rssi; // dBm
+    TPMSSensorState state;
     SubGhzRadioPreset* preset;
 } TPMSHistoryItem;
 
@@ -28,21 +33,39 @@ typedef struct {
 struct TPMSHistory {
     uint32_t last_update_timestamp;
     uint16_t last_index_write;
+    uint16_t last_index;
     uint8_t code_last_hash_data;
     FuriString* tmp_string;
     TPMSHistoryStruct* history;
+    // Items are added on the worker thread, expired and read on the main thread. Recursive, the
+    // getters are called from the tick and flush callbacks too
+    FuriMutex* mutex;
+    // Timer n belongs to item n, it is the next state change of the sensor
+    TPMSTimerWheel* wheel;
+    TPMSHistorySensorStateCallback state_callback;
+    void* state_context;
+    // Bit n set when item n changed since tpms_history_flush_dirty
+    uint32_t dirty[(TPMS_HISTORY_MAX + 31) / 32];
 };
 
+static uint32_t tpms_history_now(void) {
+    return furi_get_tick() / furi_kernel_get_tick_frequency();
+}
+
 TPMSHistory* tpms_history_alloc(void) {
     TPMSHistory* instance = malloc(sizeof(TPMSHistory));
     instance->tmp_string = furi_string_alloc();
     instance->history = malloc(sizeof(TPMSHistoryStruct));
     TPMSHistoryItemArray_init(instance->history->data);
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    instance->wheel = tpms_timer_wheel_alloc(TPMS_HISTORY_MAX, tpms_history_now());
     return instance;
 }
 
 void tpms_history_free(TPMSHistory* instance) {
     furi_assert(instance);
+    tpms_timer_wheel_free(instance->wheel);
+    furi_mutex_free(instance->mutex);
     furi_string_free(instance->tmp_string);
     for
         M_EACH(item, instance->history->data, TPMSHistoryItemArray_t) {
@@ -59,24 +82,17 @@ void tpms_history_free(TPMSHistory* instance) {
 
 uint32_t tpms_history_get_frequency(TPMSHistory* instance, uint16_t idx) {
     furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
     TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
-    return item->preset->frequency;
-}
-
-SubGhzRadioPreset* tpms_history_get_radio_preset(TPMSHistory* instance, uint16_t idx) {
-    furi_assert(instance);
-    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
-    return item->preset;
-}
-
-const char* tpms_history_get_preset(TPMSHistory* instance, uint16_t idx) {
-    furi_assert(instance);
-    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
-    return furi_string_get_cstr(item->preset->name);
+    uint32_t frequency = item->preset->frequency;
+    furi_mutex_release(instance->mutex);
+    return frequency;
 }
 
 void tpms_history_reset(TPMSHistory* instance) {
     furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    tpms_timer_wheel_reset(instance->wheel, tpms_history_now());
     furi_string_reset(instance->tmp_string);
     for
         M_EACH(item, instance->history->data, TPMSHistoryItemArray_t) {
@@ -88,7 +104,10 @@ void tpms_history_reset(TPMSHistory* instance) {
         }
     TPMSHistoryItemArray_reset(instance->history->data);
     instance->last_index_write = 0;
+    instance->last_index = 0;
     instance->code_last_hash_data = 0;
+    memset(instance->dirty, 0, sizeof(instance->dirty));
+    furi_mutex_release(instance->mutex);
 }
 
 uint16_t tpms_history_get_item(TPMSHistory* instance) {
@@ -98,29 +117,159 @@ uint16_t tpms_history_get_item(TPMSHistory* instance) {
 
 uint8_t tpms_history_get_type_protocol(TPMSHistory* instance, uint16_t idx) {
     furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
     TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
-    return item->type;
+    uint8_t type = item->type;
+    furi_mutex_release(instance->mutex);
+    return type;
 }
 
-const char* tpms_history_get_protocol_name(TPMSHistory* instance, uint16_t idx) {
+void tpms_history_get_protocol_name(TPMSHistory* instance, uint16_t idx, FuriString* output) {
     furi_assert(instance);
+    furi_assert(output);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
     TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
     flipper_format_rewind(item->flipper_string);
-    if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+    if(!flipper_format_read_string(item->flipper_string, "Protocol", output)) {
         FURI_LOG_E(TAG, "Missing Protocol");
-        furi_string_reset(instance->tmp_string);
+        furi_string_reset(output);
     }
-    return furi_string_get_cstr(instance->tmp_string);
+    furi_mutex_release(instance->mutex);
 }
 
-FlipperFormat* tpms_history_get_raw_data(TPMSHistory* instance, uint16_t idx) {
+uint32_t tpms_history_get_id(TPMSHistory* instance, uint16_t idx) {
     furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
     TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
-    if(item->flipper_string) {
-        return item->flipper_string;
+    uint32_t id = item->id;
+    furi_mutex_release(instance->mutex);
+    return id;
+}
+
+TPMSSensorState tpms_history_get_state(TPMSHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
+    TPMSSensorState state = item->state;
+    furi_mutex_release(instance->mutex);
+    return state;
+}
+
+uint32_t tpms_history_get_reading(
+    TPMSHistory* instance,
+    uint16_t idx,
+    float* pressure,
+    float* temperature) {
+    furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
+    if(pressure) *pressure = item->pressure;
+    if(temperature) *temperature = item->temperature;
+    uint32_t last_seen = item->last_seen;
+    furi_mutex_release(instance->mutex);
+    return last_seen;
+}
+
+float tpms_history_get_rssi(TPMSHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
+    float rssi = item->rssi;
+    furi_mutex_release(instance->mutex);
+    return rssi;
+}
+
+uint16_t tpms_history_get_last_index(TPMSHistory* instance) {
+    furi_assert(instance);
+    return instance->last_index;
+}
+
+static void tpms_history_timer_callback(uint16_t timer, void* context) {
+    TPMSHistory* instance = context;
+    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, timer);
+    if(item->state == TPMSSensorStateFresh) {
+        item->state = TPMSSensorStateStale;
+        tpms_timer_wheel_schedule(
+            instance->wheel, timer, item->last_seen + TPMS_HISTORY_GONE_S);
     } else {
-        return NULL;
+        item->state = TPMSSensorStateGone;
+    }
+    if(instance->state_callback) {
+        instance->state_callback(timer, item->state, instance->state_context);
+    }
+}
+
+void tpms_history_tick(
+    TPMSHistory* instance,
+    TPMSHistorySensorStateCallback callback,
+    void* context) {
+    furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    instance->state_callback = callback;
+    instance->state_context = context;
+    tpms_timer_wheel_advance(
+        instance->wheel, tpms_history_now(), tpms_history_timer_callback, instance);
+    instance->state_callback = NULL;
+    furi_mutex_release(instance->mutex);
+}
+
+void tpms_history_flush_dirty(
+    TPMSHistory* instance,
+    TPMSHistoryItemCallback callback,
+    void* context) {
+    furi_assert(instance);
+    furi_assert(callback);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    for(uint16_t word = 0; word < COUNT_OF(instance->dirty); word++) {
+        uint32_t bits = instance->dirty[word];
+        instance->dirty[word] = 0;
+        while(bits) {
+            uint16_t bit = __builtin_ctz(bits);
+            bits &= bits - 1;
+            callback(word * 32 + bit, context);
+        }
     }
+    furi_mutex_release(instance->mutex);
+}
+
+static void tpms_history_seen(TPMSHistory* instance, uint16_t idx) {
+    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
+
+    // Values shown and sorted on in the list, the full frame stays in flipper_string
+    item->pressure = 0;
+    item->temperature = 0;
+    item->rssi = 0;
+    if(flipper_format_rewind(item->flipper_string)) {
+        flipper_format_read_float(item->flipper_string, "Pressure", &item->pressure, 1);
+    }
+    if(flipper_format_rewind(item->flipper_string)) {
+        flipper_format_read_float(item->flipper_string, "Temp", &item->temperature, 1);
+    }
+    if(flipper_format_rewind(item->flipper_string)) {
+        flipper_format_read_float(item->flipper_string, "Rssi", &item->rssi, 1);
+    }
+    instance->dirty[idx / 32] |= 1UL << (idx % 32);
+
+    item->last_seen = tpms_history_now();
+    item->state = TPMSSensorStateFresh;
+    tpms_timer_wheel_schedule(instance->wheel, idx, item->last_seen + TPMS_HISTORY_STALE_S);
+    instance->last_index = idx;
+}
+
+bool tpms_history_get_raw_data(TPMSHistory* instance, uint16_t idx, FlipperFormat* output) {
+    furi_assert(instance);
+    furi_assert(output);
+    Stream* stream = flipper_format_get_raw_stream(output);
+    stream_clean(stream);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
+    bool copied = false;
+    if(item->flipper_string) {
+        Stream* item_stream = flipper_format_get_raw_stream(item->flipper_string);
+        copied = stream_rewind(item_stream) && stream_copy_full(item_stream, stream) > 0;
+    }
+    furi_mutex_release(instance->mutex);
+    return copied;
 }
 bool tpms_history_get_text_space_left(TPMSHistory* instance, FuriString* output) {
     furi_assert(instance);
@@ -134,18 +283,58 @@ bool tpms_history_get_text_space_left(TPMSHistory* instance, FuriString* output)
 }
 
 void tpms_history_get_text_item_menu(TPMSHistory* instance, FuriString* output, uint16_t idx) {
+    furi_assert(instance);
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
     TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, idx);
     furi_string_set(output, item->item_str);
+    furi_mutex_release(instance->mutex);
 }
 
-TPMSHistoryStateAddKey
-    tpms_history_add_to_history(TPMSHistory* instance, void* context, SubGhzRadioPreset* preset) {
-    furi_assert(instance);
-    furi_assert(context);
+static void tpms_history_item_set(
+    TPMSHistory* instance,
+    TPMSHistoryItem* item,
+    SubGhzProtocolDecoderBase* decoder_base,
+    SubGhzRadioPreset* preset,
+    uint32_t id) {
+    item->type = decoder_base->protocol->type;
+    item->preset->frequency = preset->frequency;
+    furi_string_set(item->preset->name, preset->name);
+    item->preset->data = preset->data;
+    item->preset->data_size = preset->data_size;
+    item->id = id;
 
-    if(instance->last_index_write >= TPMS_HISTORY_MAX) return TPMSHistoryStateAddKeyOverflow;
+    stream_clean(flipper_format_get_raw_stream(item->flipper_string));
+    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
 
-    SubGhzProtocolDecoderBase* decoder_base = context;
+    do {
+        if(!flipper_format_rewind(item->flipper_string)) {
+            FURI_LOG_E(TAG, "Rewind error");
+            break;
+        }
+        if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+            FURI_LOG_E(TAG, "Missing Protocol");
+            break;
+        }
+
+        if(!flipper_format_rewind(item->flipper_string)) {
+            FURI_LOG_E(TAG, "Rewind error");
+            break;
+        }
+        uint32_t id = 0;
+        if(!flipper_format_read_uint32(item->flipper_string, "Id", &id, 1)) {
+            FURI_LOG_E(TAG, "Missing Id");
+            break;
+        }
+        // ID first, list rows cut the tail to make room for the readings
+        furi_string_printf(
+            item->item_str, "%lX %s", id, furi_string_get_cstr(instance->tmp_string));
+    } while(false);
+}
+
+static TPMSHistoryStateAddKey tpms_history_add_to_history_locked(
+    TPMSHistory* instance,
+    SubGhzProtocolDecoderBase* decoder_base,
+    SubGhzRadioPreset* preset) {
     if((instance->code_last_hash_data ==
         subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
        ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
@@ -173,60 +362,55 @@ TPMSHistoryStateAddKey
     flipper_format_free(fff);
 
     // Update record if found
-    bool sensor_found = false;
     for(size_t i = 0; i < TPMSHistoryItemArray_size(instance->history->data); i++) {
         TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, i);
         if(item->id == id) {
-            sensor_found = true;
             Stream* flipper_string_stream = flipper_format_get_raw_stream(item->flipper_string);
             stream_clean(flipper_string_stream);
             subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
+            tpms_history_seen(instance, i);
             return TPMSHistoryStateAddKeyUpdateData;
         }
     }
 
-    // or add new record
-    if(!sensor_found) { //-V547
-        TPMSHistoryItem* item = TPMSHistoryItemArray_push_raw(instance->history->data);
-        item->preset = malloc(sizeof(SubGhzRadioPreset));
-        item->type = decoder_base->protocol->type;
-        item->preset->frequency = preset->frequency;
-        item->preset->name = furi_string_alloc();
-        furi_string_set(item->preset->name, preset->name);
-        item->preset->data = preset->data;
-        item->preset->data_size = preset->data_size;
-        item->id = id;
-
-        item->item_str = furi_string_alloc();
-        item->flipper_string = flipper_format_string_alloc();
-        subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
-
-        do {
-            if(!flipper_format_rewind(item->flipper_string)) {
-                FURI_LOG_E(TAG, "Rewind error");
-                break;
-            }
-            if(!flipper_format_read_string(
-                   item->flipper_string, "Protocol", instance->tmp_string)) {
-                FURI_LOG_E(TAG, "Missing Protocol");
-                break;
-            }
-
-            if(!flipper_format_rewind(item->flipper_string)) {
-                FURI_LOG_E(TAG, "Rewind error");
-                break;
-            }
-            uint32_t id = 0;
-            if(!flipper_format_read_uint32(item->flipper_string, "Id", &id, 1)) {
-                FURI_LOG_E(TAG, "Missing Id");
-                break;
+    if(instance->last_index_write >= TPMS_HISTORY_MAX) {
+        // Full, reuse the record of the sensor gone the longest
+        TPMSHistoryItem* oldest = NULL;
+        size_t oldest_idx = 0;
+        for(size_t i = 0; i < TPMSHistoryItemArray_size(instance->history->data); i++) {
+            TPMSHistoryItem* item = TPMSHistoryItemArray_get(instance->history->data, i);
+            if(item->state == TPMSSensorStateGone &&
+               (!oldest || (int32_t)(item->last_seen - oldest->last_seen) < 0)) {
+                oldest = item;
+                oldest_idx = i;
             }
-            furi_string_cat_printf(instance->tmp_string, " %lX", id);
+        }
+        if(!oldest) return TPMSHistoryStateAddKeyOverflow;
 
-            furi_string_set(item->item_str, instance->tmp_string);
-        } while(false);
-        instance->last_index_write++;
-        return TPMSHistoryStateAddKeyNewDada;
+        tpms_history_item_set(instance, oldest, decoder_base, preset, id);
+        tpms_history_seen(instance, oldest_idx);
+        return TPMSHistoryStateAddKeyReplaced;
     }
-    return TPMSHistoryStateAddKeyUnknown;
+
+    // or add new record
+    TPMSHistoryItem* item = TPMSHistoryItemArray_push_raw(instance->history->data);
+    item->preset = malloc(sizeof(SubGhzRadioPreset));
+    item->preset->name = furi_string_alloc();
+    item->item_str = furi_string_alloc();
+    item->flipper_string = flipper_format_string_alloc();
+    tpms_history_item_set(instance, item, decoder_base, preset, id);
+    tpms_history_seen(instance, instance->last_index_write);
+    instance->last_index_write++;
+    return TPMSHistoryStateAddKeyNewDada;
+}
+
+TPMSHistoryStateAddKey
+    tpms_history_add_to_history(TPMSHistory* instance, void* context, SubGhzRadioPreset* preset) {
+    furi_assert(instance);
+    furi_assert(context);
+
+    furi_mutex_acquire(instance->mutex, FuriWaitForever);
+    TPMSHistoryStateAddKey res = tpms_history_add_to_history_locked(instance, context, preset);
+    furi_mutex_release(instance->mutex);
+    return res;
 }
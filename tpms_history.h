@@ -6,6 +6,13 @@
 #include <furi_hal.h>
 #include <lib/flipper_format/flipper_format.h>
 #include <lib/subghz/types.h>
+#include "helpers/tpms_types.h"
+
+#define TPMS_HISTORY_MAX 50
+
+// Seconds without a reading before a sensor turns stale, then gone
+#define TPMS_HISTORY_STALE_S 120
+#define TPMS_HISTORY_GONE_S 600
 
 typedef struct TPMSHistory TPMSHistory;
 
@@ -16,8 +23,27 @@ typedef enum {
     TPMSHistoryStateAddKeyNewDada,
     TPMSHistoryStateAddKeyUpdateData,
     TPMSHistoryStateAddKeyOverflow,
+    TPMSHistoryStateAddKeyReplaced,
 } TPMSHistoryStateAddKey;
 
+/** Called from tpms_history_tick for each sensor whose state changed
+ *
+ * @param idx       - record index
+ * @param state     - new state
+ * @param context   - callback context
+ */
+typedef void (*TPMSHistorySensorStateCallback)(
+    uint16_t idx,
+    TPMSSensorState state,
+    void* context);
+
+/** Called from tpms_history_flush_dirty for each record changed since the last flush
+ *
+ * @param idx       - record index
+ * @param context   - callback context
+ */
+typedef void (*TPMSHistoryItemCallback)(uint16_t idx, void* context);
+
 /** Allocate TPMSHistory
  * 
  * @return TPMSHistory* 
@@ -44,16 +70,6 @@ void tpms_history_reset(TPMSHistory* instance);
  */
 uint32_t tpms_history_get_frequency(TPMSHistory* instance, uint16_t idx);
 
-SubGhzRadioPreset* tpms_history_get_radio_preset(TPMSHistory* instance, uint16_t idx);
-
-/** Get preset to history[idx]
- * 
- * @param instance  - TPMSHistory instance
- * @param idx       - record index  
- * @return preset   - preset name
- */
-const char* tpms_history_get_preset(TPMSHistory* instance, uint16_t idx);
-
 /** Get history index write 
  * 
  * @param instance  - TPMSHistory instance
@@ -73,9 +89,78 @@ uint8_t tpms_history_get_type_protocol(TPMSHistory* instance, uint16_t idx);
  * 
  * @param instance  - TPMSHistory instance
  * @param idx       - record index  
- * @return name      - const char* name protocol  
+ * @param output    - FuriString* name protocol, copied
+ */
+void tpms_history_get_protocol_name(TPMSHistory* instance, uint16_t idx, FuriString* output);
+
+/** Get sensor id to history[idx]
+ * 
+ * @param instance  - TPMSHistory instance
+ * @param idx       - record index  
+ * @return id       - uint32_t sensor id
+ */
+uint32_t tpms_history_get_id(TPMSHistory* instance, uint16_t idx);
+
+/** Get sensor state to history[idx]
+ * 
+ * @param instance  - TPMSHistory instance
+ * @param idx       - record index  
+ * @return state    - TPMSSensorState
+ */
+TPMSSensorState tpms_history_get_state(TPMSHistory* instance, uint16_t idx);
+
+/** Get the last reading to history[idx]
+ * 
+ * @param instance      - TPMSHistory instance
+ * @param idx           - record index
+ * @param pressure      - pressure, bar
+ * @param temperature   - temperature, celsius
+ * @return last_seen    - seconds since boot the reading came in
+ */
+uint32_t tpms_history_get_reading(
+    TPMSHistory* instance,
+    uint16_t idx,
+    float* pressure,
+    float* temperature);
+
+/** Get signal strength of the last reading to history[idx]
+ * 
+ * @param instance  - TPMSHistory instance
+ * @param idx       - record index
+ * @return rssi     - dBm
+ */
+float tpms_history_get_rssi(TPMSHistory* instance, uint16_t idx);
+
+/** Get index of the record last added, updated or replaced
+ * 
+ * @param instance  - TPMSHistory instance
+ * @return idx      - record index  
+ */
+uint16_t tpms_history_get_last_index(TPMSHistory* instance);
+
+/** Expire sensors not heard from. Fresh sensors turn stale after TPMS_HISTORY_STALE_S and
+ * gone after TPMS_HISTORY_GONE_S, a reading makes them fresh again
+ * 
+ * @param instance  - TPMSHistory instance
+ * @param callback  - TPMSHistorySensorStateCallback, called for each change
+ * @param context   - callback context
+ */
+void tpms_history_tick(
+    TPMSHistory* instance,
+    TPMSHistorySensorStateCallback callback,
+    void* context);
+
+/** Call back for each record added, updated or replaced since the last flush, in index
+ * order, and mark them clean. Lets the list redraw only the rows that changed
+ * 
+ * @param instance  - TPMSHistory instance
+ * @param callback  - TPMSHistoryItemCallback
+ * @param context   - callback context
  */
-const char* tpms_history_get_protocol_name(TPMSHistory* instance, uint16_t idx);
+void tpms_history_flush_dirty(
+    TPMSHistory* instance,
+    TPMSHistoryItemCallback callback,
+    void* context);
 
 /** Get string item menu to history[idx]
  * 
@@ -93,7 +178,8 @@ void tpms_history_get_text_item_menu(TPMSHistory* instance, FuriString* output,
  */
 bool tpms_history_get_text_space_left(TPMSHistory* instance, FuriString* output);
 
-/** Add protocol to history
+/** Add protocol to history. When history is full, a new sensor replaces the gone sensor
+ * heard from least recently
  * 
  * @param instance  - TPMSHistory instance
  * @param context    - SubGhzProtocolCommon context
@@ -103,10 +189,11 @@ bool tpms_history_get_text_space_left(TPMSHistory* instance, FuriString* output)
 TPMSHistoryStateAddKey
     tpms_history_add_to_history(TPMSHistory* instance, void* context, SubGhzRadioPreset* preset);
 
-/** Get SubGhzProtocolCommonLoad to load into the protocol decoder bin data
+/** Copy the saved frame of history[idx] to load into the protocol decoder bin data
  * 
  * @param instance  - TPMSHistory instance
  * @param idx       - record index
- * @return SubGhzProtocolCommonLoad*
+ * @param output    - FlipperFormat string instance, its content is replaced
+ * @return bool     - frame was copied
  */
-FlipperFormat* tpms_history_get_raw_data(TPMSHistory* instance, uint16_t idx);
+bool tpms_history_get_raw_data(TPMSHistory* instance, uint16_t idx, FlipperFormat* output);
@@ -0,0 +1,159 @@
+#include "tpms_log_viewer.h"
+#include <input/input.h>
+#include <gui/elements.h>
+
+#define LOG_ROW_LEN 32
+
+typedef struct {
+    char title[LOG_ROW_LEN];
+    char position[LOG_ROW_LEN];
+    char row[TPMS_LOG_VIEWER_ROWS][LOG_ROW_LEN];
+    uint8_t count;
+} TPMSLogViewerModel;
+
+struct TPMSLogViewer {
+    View* view;
+    TPMSLogViewerCallback callback;
+    void* context;
+};
+
+void tpms_view_log_viewer_set_callback(
+    TPMSLogViewer* tpms_log_viewer,
+    TPMSLogViewerCallback callback,
+    void* context) {
+    furi_assert(tpms_log_viewer);
+    furi_assert(callback);
+    tpms_log_viewer->callback = callback;
+    tpms_log_viewer->context = context;
+}
+
+void tpms_view_log_viewer_set_page(
+    TPMSLogViewer* tpms_log_viewer,
+    const char* position,
+    const TPMSSessionLogRecord* records,
+    uint8_t count,
+    bool filtered) {
+    furi_assert(tpms_log_viewer);
+    furi_assert(position);
+    furi_assert(records || !count);
+    count = MIN(count, TPMS_LOG_VIEWER_ROWS);
+
+    with_view_model(
+        tpms_log_viewer->view,
+        TPMSLogViewerModel * model,
+        {
+            model->count = count;
+            strlcpy(model->position, position, LOG_ROW_LEN);
+            model->title[0] = '\0';
+            if(count && filtered) {
+                snprintf(model->title, LOG_ROW_LEN, "ID %08lX", records[0].id);
+            } else if(count) {
+                // Date of the top row, rows only show the time
+                DateTime dt;
+                datetime_timestamp_to_datetime(records[0].timestamp, &dt);
+                snprintf(
+                    model->title,
+                    LOG_ROW_LEN,
+                    "%02u.%02u.%04u",
+                    dt.day,
+                    dt.month,
+                    dt.year);
+            } else {
+                strlcpy(model->title, "No records", LOG_ROW_LEN);
+            }
+
+            for(uint8_t i = 0; i < count; i++) {
+                DateTime dt;
+                datetime_timestamp_to_datetime(records[i].timestamp, &dt);
+                snprintf(
+                    model->row[i],
+                    LOG_ROW_LEN,
+                    "%02u:%02u %08lX %4.2f %3.0f",
+                    dt.hour,
+                    dt.minute,
+                    records[i].id,
+                    (double)records[i].pressure,
+                    (double)records[i].temperature);
+            }
+        },
+        true);
+}
+
+static void tpms_view_log_viewer_draw(Canvas* canvas, TPMSLogViewerModel* model) {
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str(canvas, 0, 8, model->title);
+    canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, model->position);
+    canvas_draw_line(canvas, 0, 10, 127, 10);
+
+    for(uint8_t i = 0; i < model->count; i++) {
+        // The top row is the one OK filters on
+        if(i == 0) {
+            canvas_draw_box(canvas, 0, 12, 128, 10);
+            canvas_set_color(canvas, ColorWhite);
+        }
+        canvas_draw_str(canvas, 1, 20 + i * 10, model->row[i]);
+        canvas_set_color(canvas, ColorBlack);
+    }
+}
+
+static bool tpms_view_log_viewer_input(InputEvent* event, void* context) {
+    furi_assert(context);
+    TPMSLogViewer* tpms_log_viewer = context;
+
+    if(event->key == InputKeyBack) return false;
+
+    TPMSCustomEvent custom = 0;
+    bool repeat = event->type == InputTypeShort || event->type == InputTypeRepeat;
+    if(event->key == InputKeyUp && repeat) {
+        custom = TPMSCustomEventViewLogUp;
+    } else if(event->key == InputKeyDown && repeat) {
+        custom = TPMSCustomEventViewLogDown;
+    } else if(event->key == InputKeyLeft && event->type == InputTypeShort) {
+        custom = TPMSCustomEventViewLogPageUp;
+    } else if(event->key == InputKeyRight && event->type == InputTypeShort) {
+        custom = TPMSCustomEventViewLogPageDown;
+    } else if(event->key == InputKeyLeft && event->type == InputTypeLong) {
+        custom = TPMSCustomEventViewLogFirst;
+    } else if(event->key == InputKeyRight && event->type == InputTypeLong) {
+        custom = TPMSCustomEventViewLogLast;
+    } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
+        custom = TPMSCustomEventViewLogFilter;
+    }
+    if(custom && tpms_log_viewer->callback) {
+        tpms_log_viewer->callback(custom, tpms_log_viewer->context);
+    }
+
+    return true;
+}
+
+TPMSLogViewer* tpms_view_log_viewer_alloc() {
+    TPMSLogViewer* tpms_log_viewer = malloc(sizeof(TPMSLogViewer));
+
+    // View allocation and configuration
+    tpms_log_viewer->view = view_alloc();
+    view_allocate_model(tpms_log_viewer->view, ViewModelTypeLocking, sizeof(TPMSLogViewerModel));
+    view_set_context(tpms_log_viewer->view, tpms_log_viewer);
+    view_set_draw_callback(tpms_log_viewer->view, (ViewDrawCallback)tpms_view_log_viewer_draw);
+    view_set_input_callback(tpms_log_viewer->view, tpms_view_log_viewer_input);
+
+    with_view_model(
+        tpms_log_viewer->view,
+        TPMSLogViewerModel * model,
+        { memset(model, 0, sizeof(TPMSLogViewerModel)); },
+        false);
+
+    return tpms_log_viewer;
+}
+
+void tpms_view_log_viewer_free(TPMSLogViewer* tpms_log_viewer) {
+    furi_assert(tpms_log_viewer);
+    view_free(tpms_log_viewer->view);
+    free(tpms_log_viewer);
+}
+
+View* tpms_view_log_viewer_get_view(TPMSLogViewer* tpms_log_viewer) {
+    furi_assert(tpms_log_viewer);
+    return tpms_log_viewer->view;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <gui/view.h>
+#include "../helpers/tpms_types.h"
+#include "../helpers/tpms_event.h"
+#include "../helpers/tpms_session_log.h"
+
+#define TPMS_LOG_VIEWER_ROWS 5
+
+typedef struct TPMSLogViewer TPMSLogViewer;
+
+typedef void (*TPMSLogViewerCallback)(TPMSCustomEvent event, void* context);
+
+void tpms_view_log_viewer_set_callback(
+    TPMSLogViewer* tpms_log_viewer,
+    TPMSLogViewerCallback callback,
+    void* context);
+
+/** Show a page of records
+ *
+ * @param tpms_log_viewer   - TPMSLogViewer instance
+ * @param position          - title, where the page is in the log
+ * @param records           - records, the first is the top row
+ * @param count             - records, at most TPMS_LOG_VIEWER_ROWS
+ * @param filtered          - only one sensor is shown
+ */
+void tpms_view_log_viewer_set_page(
+    TPMSLogViewer* tpms_log_viewer,
+    const char* position,
+    const TPMSSessionLogRecord* records,
+    uint8_t count,
+    bool filtered);
+
+TPMSLogViewer* tpms_view_log_viewer_alloc();
+
+void tpms_view_log_viewer_free(TPMSLogViewer* tpms_log_viewer);
+
+View* tpms_view_log_viewer_get_view(TPMSLogViewer* tpms_log_viewer);
@@ -1,5 +1,6 @@
 #include "tpms_receiver.h"
 #include "../tpms_app_i.h"
+#include "../helpers/tpms_snapshot.h"
 #include <tpms_icons.h>
 #include <math.h>
 
@@ -15,9 +16,17 @@
 #define UNLOCK_CNT 3
 
 #define SUBGHZ_RAW_THRESHOLD_MIN -90.0f
+#define LABEL_LEN 32
+#define READING_WIDTH_PX 40 // "2.3 -10C"
+#define AGE_WIDTH_PX 17 // "59m" and a gap
+
 typedef struct {
     FuriString* item_str;
     uint8_t type;
+    TPMSSensorState state;
+    float pressure; // bar
+    float temperature; // celsius
+    uint32_t last_seen; // seconds since boot
 } TPMSReceiverMenuItem;
 
 ARRAY_DEF(TPMSReceiverMenuItemArray, TPMSReceiverMenuItem, M_POD_OPLIST)
@@ -42,24 +51,19 @@ typedef enum {
     TPMSReceiverBarShowLock,
     TPMSReceiverBarShowToUnlockPress,
     TPMSReceiverBarShowUnlock,
+    TPMSReceiverBarShowSort,
 } TPMSReceiverBarShow;
 
-struct TPMSReceiver {
-    TPMSLock lock;
-    uint8_t lock_count;
-    FuriTimer* lock_timer;
-    FuriTimer* relearn_timer;
-    bool relearn_active;
-    View* view;
-    TPMSReceiverCallback callback;
-    void* context;
-};
-
 typedef struct {
     FuriString* frequency_str;
     FuriString* preset_str;
     FuriString* history_stat_str;
     TPMSReceiverHistory* history;
+    // Items are kept by history record, the list shows them in order: order[pos] is the
+    // record at list position pos and position[] its inverse. idx is a list position
+    uint16_t order[TPMS_HISTORY_MAX];
+    uint16_t position[TPMS_HISTORY_MAX];
+    char sort_name[12];
     uint16_t idx;
     uint16_t list_offset;
     uint16_t history_item;
@@ -68,11 +72,127 @@ typedef struct {
     bool external_radio;
 } TPMSReceiverModel;
 
+// What the draw callback reads: the visible rows only, copied out of TPMSReceiverModel
+typedef struct {
+    char label[MENU_ITEMS][LABEL_LEN];
+    char reading[MENU_ITEMS][12];
+    char age[MENU_ITEMS][6];
+    TPMSSensorState state[MENU_ITEMS];
+    char frequency_str[16];
+    char preset_str[8];
+    char history_stat_str[16];
+    char sort_name[12];
+    uint16_t idx;
+    uint16_t list_offset;
+    uint16_t history_item;
+    TPMSReceiverBarShow bar_show;
+    uint8_t u_rssi;
+    bool external_radio;
+} TPMSReceiverSnapshot;
+
+typedef struct {
+    char source[LABEL_LEN];
+    char fitted[LABEL_LEN + 3]; // source cut to max_px, with "..." when cut
+    uint8_t max_px;
+    uint16_t width; // px
+} TPMSReceiverLabel;
+
+typedef struct {
+    TPMSSnapshot* snapshot;
+    // Labels fitted on earlier frames, owned by the draw callback. Rows only change on updates
+    // and scrolls, so most frames draw from here without measuring the strings again
+    TPMSReceiverLabel label[MENU_ITEMS];
+} TPMSReceiverViewModel;
+
+struct TPMSReceiver {
+    // Writers (worker, tick, timers, input) serialize on mutex, the draw callback never takes it
+    FuriMutex* mutex;
+    TPMSReceiverModel model;
+    TPMSSnapshot* snapshot;
+    TPMSLock lock;
+    uint8_t lock_count;
+    FuriTimer* lock_timer;
+    FuriTimer* relearn_timer;
+    FuriTimer* sort_timer;
+    bool relearn_active;
+    View* view;
+    TPMSReceiverCallback callback;
+    void* context;
+};
+
+static void tpms_view_receiver_publish(TPMSReceiver* tpms_receiver) {
+    const TPMSReceiverModel* model = &tpms_receiver->model;
+    TPMSReceiverSnapshot* snapshot = tpms_snapshot_back(tpms_receiver->snapshot);
+    // Same clock as the history last_seen
+    uint32_t now = furi_get_tick() / furi_kernel_get_tick_frequency();
+
+    for(size_t i = 0; i < MIN(model->history_item, MENU_ITEMS); ++i) {
+        size_t pos = CLAMP((uint16_t)(i + model->list_offset), model->history_item - 1, 0);
+        TPMSReceiverMenuItem* item_menu =
+            TPMSReceiverMenuItemArray_get(model->history->data, model->order[pos]);
+        strlcpy(snapshot->label[i], furi_string_get_cstr(item_menu->item_str), LABEL_LEN);
+        snapshot->state[i] = item_menu->state;
+        snprintf(
+            snapshot->reading[i],
+            sizeof(snapshot->reading[i]),
+            "%.1f %.0fC",
+            (double)item_menu->pressure,
+            (double)item_menu->temperature);
+        uint32_t age = now - item_menu->last_seen;
+        if(age < 60) {
+            snprintf(snapshot->age[i], sizeof(snapshot->age[i]), "%lus", age);
+        } else if(age < 60 * 60) {
+            snprintf(snapshot->age[i], sizeof(snapshot->age[i]), "%lum", age / 60);
+        } else {
+            snprintf(snapshot->age[i], sizeof(snapshot->age[i]), "%luh", MIN(age / 3600, 99UL));
+        }
+    }
+    strlcpy(
+        snapshot->frequency_str,
+        furi_string_get_cstr(model->frequency_str),
+        sizeof(snapshot->frequency_str));
+    strlcpy(
+        snapshot->preset_str,
+        furi_string_get_cstr(model->preset_str),
+        sizeof(snapshot->preset_str));
+    strlcpy(
+        snapshot->history_stat_str,
+        furi_string_get_cstr(model->history_stat_str),
+        sizeof(snapshot->history_stat_str));
+    strlcpy(snapshot->sort_name, model->sort_name, sizeof(snapshot->sort_name));
+    snapshot->idx = model->idx;
+    snapshot->list_offset = model->list_offset;
+    snapshot->history_item = model->history_item;
+    snapshot->bar_show = model->bar_show;
+    snapshot->u_rssi = model->u_rssi;
+    snapshot->external_radio = model->external_radio;
+
+    tpms_snapshot_publish(tpms_receiver->snapshot);
+}
+
+static void tpms_view_receiver_commit(TPMSReceiver* tpms_receiver, bool update) {
+    if(update) tpms_view_receiver_publish(tpms_receiver);
+    furi_mutex_release(tpms_receiver->mutex);
+    // Lock free view model, this only asks the GUI for a redraw
+    view_get_model(tpms_receiver->view);
+    view_commit_model(tpms_receiver->view, update);
+}
+
+// Like with_view_model, on the writer side model under the writer mutex
+#define with_receiver_model(tpms_receiver, code, update)                   \
+    {                                                                      \
+        furi_mutex_acquire((tpms_receiver)->mutex, FuriWaitForever);       \
+        {                                                                  \
+            TPMSReceiverModel* model = &(tpms_receiver)->model;            \
+            code                                                           \
+        }                                                                  \
+        tpms_view_receiver_commit(tpms_receiver, update);                  \
+    }
+
 void tpms_view_receiver_set_rssi(TPMSReceiver* instance, float rssi) {
     furi_assert(instance);
-    with_view_model(
-        instance->view,
-        TPMSReceiverModel * model,
+    with_receiver_model(
+        instance,
         {
             if(rssi < SUBGHZ_RAW_THRESHOLD_MIN) {
                 model->u_rssi = 0;
@@ -88,16 +208,14 @@ void tpms_view_receiver_set_lock(TPMSReceiver* tpms_receiver, TPMSLock lock) {
     tpms_receiver->lock_count = 0;
     if(lock == TPMSLockOn) {
         tpms_receiver->lock = lock;
-        with_view_model(
-            tpms_receiver->view,
-            TPMSReceiverModel * model,
+        with_receiver_model(
+            tpms_receiver,
             { model->bar_show = TPMSReceiverBarShowLock; },
             true);
         furi_timer_start(tpms_receiver->lock_timer, furi_ms_to_ticks(1000));
     } else {
-        with_view_model(
-            tpms_receiver->view,
-            TPMSReceiverModel * model,
+        with_receiver_model(
+            tpms_receiver,
             { model->bar_show = TPMSReceiverBarShowDefault; },
             true);
     }
@@ -113,12 +231,18 @@ void tpms_view_receiver_set_callback(
     tpms_receiver->context = context;
 }
 
+// Move the cursor more than a row, clamped to the list, and scroll it to the middle row
+static void tpms_view_receiver_jump(TPMSReceiverModel* model, uint16_t idx) {
+    if(!model->history_item) return;
+    model->idx = MIN(idx, model->history_item - 1);
+    model->list_offset = model->idx > 2 ? model->idx - 2 : 0;
+}
+
 static void tpms_view_receiver_update_offset(TPMSReceiver* tpms_receiver) {
     furi_assert(tpms_receiver);
 
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+    with_receiver_model(
+        tpms_receiver,
         {
             size_t history_item = model->history_item;
             uint16_t bounds = history_item > 3 ? 2 : history_item;
@@ -135,28 +259,108 @@ static void tpms_view_receiver_update_offset(TPMSReceiver* tpms_receiver) {
         true);
 }
 
-void tpms_view_receiver_add_item_to_menu(
+void tpms_view_receiver_set_item(
     TPMSReceiver* tpms_receiver,
+    uint16_t idx,
     const char* name,
-    uint8_t type) {
+    uint8_t type,
+    float pressure,
+    float temperature,
+    uint32_t last_seen) {
     furi_assert(tpms_receiver);
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+    bool added = false;
+    bool redraw = false;
+    with_receiver_model(
+        tpms_receiver,
         {
-            TPMSReceiverMenuItem* item_menu =
-                TPMSReceiverMenuItemArray_push_raw(model->history->data);
-            item_menu->item_str = furi_string_alloc_set(name);
-            item_menu->type = type;
-            if((model->idx == model->history_item - 1)) {
-                model->history_item++;
-                model->idx++;
-            } else {
+            TPMSReceiverMenuItem* item_menu = NULL;
+            if(idx == model->history_item && idx < TPMS_HISTORY_MAX) {
+                // At the end until the next tpms_view_receiver_set_order
+                item_menu = TPMSReceiverMenuItemArray_push_raw(model->history->data);
+                item_menu->item_str = furi_string_alloc();
+                model->order[idx] = idx;
+                model->position[idx] = idx;
+                if(model->history_item && model->idx == model->history_item - 1) model->idx++;
                 model->history_item++;
+                added = true;
+            } else if(idx < model->history_item) {
+                item_menu = TPMSReceiverMenuItemArray_get(model->history->data, idx);
             }
+            if(item_menu) {
+                furi_string_set_str(item_menu->item_str, name);
+                item_menu->type = type;
+                item_menu->state = TPMSSensorStateFresh;
+                item_menu->pressure = pressure;
+                item_menu->temperature = temperature;
+                item_menu->last_seen = last_seen;
+                // Rows off screen wait for the next scroll
+                uint16_t pos = model->position[idx];
+                redraw = added || (pos >= model->list_offset &&
+                                   pos < model->list_offset + MENU_ITEMS);
+            }
+        },
+        redraw);
+    if(added) tpms_view_receiver_update_offset(tpms_receiver);
+}
+
+void tpms_view_receiver_set_order(
+    TPMSReceiver* tpms_receiver,
+    const uint16_t* order,
+    uint16_t size) {
+    furi_assert(tpms_receiver);
+    furi_assert(order);
+    bool changed = false;
+    with_receiver_model(
+        tpms_receiver,
+        {
+            // Rows not handed over yet keep their place at the end
+            if(size == model->history_item &&
+               memcmp(model->order, order, size * sizeof(uint16_t))) {
+                uint16_t selected = size ? model->order[model->idx] : 0;
+                memcpy(model->order, order, size * sizeof(uint16_t));
+                for(uint16_t pos = 0; pos < size; pos++) {
+                    model->position[order[pos]] = pos;
+                }
+                // The cursor stays on the same sensor
+                if(size) model->idx = model->position[selected];
+                changed = true;
+            }
+        },
+        changed);
+    if(changed) tpms_view_receiver_update_offset(tpms_receiver);
+}
+
+void tpms_view_receiver_show_sort(TPMSReceiver* tpms_receiver, const char* name) {
+    furi_assert(tpms_receiver);
+    with_receiver_model(
+        tpms_receiver,
+        {
+            strlcpy(model->sort_name, name, sizeof(model->sort_name));
+            model->bar_show = TPMSReceiverBarShowSort;
         },
         true);
-    tpms_view_receiver_update_offset(tpms_receiver);
+    furi_timer_start(tpms_receiver->sort_timer, furi_ms_to_ticks(1500));
+}
+
+void tpms_view_receiver_set_item_state(
+    TPMSReceiver* tpms_receiver,
+    uint16_t idx,
+    TPMSSensorState state) {
+    furi_assert(tpms_receiver);
+    bool redraw = false;
+    with_receiver_model(
+        tpms_receiver,
+        {
+            if(idx < model->history_item) {
+                TPMSReceiverMenuItem* item_menu =
+                    TPMSReceiverMenuItemArray_get(model->history->data, idx);
+                uint16_t pos = model->position[idx];
+                redraw = item_menu->state != state && pos >= model->list_offset &&
+                         pos < model->list_offset + MENU_ITEMS;
+                item_menu->state = state;
+            }
+        },
+        redraw);
 }
 
 void tpms_view_receiver_add_data_statusbar(
@@ -166,9 +370,8 @@ void tpms_view_receiver_add_data_statusbar(
     const char* history_stat_str,
     bool external) {
     furi_assert(tpms_receiver);
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+    with_receiver_model(
+        tpms_receiver,
         {
             furi_string_set_str(model->frequency_str, frequency_str);
             furi_string_set_str(model->preset_str, preset_str);
@@ -192,7 +395,7 @@ static void tpms_view_receiver_draw_frame(Canvas* canvas, uint16_t idx, bool scr
     canvas_draw_dot(canvas, scrollbar ? 121 : 126, (0 + idx * FRAME_HEIGHT) + 11);
 }
 
-static void tpms_view_rssi_draw(Canvas* canvas, TPMSReceiverModel* model) {
+static void tpms_view_rssi_draw(Canvas* canvas, const TPMSReceiverSnapshot* model) {
     for(uint8_t i = 1; i < model->u_rssi; i++) {
         if(i % 5) {
             canvas_draw_dot(canvas, 46 + i, 50);
@@ -202,7 +405,44 @@ static void tpms_view_rssi_draw(Canvas* canvas, TPMSReceiverModel* model) {
     }
 }
 
-void tpms_view_receiver_draw(Canvas* canvas, TPMSReceiverModel* model) {
+static const TPMSReceiverLabel* tpms_view_receiver_fit_label(
+    Canvas* canvas,
+    TPMSReceiverViewModel* view_model,
+    size_t row,
+    const char* source,
+    uint8_t max_px) {
+    TPMSReceiverLabel* label = &view_model->label[row];
+    if(label->max_px == max_px && !strcmp(label->source, source)) return label;
+
+    // After a scroll by one the label sits in a neighbouring row
+    for(size_t i = 0; i < MENU_ITEMS; i++) {
+        TPMSReceiverLabel* other = &view_model->label[i];
+        if(i != row && other->max_px == max_px && !strcmp(other->source, source)) {
+            *label = *other;
+            return label;
+        }
+    }
+
+    // Same as elements_string_fit_width, in place on the fixed buffer
+    strlcpy(label->source, source, sizeof(label->source));
+    strlcpy(label->fitted, source, sizeof(label->fitted));
+    label->max_px = max_px;
+    label->width = canvas_string_width(canvas, label->fitted);
+    if(label->width > max_px) {
+        uint16_t fit_px = max_px - canvas_string_width(canvas, "...");
+        size_t len = strlen(label->fitted);
+        do {
+            label->fitted[--len] = '\0';
+            label->width = canvas_string_width(canvas, label->fitted);
+        } while(len && label->width > fit_px);
+        strlcat(label->fitted, "...", sizeof(label->fitted));
+        label->width = canvas_string_width(canvas, label->fitted);
+    }
+    return label;
+}
+
+void tpms_view_receiver_draw(Canvas* canvas, TPMSReceiverViewModel* view_model) {
+    const TPMSReceiverSnapshot* model = tpms_snapshot_front(view_model->snapshot);
     canvas_clear(canvas);
     canvas_set_color(canvas, ColorBlack);
     canvas_set_font(canvas, FontSecondary);
@@ -210,29 +450,41 @@ void tpms_view_receiver_draw(Canvas* canvas, TPMSReceiverModel* model) {
     elements_button_left(canvas, "Config");
 
     bool scrollbar = model->history_item > 4;
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
-    TPMSReceiverMenuItem* item_menu;
+    // Age, then pressure and temperature, right aligned in fixed columns
+    uint8_t age_x = scrollbar ? 119 : 125;
+    uint8_t reading_x = age_x - AGE_WIDTH_PX;
 
     for(size_t i = 0; i < MIN(model->history_item, MENU_ITEMS); ++i) {
         size_t idx = CLAMP((uint16_t)(i + model->list_offset), model->history_item, 0);
-        item_menu = TPMSReceiverMenuItemArray_get(model->history->data, idx);
-        furi_string_set(str_buff, item_menu->item_str);
-        elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
+        const TPMSReceiverLabel* label = tpms_view_receiver_fit_label(
+            canvas, view_model, i, model->label[i], reading_x - READING_WIDTH_PX - 4);
         if(model->idx == idx) {
             tpms_view_receiver_draw_frame(canvas, i, scrollbar);
         } else {
             canvas_set_color(canvas, ColorBlack);
         }
         // canvas_draw_icon(canvas, 4, 2 + i * FRAME_HEIGHT, ReceiverItemIcons[item_menu->type]);
-        canvas_draw_str(canvas, 4, 9 + i * FRAME_HEIGHT, furi_string_get_cstr(str_buff));
-        furi_string_reset(str_buff);
+        canvas_draw_str(canvas, 4, 9 + i * FRAME_HEIGHT, label->fitted);
+        canvas_draw_str_aligned(
+            canvas, reading_x, 9 + i * FRAME_HEIGHT, AlignRight, AlignBottom, model->reading[i]);
+        canvas_draw_str_aligned(
+            canvas, age_x, 9 + i * FRAME_HEIGHT, AlignRight, AlignBottom, model->age[i]);
+        if(model->state[i] != TPMSSensorStateFresh) {
+            // Stale rows are underlined with dots, gone rows struck through
+            uint16_t width = label->width;
+            if(model->state[i] == TPMSSensorStateStale) {
+                for(uint16_t x = 4; x < 4 + width; x += 2) {
+                    canvas_draw_dot(canvas, x, 10 + i * FRAME_HEIGHT);
+                }
+            } else {
+                canvas_draw_line(
+                    canvas, 3, 5 + i * FRAME_HEIGHT, 4 + width, 5 + i * FRAME_HEIGHT);
+            }
+        }
     }
     if(scrollbar) {
         elements_scrollbar_pos(canvas, 128, 0, 49, model->idx, model->history_item);
     }
-    furi_string_free(str_buff);
 
     canvas_set_color(canvas, ColorBlack);
 
@@ -255,9 +507,9 @@ void tpms_view_receiver_draw(Canvas* canvas, TPMSReceiverModel* model) {
         canvas_draw_str(canvas, 74, 62, "Locked");
         break;
     case TPMSReceiverBarShowToUnlockPress:
-        canvas_draw_str(canvas, 44, 62, furi_string_get_cstr(model->frequency_str));
-        canvas_draw_str(canvas, 79, 62, furi_string_get_cstr(model->preset_str));
-        canvas_draw_str(canvas, 96, 62, furi_string_get_cstr(model->history_stat_str));
+        canvas_draw_str(canvas, 44, 62, model->frequency_str);
+        canvas_draw_str(canvas, 79, 62, model->preset_str);
+        canvas_draw_str(canvas, 96, 62, model->history_stat_str);
         canvas_set_font(canvas, FontSecondary);
         elements_bold_rounded_frame(canvas, 14, 8, 99, 48);
         elements_multiline_text(canvas, 65, 26, "To unlock\npress:");
@@ -271,10 +523,14 @@ void tpms_view_receiver_draw(Canvas* canvas, TPMSReceiverModel* model) {
         canvas_draw_icon(canvas, 64, 55, &I_Unlock_7x8);
         canvas_draw_str(canvas, 74, 62, "Unlocked");
         break;
+    case TPMSReceiverBarShowSort:
+        canvas_draw_str(canvas, 44, 62, "Sort:");
+        canvas_draw_str(canvas, 68, 62, model->sort_name);
+        break;
     default:
-        canvas_draw_str(canvas, 44, 62, furi_string_get_cstr(model->frequency_str));
-        canvas_draw_str(canvas, 79, 62, furi_string_get_cstr(model->preset_str));
-        canvas_draw_str(canvas, 96, 62, furi_string_get_cstr(model->history_stat_str));
+        canvas_draw_str(canvas, 44, 62, model->frequency_str);
+        canvas_draw_str(canvas, 79, 62, model->preset_str);
+        canvas_draw_str(canvas, 96, 62, model->history_stat_str);
         break;
     }
 }
@@ -282,9 +538,8 @@ void tpms_view_receiver_draw(Canvas* canvas, TPMSReceiverModel* model) {
 static void tpms_view_receiver_lock_timer_callback(void* context) {
     furi_assert(context);
     TPMSReceiver* tpms_receiver = context;
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+    with_receiver_model(
+        tpms_receiver,
         { model->bar_show = TPMSReceiverBarShowDefault; },
         true);
     if(tpms_receiver->lock_count < UNLOCK_CNT) {
@@ -296,6 +551,19 @@ static void tpms_view_receiver_lock_timer_callback(void* context) {
     tpms_receiver->lock_count = 0;
 }
 
+static void tpms_view_receiver_sort_timer_callback(void* context) {
+    furi_assert(context);
+    TPMSReceiver* tpms_receiver = context;
+    with_receiver_model(
+        tpms_receiver,
+        {
+            if(model->bar_show == TPMSReceiverBarShowSort) {
+                model->bar_show = TPMSReceiverBarShowDefault;
+            }
+        },
+        true);
+}
+
 static void tpms_relearn_stop(void* context) {
     furi_assert(context);
     TPMSReceiver* tpms_receiver = context;
@@ -325,9 +593,8 @@ bool tpms_view_receiver_input(InputEvent* event, void* context) {
     TPMSReceiver* tpms_receiver = context;
 
     if(tpms_receiver->lock == TPMSLockOn) {
-        with_view_model(
-            tpms_receiver->view,
-            TPMSReceiverModel * model,
+        with_receiver_model(
+            tpms_receiver,
             { model->bar_show = TPMSReceiverBarShowToUnlockPress; },
             true);
         if(tpms_receiver->lock_count == 0) {
@@ -338,9 +605,8 @@ bool tpms_view_receiver_input(InputEvent* event, void* context) {
         }
         if(tpms_receiver->lock_count >= UNLOCK_CNT) {
             tpms_receiver->callback(TPMSCustomEventViewReceiverUnlock, tpms_receiver->context);
-            with_view_model(
-                tpms_receiver->view,
-                TPMSReceiverModel * model,
+            with_receiver_model(
+                tpms_receiver,
                 { model->bar_show = TPMSReceiverBarShowUnlock; },
                 true);
             tpms_receiver->lock = TPMSLockOff;
@@ -352,34 +618,59 @@ bool tpms_view_receiver_input(InputEvent* event, void* context) {
 
     if(event->key == InputKeyBack && event->type == InputTypeShort) {
         tpms_receiver->callback(TPMSCustomEventViewReceiverBack, tpms_receiver->context);
-    } else if(
-        event->key == InputKeyUp &&
-        (event->type == InputTypeShort || event->type == InputTypeRepeat)) {
-        with_view_model(
-            tpms_receiver->view,
-            TPMSReceiverModel * model,
+    } else if(event->key == InputKeyBack && event->type == InputTypeLong) {
+        tpms_receiver->callback(TPMSCustomEventViewReceiverSearch, tpms_receiver->context);
+    } else if(event->key == InputKeyUp && event->type == InputTypeShort) {
+        with_receiver_model(
+            tpms_receiver,
             {
                 if(model->idx != 0) model->idx--;
             },
             true);
-    } else if(
-        event->key == InputKeyDown &&
-        (event->type == InputTypeShort || event->type == InputTypeRepeat)) {
-        with_view_model(
-            tpms_receiver->view,
-            TPMSReceiverModel * model,
+    } else if(event->key == InputKeyDown && event->type == InputTypeShort) {
+        with_receiver_model(
+            tpms_receiver,
             {
                 if(model->history_item && model->idx != model->history_item - 1) model->idx++;
             },
             true);
+    } else if(
+        event->key == InputKeyUp &&
+        (event->type == InputTypeLong || event->type == InputTypeRepeat)) {
+        // Held, a page per step
+        with_receiver_model(
+            tpms_receiver,
+            {
+                tpms_view_receiver_jump(
+                    model, model->idx > MENU_ITEMS ? model->idx - MENU_ITEMS : 0);
+            },
+            true);
+    } else if(
+        event->key == InputKeyDown &&
+        (event->type == InputTypeLong || event->type == InputTypeRepeat)) {
+        with_receiver_model(
+            tpms_receiver,
+            { tpms_view_receiver_jump(model, model->idx + MENU_ITEMS); },
+            true);
+    } else if(event->key == InputKeyLeft && event->type == InputTypeLong) {
+        with_receiver_model(
+            tpms_receiver,
+            { tpms_view_receiver_jump(model, 0); },
+            true);
+    } else if(event->key == InputKeyRight && event->type == InputTypeLong) {
+        with_receiver_model(
+            tpms_receiver,
+            { tpms_view_receiver_jump(model, UINT16_MAX); },
+            true);
     } else if(event->key == InputKeyLeft && event->type == InputTypeShort) {
         tpms_receiver->callback(TPMSCustomEventViewReceiverConfig, tpms_receiver->context);
     } else if(event->key == InputKeyRight && event->type == InputTypeShort) {
         tpms_relearn_start(tpms_receiver);
+    } else if(event->key == InputKeyOk && event->type == InputTypeLong) {
+        tpms_receiver->callback(TPMSCustomEventViewReceiverSort, tpms_receiver->context);
     } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
-        with_view_model(
-            tpms_receiver->view,
-            TPMSReceiverModel * model,
+        with_receiver_model(
+            tpms_receiver,
             {
                 if(model->history_item != 0) {
                     tpms_receiver->callback(TPMSCustomEventViewReceiverOK, tpms_receiver->context);
@@ -397,12 +688,10 @@ void tpms_view_receiver_enter(void* context) {
     furi_assert(context);
 }
 
-void tpms_view_receiver_exit(void* context) {
-    furi_assert(context);
-    TPMSReceiver* tpms_receiver = context;
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+void tpms_view_receiver_reset(TPMSReceiver* tpms_receiver) {
+    furi_assert(tpms_receiver);
+    with_receiver_model(
+        tpms_receiver,
         {
             furi_string_reset(model->frequency_str);
             furi_string_reset(model->preset_str);
@@ -417,8 +706,15 @@ void tpms_view_receiver_exit(void* context) {
                 model->list_offset = 0;
                 model->history_item = 0;
         },
-        false);
+        true);
+}
+
+void tpms_view_receiver_exit(void* context) {
+    furi_assert(context);
+    TPMSReceiver* tpms_receiver = context;
+    // Rows stay, the history only hands over the ones that change meanwhile
     furi_timer_stop(tpms_receiver->lock_timer);
+    furi_timer_stop(tpms_receiver->sort_timer);
     tpms_relearn_stop(tpms_receiver);
 }
 
@@ -430,7 +726,10 @@ TPMSReceiver* tpms_view_receiver_alloc() {
 
     tpms_receiver->lock = TPMSLockOff;
     tpms_receiver->lock_count = 0;
-    view_allocate_model(tpms_receiver->view, ViewModelTypeLocking, sizeof(TPMSReceiverModel));
+    tpms_receiver->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    tpms_receiver->snapshot = tpms_snapshot_alloc(sizeof(TPMSReceiverSnapshot));
+    view_allocate_model(
+        tpms_receiver->view, ViewModelTypeLockFree, sizeof(TPMSReceiverViewModel));
     view_set_context(tpms_receiver->view, tpms_receiver);
     view_set_draw_callback(tpms_receiver->view, (ViewDrawCallback)tpms_view_receiver_draw);
     view_set_input_callback(tpms_receiver->view, tpms_view_receiver_input);
@@ -439,7 +738,11 @@ TPMSReceiver* tpms_view_receiver_alloc() {
 
     with_view_model(
         tpms_receiver->view,
-        TPMSReceiverModel * model,
+        TPMSReceiverViewModel * view_model,
+        { view_model->snapshot = tpms_receiver->snapshot; },
+        false);
+    with_receiver_model(
+        tpms_receiver,
         {
             model->frequency_str = furi_string_alloc();
             model->preset_str = furi_string_alloc();
@@ -454,15 +757,16 @@ TPMSReceiver* tpms_view_receiver_alloc() {
         furi_timer_alloc(tpms_view_receiver_lock_timer_callback, FuriTimerTypeOnce, tpms_receiver);
     tpms_receiver->relearn_timer = furi_timer_alloc(
         tpms_view_receiver_relearn_timer_callback, FuriTimerTypeOnce, tpms_receiver);
+    tpms_receiver->sort_timer =
+        furi_timer_alloc(tpms_view_receiver_sort_timer_callback, FuriTimerTypeOnce, tpms_receiver);
     return tpms_receiver;
 }
 
 void tpms_view_receiver_free(TPMSReceiver* tpms_receiver) {
     furi_assert(tpms_receiver);
 
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+    with_receiver_model(
+        tpms_receiver,
         {
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
@@ -478,7 +782,10 @@ void tpms_view_receiver_free(TPMSReceiver* tpms_receiver) {
         false);
     furi_timer_free(tpms_receiver->lock_timer);
     furi_timer_free(tpms_receiver->relearn_timer);
+    furi_timer_free(tpms_receiver->sort_timer);
     view_free(tpms_receiver->view);
+    tpms_snapshot_free(tpms_receiver->snapshot);
+    furi_mutex_free(tpms_receiver->mutex);
     free(tpms_receiver);
 }
 
@@ -490,19 +797,21 @@ View* tpms_view_receiver_get_view(TPMSReceiver* tpms_receiver) {
 uint16_t tpms_view_receiver_get_idx_menu(TPMSReceiver* tpms_receiver) {
     furi_assert(tpms_receiver);
     uint32_t idx = 0;
-    with_view_model(
-        tpms_receiver->view, TPMSReceiverModel * model, { idx = model->idx; }, false);
+    with_receiver_model(
+        tpms_receiver,
+        {
+            if(model->history_item) idx = model->order[model->idx];
+        },
+        false);
     return idx;
 }
 
 void tpms_view_receiver_set_idx_menu(TPMSReceiver* tpms_receiver, uint16_t idx) {
     furi_assert(tpms_receiver);
-    with_view_model(
-        tpms_receiver->view,
-        TPMSReceiverModel * model,
+    with_receiver_model(
+        tpms_receiver,
         {
-            model->idx = idx;
-            if(model->idx > 2) model->list_offset = idx - 2;
+            if(idx < model->history_item) tpms_view_receiver_jump(model, model->position[idx]);
         },
         true);
     tpms_view_receiver_update_offset(tpms_receiver);
@@ -30,13 +30,31 @@ void tpms_view_receiver_add_data_statusbar(
     const char* history_stat_str,
     bool external);
 
-void tpms_view_receiver_add_item_to_menu(
+void tpms_view_receiver_set_item(
     TPMSReceiver* tpms_receiver,
+    uint16_t idx,
     const char* name,
-    uint8_t type);
+    uint8_t type,
+    float pressure,
+    float temperature,
+    uint32_t last_seen);
+
+void tpms_view_receiver_set_order(
+    TPMSReceiver* tpms_receiver,
+    const uint16_t* order,
+    uint16_t size);
+
+void tpms_view_receiver_show_sort(TPMSReceiver* tpms_receiver, const char* name);
+
+void tpms_view_receiver_set_item_state(
+    TPMSReceiver* tpms_receiver,
+    uint16_t idx,
+    TPMSSensorState state);
 
 uint16_t tpms_view_receiver_get_idx_menu(TPMSReceiver* tpms_receiver);
 
 void tpms_view_receiver_set_idx_menu(TPMSReceiver* tpms_receiver, uint16_t idx);
 
+void tpms_view_receiver_reset(TPMSReceiver* tpms_receiver);
+
 void tpms_view_receiver_exit(void* context);
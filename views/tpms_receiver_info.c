@@ -1,139 +1,289 @@
 #include "tpms_receiver.h"
 #include "../tpms_app_i.h"
+#include "../helpers/tpms_snapshot.h"
 #include "tpms_icons.h"
 #include "../protocols/tpms_generic.h"
 #include <input/input.h>
 #include <gui/elements.h>
 #include <float_tools.h>
 
+#define PROTOCOL_NAME_LEN 32
+
+typedef struct {
+    uint32_t curr_ts;
+    uint32_t sightings;
+    bool leak_alert;
+    float leak_rate; // bar per hour
+    uint8_t alerts; // TPMS_ALERT_MASK of active alerts
+    char protocol_name[PROTOCOL_NAME_LEN];
+    TPMSBlockGeneric generic;
+} TPMSReceiverInfoModel;
+
+// What the draw callback reads, formatted once per update instead of on every frame
+typedef struct {
+    char title[PROTOCOL_NAME_LEN + 8];
+    char seen[16];
+    char id[16];
+    char battery[12];
+    char status[16];
+    char rx[24];
+    char temperature[8];
+    uint8_t temp_x1;
+    uint8_t temp_x2;
+    char pressure[12];
+    bool age_shown;
+    char age[8];
+    uint8_t age_x;
+    Align age_align;
+} TPMSReceiverInfoSnapshot;
+
+typedef struct {
+    TPMSSnapshot* snapshot;
+} TPMSReceiverInfoViewModel;
+
 struct TPMSReceiverInfo {
     View* view;
     FuriTimer* timer;
+    // Writers (worker, timer, scene) serialize on mutex, the draw callback never takes it
+    FuriMutex* mutex;
+    TPMSReceiverInfoModel model;
+    TPMSSnapshot* snapshot;
+    FuriString* protocol_name;
 };
 
-typedef struct {
-    uint32_t curr_ts;
-    FuriString* protocol_name;
-    TPMSBlockGeneric* generic;
-} TPMSReceiverInfoModel;
+static void tpms_view_receiver_info_format(
+    const TPMSReceiverInfoModel* model,
+    TPMSReceiverInfoSnapshot* snapshot);
+
+static void tpms_view_receiver_info_commit(TPMSReceiverInfo* tpms_receiver_info, bool update) {
+    if(update) {
+        tpms_view_receiver_info_format(
+            &tpms_receiver_info->model, tpms_snapshot_back(tpms_receiver_info->snapshot));
+        tpms_snapshot_publish(tpms_receiver_info->snapshot);
+    }
+    furi_mutex_release(tpms_receiver_info->mutex);
+    // Lock free view model, this only asks the GUI for a redraw
+    view_get_model(tpms_receiver_info->view);
+    view_commit_model(tpms_receiver_info->view, update);
+}
+
+// Like with_view_model, on the writer side model under the writer mutex
+#define with_info_model(tpms_receiver_info, code, update)                  \
+    {                                                                      \
+        furi_mutex_acquire((tpms_receiver_info)->mutex, FuriWaitForever);  \
+        {                                                                  \
+            TPMSReceiverInfoModel* model = &(tpms_receiver_info)->model;   \
+            code                                                           \
+        }                                                                  \
+        tpms_view_receiver_info_commit(tpms_receiver_info, update);        \
+    }
 
 void tpms_view_receiver_info_update(TPMSReceiverInfo* tpms_receiver_info, FlipperFormat* fff) {
     furi_assert(tpms_receiver_info);
     furi_assert(fff);
 
-    with_view_model(
-        tpms_receiver_info->view,
-        TPMSReceiverInfoModel * model,
+    with_info_model(
+        tpms_receiver_info,
         {
             flipper_format_rewind(fff);
-            flipper_format_read_string(fff, "Protocol", model->protocol_name);
+            flipper_format_read_string(fff, "Protocol", tpms_receiver_info->protocol_name);
+            strlcpy(
+                model->protocol_name,
+                furi_string_get_cstr(tpms_receiver_info->protocol_name),
+                PROTOCOL_NAME_LEN);
+
+            tpms_block_generic_deserialize(&model->generic, fff);
+            // Same clock the reading was timed on, so the age does not drift from it
+            model->curr_ts = tpms_clock_get_timestamp(NULL);
+        },
+        true);
+}
 
-            tpms_block_generic_deserialize(model->generic, fff);
+void tpms_view_receiver_info_set_sightings(TPMSReceiverInfo* tpms_receiver_info, uint32_t count) {
+    furi_assert(tpms_receiver_info);
 
-            DateTime curr_dt;
-            furi_hal_rtc_get_datetime(&curr_dt);
-            model->curr_ts = datetime_datetime_to_timestamp(&curr_dt);
+    with_info_model(
+        tpms_receiver_info,
+        { model->sightings = count; },
+        true);
+}
+
+void tpms_view_receiver_info_set_leak(
+    TPMSReceiverInfo* tpms_receiver_info,
+    float rate,
+    bool alert) {
+    furi_assert(tpms_receiver_info);
+
+    with_info_model(
+        tpms_receiver_info,
+        {
+            model->leak_rate = rate;
+            model->leak_alert = alert;
         },
         true);
 }
 
-void tpms_view_receiver_info_draw(Canvas* canvas, TPMSReceiverInfoModel* model) {
-    char buffer[64];
-    canvas_clear(canvas);
-    canvas_set_color(canvas, ColorBlack);
-    canvas_set_font(canvas, FontSecondary);
+void tpms_view_receiver_info_set_alerts(TPMSReceiverInfo* tpms_receiver_info, uint8_t alerts) {
+    furi_assert(tpms_receiver_info);
+
+    with_info_model(
+        tpms_receiver_info,
+        { model->alerts = alerts; },
+        true);
+}
+
+static void tpms_view_receiver_info_format(
+    const TPMSReceiverInfoModel* model,
+    TPMSReceiverInfoSnapshot* snapshot) {
+    const TPMSBlockGeneric* generic = &model->generic;
 
     snprintf(
-        buffer,
-        sizeof(buffer),
+        snapshot->title,
+        sizeof(snapshot->title),
         "%s %db",
-        furi_string_get_cstr(model->protocol_name),
-        model->generic->data_count_bit);
-    canvas_draw_str(canvas, 0, 8, buffer);
+        model->protocol_name,
+        generic->data_count_bit);
+
+    // Frames of this sensor seen so far, across sessions
+    snapshot->seen[0] = '\0';
+    if(model->sightings) {
+        snprintf(snapshot->seen, sizeof(snapshot->seen), "Seen %lu", model->sightings);
+    }
 
-    snprintf(buffer, sizeof(buffer), "ID: 0x%lX", model->generic->id);
-    canvas_draw_str(canvas, 0, 20, buffer);
+    snprintf(snapshot->id, sizeof(snapshot->id), "ID: 0x%lX", generic->id);
 
-    if(model->generic->battery_low != TPMS_NO_BATT) {
+    snapshot->battery[0] = '\0';
+    if(generic->battery_low != TPMS_NO_BATT) {
         snprintf(
-            buffer, sizeof(buffer), "Batt: %s", (!model->generic->battery_low ? "ok" : "low"));
-        canvas_draw_str_aligned(canvas, 126, 17, AlignRight, AlignCenter, buffer);
+            snapshot->battery,
+            sizeof(snapshot->battery),
+            "Batt: %s",
+            (!generic->battery_low ? "ok" : "low"));
     }
 
-    // snprintf(buffer, sizeof(buffer), "Data: 0x%llX", model->generic->data);
-    // canvas_draw_str(canvas, 0, 32, buffer);
-
-    elements_bold_rounded_frame(canvas, 0, 38, 127, 25);
-    canvas_set_font(canvas, FontPrimary);
+    snapshot->status[0] = '\0';
+    if(generic->alarm) {
+        strlcpy(snapshot->status, "ALARM", sizeof(snapshot->status));
+    } else if(model->alerts) {
+        strlcpy(
+            snapshot->status,
+            tpms_alert_get_name(__builtin_ctz(model->alerts)),
+            sizeof(snapshot->status));
+    } else if(model->leak_alert) {
+        // Temperature compensated pressure loss, fitted over the readings so far
+        snprintf(
+            snapshot->status, sizeof(snapshot->status), "LEAK %.2fb/h", (double)model->leak_rate);
+    } else if(generic->mode != TPMSModeUnknown && generic->mode <= TPMSModeRelearn) {
+        const char* mode_text[] = {"", "Parked", "Driving", "Relearn"};
+        strlcpy(snapshot->status, mode_text[generic->mode], sizeof(snapshot->status));
+    }
 
-    // Temperature
-    canvas_draw_icon(canvas, 6, 43, &I_Therm_7x16);
+    // Frames with valid CRC out of all frames caught in the burst
+    snapshot->rx[0] = '\0';
+    if(generic->repeat_count) {
+        snprintf(
+            snapshot->rx,
+            sizeof(snapshot->rx),
+            "Rx: %d/%d  %.0fdBm",
+            __builtin_popcount(generic->crc_ok_mask),
+            generic->repeat_count,
+            (double)generic->rssi);
+    }
 
-    uint8_t temp_x1 = 0;
-    uint8_t temp_x2 = 0;
     if(furi_hal_rtc_get_locale_units() == FuriHalRtcLocaleUnitsMetric) {
-        snprintf(buffer, sizeof(buffer), "%2.0f C", (double)model->generic->temperature);
-        if(model->generic->temperature < -9.0f) {
-            temp_x1 = 42;
-            temp_x2 = 33;
+        snprintf(
+            snapshot->temperature,
+            sizeof(snapshot->temperature),
+            "%2.0f C",
+            (double)generic->temperature);
+        if(generic->temperature < -9.0f) {
+            snapshot->temp_x1 = 42;
+            snapshot->temp_x2 = 33;
         } else {
-            temp_x1 = 40;
-            temp_x2 = 30;
+            snapshot->temp_x1 = 40;
+            snapshot->temp_x2 = 30;
         }
     } else {
         snprintf(
-            buffer,
-            sizeof(buffer),
+            snapshot->temperature,
+            sizeof(snapshot->temperature),
             "%3.0f F",
-            (double)locale_celsius_to_fahrenheit(model->generic->temperature));
-        if((model->generic->temperature < -27.77f) || (model->generic->temperature > 37.77f)) {
-            temp_x1 = 43;
-            temp_x2 = 35;
+            (double)locale_celsius_to_fahrenheit(generic->temperature));
+        if((generic->temperature < -27.77f) || (generic->temperature > 37.77f)) {
+            snapshot->temp_x1 = 43;
+            snapshot->temp_x2 = 35;
         } else {
-            temp_x1 = 41;
-            temp_x2 = 33;
+            snapshot->temp_x1 = 41;
+            snapshot->temp_x2 = 33;
         }
     }
 
-    canvas_draw_str_aligned(canvas, temp_x1, 47, AlignRight, AlignTop, buffer);
-    canvas_draw_circle(canvas, temp_x2, 46, 1);
-
-    // Pressure
-    canvas_draw_icon(canvas, 46, 43, &I_Press_7x16);
-    snprintf(buffer, sizeof(buffer), "%2.1fbar", (double)model->generic->pressure);
-    canvas_draw_str(canvas, 56, 55, buffer);
+    snprintf(
+        snapshot->pressure, sizeof(snapshot->pressure), "%2.1fbar", (double)generic->pressure);
 
-    if((int)model->generic->timestamp > 0 && model->curr_ts) {
-        int ts_diff = (int)model->curr_ts - (int)model->generic->timestamp;
-
-        canvas_draw_icon(canvas, 92, 46, &I_Timer_11x11);
+    snapshot->age_shown = (int)generic->timestamp > 0 && model->curr_ts;
+    if(snapshot->age_shown) {
+        int ts_diff = (int)model->curr_ts - (int)generic->timestamp;
 
         if(ts_diff > 60) {
-            int tmp_sec = ts_diff;
-            int cnt_min = 1;
-            for(int i = 1; tmp_sec > 60; i++) {
-                tmp_sec = tmp_sec - 60;
-                cnt_min = i;
-            }
+            int cnt_min = (ts_diff - 1) / 60;
 
-            if(model->curr_ts % 2 == 0) {
-                canvas_draw_str_aligned(canvas, 106, 51, AlignLeft, AlignCenter, "Old");
+            // Blinks between the age and "Old" every second, "Old" alone past an hour
+            if(model->curr_ts % 2 == 0 || cnt_min >= 59) {
+                strlcpy(snapshot->age, "Old", sizeof(snapshot->age));
+                snapshot->age_x = 106;
+                snapshot->age_align = AlignLeft;
             } else {
-                if(cnt_min >= 59) {
-                    canvas_draw_str_aligned(canvas, 106, 51, AlignLeft, AlignCenter, "Old");
-                } else {
-                    snprintf(buffer, sizeof(buffer), "%dm", cnt_min);
-                    canvas_draw_str_aligned(canvas, 115, 51, AlignCenter, AlignCenter, buffer);
-                }
+                snprintf(snapshot->age, sizeof(snapshot->age), "%dm", cnt_min);
+                snapshot->age_x = 115;
+                snapshot->age_align = AlignCenter;
             }
-
         } else {
-            snprintf(buffer, sizeof(buffer), "%d", ts_diff);
-            canvas_draw_str_aligned(canvas, 112, 51, AlignCenter, AlignCenter, buffer);
+            snprintf(snapshot->age, sizeof(snapshot->age), "%d", ts_diff);
+            snapshot->age_x = 112;
+            snapshot->age_align = AlignCenter;
         }
     }
 }
 
+void tpms_view_receiver_info_draw(Canvas* canvas, TPMSReceiverInfoViewModel* view_model) {
+    const TPMSReceiverInfoSnapshot* model = tpms_snapshot_front(view_model->snapshot);
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+
+    canvas_draw_str(canvas, 0, 8, model->title);
+    if(model->seen[0]) {
+        canvas_draw_str_aligned(canvas, 126, 5, AlignRight, AlignCenter, model->seen);
+    }
+    canvas_draw_str(canvas, 0, 20, model->id);
+    if(model->battery[0]) {
+        canvas_draw_str_aligned(canvas, 126, 17, AlignRight, AlignCenter, model->battery);
+    }
+    if(model->status[0]) {
+        canvas_draw_str_aligned(canvas, 126, 29, AlignRight, AlignCenter, model->status);
+    }
+    if(model->rx[0]) canvas_draw_str(canvas, 0, 32, model->rx);
+
+    elements_bold_rounded_frame(canvas, 0, 38, 127, 25);
+    canvas_set_font(canvas, FontPrimary);
+
+    // Temperature
+    canvas_draw_icon(canvas, 6, 43, &I_Therm_7x16);
+    canvas_draw_str_aligned(canvas, model->temp_x1, 47, AlignRight, AlignTop, model->temperature);
+    canvas_draw_circle(canvas, model->temp_x2, 46, 1);
+
+    // Pressure
+    canvas_draw_icon(canvas, 46, 43, &I_Press_7x16);
+    canvas_draw_str(canvas, 56, 55, model->pressure);
+
+    if(model->age_shown) {
+        canvas_draw_icon(canvas, 92, 46, &I_Timer_11x11);
+        canvas_draw_str_aligned(
+            canvas, model->age_x, 51, model->age_align, AlignCenter, model->age);
+    }
+}
+
 bool tpms_view_receiver_info_input(InputEvent* event, void* context) {
     furi_assert(context);
     //TPMSReceiverInfo* tpms_receiver_info = context;
@@ -158,24 +308,18 @@ static void tpms_view_receiver_info_exit(void* context) {
 
     furi_timer_stop(tpms_receiver_info->timer);
 
-    with_view_model(
-        tpms_receiver_info->view,
-        TPMSReceiverInfoModel * model,
-        { furi_string_reset(model->protocol_name); },
-        false);
+    with_info_model(
+        tpms_receiver_info,
+        { model->protocol_name[0] = '\0'; },
+        true);
 }
 
 static void tpms_view_receiver_info_timer(void* context) {
     TPMSReceiverInfo* tpms_receiver_info = context;
     // Force redraw
-    with_view_model(
-        tpms_receiver_info->view,
-        TPMSReceiverInfoModel * model,
-        {
-            DateTime curr_dt;
-            furi_hal_rtc_get_datetime(&curr_dt);
-            model->curr_ts = datetime_datetime_to_timestamp(&curr_dt);
-        },
+    with_info_model(
+        tpms_receiver_info,
+        { model->curr_ts = tpms_clock_get_timestamp(NULL); },
         true);
 }
 
@@ -185,8 +329,12 @@ TPMSReceiverInfo* tpms_view_receiver_info_alloc() {
     // View allocation and configuration
     tpms_receiver_info->view = view_alloc();
 
+    tpms_receiver_info->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    tpms_receiver_info->snapshot = tpms_snapshot_alloc(sizeof(TPMSReceiverInfoSnapshot));
+    tpms_receiver_info->protocol_name = furi_string_alloc();
+    memset(&tpms_receiver_info->model, 0, sizeof(TPMSReceiverInfoModel));
     view_allocate_model(
-        tpms_receiver_info->view, ViewModelTypeLocking, sizeof(TPMSReceiverInfoModel));
+        tpms_receiver_info->view, ViewModelTypeLockFree, sizeof(TPMSReceiverInfoViewModel));
     view_set_context(tpms_receiver_info->view, tpms_receiver_info);
     view_set_draw_callback(
         tpms_receiver_info->view, (ViewDrawCallback)tpms_view_receiver_info_draw);
@@ -196,12 +344,9 @@ TPMSReceiverInfo* tpms_view_receiver_info_alloc() {
 
     with_view_model(
         tpms_receiver_info->view,
-        TPMSReceiverInfoModel * model,
-        {
-            model->generic = malloc(sizeof(TPMSBlockGeneric));
-            model->protocol_name = furi_string_alloc();
-        },
-        true);
+        TPMSReceiverInfoViewModel * view_model,
+        { view_model->snapshot = tpms_receiver_info->snapshot; },
+        false);
 
     tpms_receiver_info->timer =
         furi_timer_alloc(tpms_view_receiver_info_timer, FuriTimerTypePeriodic, tpms_receiver_info);
@@ -214,16 +359,10 @@ void tpms_view_receiver_info_free(TPMSReceiverInfo* tpms_receiver_info) {
 
     furi_timer_free(tpms_receiver_info->timer);
 
-    with_view_model(
-        tpms_receiver_info->view,
-        TPMSReceiverInfoModel * model,
-        {
-            furi_string_free(model->protocol_name);
-            free(model->generic);
-        },
-        false);
-
     view_free(tpms_receiver_info->view);
+    tpms_snapshot_free(tpms_receiver_info->snapshot);
+    furi_mutex_free(tpms_receiver_info->mutex);
+    furi_string_free(tpms_receiver_info->protocol_name);
     free(tpms_receiver_info);
 }
 
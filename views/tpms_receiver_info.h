@@ -9,6 +9,15 @@ typedef struct TPMSReceiverInfo TPMSReceiverInfo;
 
 void tpms_view_receiver_info_update(TPMSReceiverInfo* tpms_receiver_info, FlipperFormat* fff);
 
+void tpms_view_receiver_info_set_sightings(TPMSReceiverInfo* tpms_receiver_info, uint32_t count);
+
+void tpms_view_receiver_info_set_leak(
+    TPMSReceiverInfo* tpms_receiver_info,
+    float rate,
+    bool alert);
+
+void tpms_view_receiver_info_set_alerts(TPMSReceiverInfo* tpms_receiver_info, uint8_t alerts);
+
 TPMSReceiverInfo* tpms_view_receiver_info_alloc();
 
 void tpms_view_receiver_info_free(TPMSReceiverInfo* tpms_receiver_info);